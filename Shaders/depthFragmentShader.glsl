@@ -0,0 +1,10 @@
+///////////////////////////////////////////////////////////////////////////////
+// depthFragmentShader.glsl
+// ============
+// write only the depth of the visible surfaces for the depth pre-pass
+///////////////////////////////////////////////////////////////////////////////
+#version 440 core
+
+void main()
+{
+}
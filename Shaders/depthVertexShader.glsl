@@ -0,0 +1,60 @@
+///////////////////////////////////////////////////////////////////////////////
+// depthVertexShader.glsl
+// ============
+// transform the mesh vertices for the depth pre-pass
+///////////////////////////////////////////////////////////////////////////////
+#version 440 core
+
+layout (location = 0) in vec3 inVertexPosition;
+
+// per-instance model matrix, must match the locations in InstancedMeshes.cpp
+layout (location = 3) in mat4 instanceModel;
+
+// the main pass tests for equal depth, so the position must be
+// computed exactly as in vertexShader.glsl, see CalcWorldPosition
+invariant gl_Position;
+
+// the camera values of the frame, see vertexShader.glsl
+layout (std140, binding = 0) uniform CameraBlock
+{
+	mat4 view;
+	mat4 projection;
+	mat4 viewProjection;
+	mat4 inverseView;
+	mat4 inverseProjection;
+	mat4 inverseViewProjection;
+	vec3 cameraPosition;
+	float time;
+	vec2 viewportSize;
+};
+
+// the pre-pass only draws the instanced commands, but the model
+// matrix is picked the same way as in vertexShader.glsl
+uniform mat4 model;
+uniform bool bUseInstancing = true;
+
+// box the stored positions are quantized in, see MeshArena.h
+uniform vec3 positionScale = vec3(1.0f);
+uniform vec3 positionOffset = vec3(0.0f);
+
+// get the world position of the vertex - this function and the
+// uniforms it reads are the same in vertexShader.glsl and
+// depthVertexShader.glsl, so the invariant gl_Position of the two
+// programs comes from the same expressions and flow control
+vec3 CalcWorldPosition()
+{
+	mat4 objectModel = model;
+	if (bUseInstancing == true)
+	{
+		objectModel = instanceModel;
+	}
+
+	vec3 position = inVertexPosition * positionScale + positionOffset;
+	return(vec3(objectModel * vec4(position, 1.0f)));
+}
+
+void main()
+{
+	vec3 fragmentPosition = CalcWorldPosition();
+	gl_Position = viewProjection * vec4(fragmentPosition, 1.0f);
+}
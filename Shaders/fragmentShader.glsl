@@ -0,0 +1,275 @@
+///////////////////////////////////////////////////////////////////////////////
+// fragmentShader.glsl
+// ============
+// Phong lighting with textures and materials from the MaterialBlock
+///////////////////////////////////////////////////////////////////////////////
+#version 440 core
+
+// must match MAX_SCENE_MATERIALS in ShaderBindings.h
+#define MAX_SCENE_MATERIALS 64
+// lights with a shadow map, must match SHADOW_CUBE_LIGHT and
+// SHADOW_MAP_LIGHT in ShaderBindings.h - the SHADOW_MAP_LIGHT is a
+// directional light, its position being the direction toward it
+#define SHADOW_CUBE_LIGHT 0u
+#define SHADOW_MAP_LIGHT 1u
+// distance the shadow lookups are moved along the normal, and the
+// depth bias of the comparisons
+#define SHADOW_NORMAL_OFFSET 0.02f
+#define SHADOW_MAP_BIAS 0.001f
+#define SHADOW_CUBE_BIAS 0.002f
+// fragments shaded at one pixel drawn in full red
+#define OVERDRAW_RED_COUNT 4.0f
+
+// the depth test runs before the shader, so the overdraw counters
+// only count fragments that are shaded - the shader never discards
+// or writes depth, so the result is the same as a late test
+layout (early_fragment_tests) in;
+
+in vec3 fragmentPosition;
+in vec3 fragmentVertexNormal;
+in vec2 fragmentTextureCoordinate;
+in vec4 fragmentColor;
+flat in int fragmentMaterialIndex;
+flat in int fragmentTextureLayer;
+
+out vec4 outFragmentColor;
+
+struct Material
+{
+	vec3 ambientColor;
+	float ambientStrength;
+	vec3 diffuseColor;
+	float shininess;
+	vec3 specularColor;
+};
+
+// the camera values of the frame, shared by every shader program -
+// the layout must match GPU_CAMERA in CameraBuffer.h and the binding
+// CAMERA_BLOCK_BINDING in ShaderBindings.h
+layout (std140, binding = 0) uniform CameraBlock
+{
+	mat4 view;
+	mat4 projection;
+	mat4 viewProjection;
+	mat4 inverseView;
+	mat4 inverseProjection;
+	mat4 inverseViewProjection;
+	vec3 cameraPosition;
+	float time;
+	vec2 viewportSize;
+};
+
+// all the scene materials, uploaded once - the binding must
+// match MATERIAL_BLOCK_BINDING in ShaderBindings.h
+layout (std140, binding = 1) uniform MaterialBlock
+{
+	Material materials[MAX_SCENE_MATERIALS];
+};
+
+// one scene light, must match GPU_LIGHT in LightManager.h - a
+// radius of 0 marks a light that reaches everywhere without fading
+struct Light
+{
+	vec3 position;
+	float radius;
+	vec3 ambientColor;
+	float focalStrength;
+	vec3 diffuseColor;
+	float specularIntensity;
+	vec3 specularColor;
+	float padding;
+};
+
+// all the scene lights, the ones without a radius first - the
+// bindings of the three blocks below must match ShaderBindings.h
+layout (std430, binding = 2) readonly buffer LightBlock
+{
+	// number of lights without a radius, then all the lights
+	uvec4 lightCounts;
+	Light lights[];
+};
+
+// grid size and depth slicing of the clusters, then the offset and
+// count of each cluster's list in clusterLightIndices
+layout (std430, binding = 3) readonly buffer ClusterBlock
+{
+	uvec4 clusterGridSize;
+	vec4 clusterDepthSlicing;
+	uvec2 clusterRanges[];
+};
+
+layout (std430, binding = 4) readonly buffer ClusterIndexBlock
+{
+	uint clusterLightIndices[];
+};
+
+uniform bool bUseTexture = false;
+uniform bool bUseLighting = false;
+// the scene textures are layers of texture arrays, grouped by size
+uniform sampler2DArray objectTextures;
+// true when the point lights of the fragment's cluster are added
+uniform bool bClusteredLights = false;
+// shadow maps of the first two lights, see ShadowMaps.h
+uniform bool bShadows = false;
+uniform sampler2DShadow shadowMap;
+uniform samplerCubeShadow shadowCubeMap;
+// world to light clip space of shadowMap
+uniform mat4 shadowMatrix;
+// light distance stored as depth 1 in shadowCubeMap
+uniform float shadowCubeFar = 1.0f;
+
+// true to draw the number of fragments shaded at each pixel instead
+// of the lit color, see OVERDRAW_COUNTER_BINDING and
+// OVERDRAW_IMAGE_UNIT in ShaderBindings.h
+uniform bool bOverdraw = false;
+layout (binding = 0, offset = 0) uniform atomic_uint shadedFragments;
+layout (binding = 0, offset = 4) uniform atomic_uint coveredPixels;
+layout (r32ui, binding = 0) uniform coherent uimage2D overdrawCounts;
+
+vec3 CalcLightSource(Light light, Material material, vec3 lightNormal, vec3 lightDirection, vec3 viewDirection, float lit);
+float CalcShadow(uint lightIndex, vec3 lightNormal, vec3 vertexPosition);
+vec3 CalcPointLight(Light light, Material material, vec3 lightNormal, vec3 vertexPosition, vec3 viewDirection);
+uint FindCluster(vec3 vertexPosition);
+vec4 CalcOverdraw();
+
+void main()
+{
+	if (bOverdraw == true)
+	{
+		outFragmentColor = CalcOverdraw();
+		return;
+	}
+
+	vec4 baseColor = fragmentColor;
+	if (bUseTexture == true)
+	{
+		baseColor = texture(objectTextures, vec3(fragmentTextureCoordinate, fragmentTextureLayer));
+	}
+
+	if (bUseLighting == true)
+	{
+		Material material = materials[fragmentMaterialIndex];
+
+		vec3 lightNormal = normalize(fragmentVertexNormal);
+		vec3 viewDirection = normalize(cameraPosition - fragmentPosition);
+		vec3 phongResult = vec3(0.0f);
+
+		// the lights without a radius reach every fragment
+		for (uint i = 0u; i < lightCounts.x; i++)
+		{
+			float lit = 1.0f;
+			if (bShadows == true)
+			{
+				lit = CalcShadow(i, lightNormal, fragmentPosition);
+			}
+			vec3 lightDirection = (i == SHADOW_MAP_LIGHT) ?
+				normalize(lights[i].position) :
+				normalize(lights[i].position - fragmentPosition);
+			phongResult += CalcLightSource(lights[i], material, lightNormal, lightDirection, viewDirection, lit);
+		}
+
+		// only the point lights listed for this cluster can reach
+		// the fragment
+		if (bClusteredLights == true)
+		{
+			uvec2 range = clusterRanges[FindCluster(fragmentPosition)];
+			for (uint i = 0u; i < range.y; i++)
+			{
+				phongResult += CalcPointLight(lights[clusterLightIndices[range.x + i]], material, lightNormal, fragmentPosition, viewDirection);
+			}
+		}
+
+		outFragmentColor = vec4(phongResult * baseColor.xyz, baseColor.w);
+	}
+	else
+	{
+		outFragmentColor = baseColor;
+	}
+}
+
+vec3 CalcLightSource(Light light, Material material, vec3 lightNormal, vec3 lightDirection, vec3 viewDirection, float lit)
+{
+	vec3 ambient;
+	vec3 diffuse;
+	vec3 specular;
+
+	// ambient lighting
+	ambient = light.ambientColor * material.ambientColor;
+
+	// diffuse lighting
+	float impact = max(dot(lightNormal, lightDirection), 0.0f);
+	diffuse = impact * light.diffuseColor * material.diffuseColor;
+
+	// specular lighting
+	vec3 reflectDirection = reflect(-lightDirection, lightNormal);
+	float specularComponent = pow(max(dot(viewDirection, reflectDirection), 0.0f), light.focalStrength);
+	specular = light.specularIntensity * specularComponent * material.shininess * material.specularColor * light.specularColor;
+
+	// shadows only block the direct light
+	return(ambient + (diffuse + specular) * lit);
+}
+
+// get how much of the light reaches the fragment, between 0 in
+// shadow and 1 fully lit, for the lights with a shadow map
+float CalcShadow(uint lightIndex, vec3 lightNormal, vec3 vertexPosition)
+{
+	vec3 offsetPosition = vertexPosition + lightNormal * SHADOW_NORMAL_OFFSET;
+
+	if (lightIndex == SHADOW_CUBE_LIGHT)
+	{
+		vec3 fromLight = offsetPosition - lights[lightIndex].position;
+		return(texture(shadowCubeMap, vec4(fromLight, length(fromLight) / shadowCubeFar - SHADOW_CUBE_BIAS)));
+	}
+	if (lightIndex == SHADOW_MAP_LIGHT)
+	{
+		vec4 lightPosition = shadowMatrix * vec4(offsetPosition, 1.0f);
+		vec3 mapPosition = lightPosition.xyz / lightPosition.w * 0.5f + 0.5f;
+		return(texture(shadowMap, vec3(mapPosition.xy, mapPosition.z - SHADOW_MAP_BIAS)));
+	}
+
+	return(1.0f);
+}
+
+// get the index of the cluster holding the fragment, the same way
+// LightClusters.cpp assigns the lights
+uint FindCluster(vec3 vertexPosition)
+{
+	float viewDepth = -(view * vec4(vertexPosition, 1.0f)).z;
+	uvec2 tile = uvec2(clamp(gl_FragCoord.xy / viewportSize, 0.0f, 0.999f) * vec2(clusterGridSize.xy));
+	int slice = int(floor(log(max(viewDepth, clusterDepthSlicing.x)) * clusterDepthSlicing.z + clusterDepthSlicing.w));
+	uint sliceIndex = uint(clamp(slice, 0, int(clusterGridSize.z) - 1));
+	return((sliceIndex * clusterGridSize.y + tile.y) * clusterGridSize.x + tile.x);
+}
+
+vec3 CalcPointLight(Light light, Material material, vec3 lightNormal, vec3 vertexPosition, vec3 viewDirection)
+{
+	vec3 toLight = light.position - vertexPosition;
+	float lightDistance = length(toLight);
+	if (lightDistance >= light.radius)
+	{
+		return(vec3(0.0f));
+	}
+
+	// inverse square falloff, windowed to reach zero at the radius
+	float window = 1.0f - pow(lightDistance / light.radius, 4.0f);
+	float attenuation = (window * window) / (lightDistance * lightDistance + 1.0f);
+
+	return(CalcLightSource(light, material, lightNormal, normalize(toLight), viewDirection, 1.0f) * attenuation);
+}
+
+vec4 CalcOverdraw()
+{
+	// the count before this fragment tells whether the pixel was
+	// already shaded
+	uint previousCount = imageAtomicAdd(overdrawCounts, ivec2(gl_FragCoord.xy), 1u);
+	atomicCounterIncrement(shadedFragments);
+	if (previousCount == 0u)
+	{
+		atomicCounterIncrement(coveredPixels);
+	}
+
+	// every shaded fragment passed the depth test, so the one drawn
+	// last at a pixel holds its count: green for once, red for many
+	float overdraw = clamp(float(previousCount) / (OVERDRAW_RED_COUNT - 1.0f), 0.0f, 1.0f);
+	return vec4(mix(vec3(0.0f, 0.6f, 0.0f), vec3(1.0f, 0.0f, 0.0f), overdraw), 1.0f);
+}
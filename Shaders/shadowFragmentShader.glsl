@@ -0,0 +1,24 @@
+///////////////////////////////////////////////////////////////////////////////
+// shadowFragmentShader.glsl
+// ============
+// write the depth of a shadow map, or the light distance of a cube map
+///////////////////////////////////////////////////////////////////////////////
+#version 440 core
+
+in vec3 fragmentPosition;
+
+// position of the point light and the distance stored as depth 1
+// in its cube map, or a zero w for the directional shadow map
+uniform vec4 lightPositionFar = vec4(0.0f);
+
+void main()
+{
+	if (lightPositionFar.w > 0.0f)
+	{
+		gl_FragDepth = length(fragmentPosition - lightPositionFar.xyz) / lightPositionFar.w;
+	}
+	else
+	{
+		gl_FragDepth = gl_FragCoord.z;
+	}
+}
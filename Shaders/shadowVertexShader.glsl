@@ -0,0 +1,28 @@
+///////////////////////////////////////////////////////////////////////////////
+// shadowVertexShader.glsl
+// ============
+// transform the mesh vertices into the view of a shadow casting light
+///////////////////////////////////////////////////////////////////////////////
+#version 440 core
+
+layout (location = 0) in vec3 inVertexPosition;
+
+// per-instance model matrix, must match the locations in InstancedMeshes.cpp
+layout (location = 3) in mat4 instanceModel;
+
+out vec3 fragmentPosition;
+
+// world to clip space of the shadow map or cube map face
+uniform mat4 lightViewProjection;
+
+// box the stored positions are quantized in, see MeshArena.h
+uniform vec3 positionScale = vec3(1.0f);
+uniform vec3 positionOffset = vec3(0.0f);
+
+void main()
+{
+	vec3 position = inVertexPosition * positionScale + positionOffset;
+
+	fragmentPosition = vec3(instanceModel * vec4(position, 1.0f));
+	gl_Position = lightViewProjection * vec4(fragmentPosition, 1.0f);
+}
@@ -0,0 +1,127 @@
+///////////////////////////////////////////////////////////////////////////////
+// vertexShader.glsl
+// ============
+// transform the mesh vertices for the Phong lighting fragment shader
+///////////////////////////////////////////////////////////////////////////////
+#version 440 core
+
+layout (location = 0) in vec3 inVertexPosition;
+layout (location = 1) in vec3 inVertexNormal;
+layout (location = 2) in vec2 inTextureCoordinate;
+
+// per-instance values, must match the locations in InstancedMeshes.cpp
+layout (location = 3) in mat4 instanceModel;
+layout (location = 7) in vec4 instanceColor;
+layout (location = 8) in vec2 instanceUVScale;
+layout (location = 9) in int instanceMaterialIndex;
+layout (location = 10) in int instanceTextureLayer;
+
+out vec3 fragmentPosition;
+out vec3 fragmentVertexNormal;
+out vec2 fragmentTextureCoordinate;
+out vec4 fragmentColor;
+flat out int fragmentMaterialIndex;
+flat out int fragmentTextureLayer;
+
+// the depth pre-pass computes the same position, see
+// CalcWorldPosition
+invariant gl_Position;
+
+// the camera values of the frame, shared by every shader program -
+// the layout must match GPU_CAMERA in CameraBuffer.h and the binding
+// CAMERA_BLOCK_BINDING in ShaderBindings.h
+layout (std140, binding = 0) uniform CameraBlock
+{
+	mat4 view;
+	mat4 projection;
+	mat4 viewProjection;
+	mat4 inverseView;
+	mat4 inverseProjection;
+	mat4 inverseViewProjection;
+	vec3 cameraPosition;
+	float time;
+	vec2 viewportSize;
+};
+
+uniform mat4 model;
+
+uniform vec4 objectColor = vec4(1.0f);
+uniform vec2 UVscale = vec2(1.0f, 1.0f);
+
+// index of the current material in the MaterialBlock
+uniform int materialIndex = 0;
+
+// layer of the object texture in the bound texture array
+uniform int textureLayer = 0;
+
+// true when the object values come from the instance attributes
+uniform bool bUseInstancing = false;
+
+// true when the meshes are stored in the compact vertex layout,
+// with octahedral normals in the first two normal components
+uniform bool bCompactVertices = false;
+// box the stored positions are quantized in, see MeshArena.h
+uniform vec3 positionScale = vec3(1.0f);
+uniform vec3 positionOffset = vec3(0.0f);
+
+// turn an octahedral encoded normal back into a unit vector
+vec3 DecodeOctahedral(vec2 encoded)
+{
+	vec3 normal = vec3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+	if (normal.z < 0.0f)
+	{
+		vec2 signs = vec2(normal.x >= 0.0f ? 1.0f : -1.0f, normal.y >= 0.0f ? 1.0f : -1.0f);
+		normal.xy = (1.0f - abs(normal.yx)) * signs;
+	}
+	return normalize(normal);
+}
+
+// get the world position of the vertex - this function and the
+// uniforms it reads are the same in vertexShader.glsl and
+// depthVertexShader.glsl, so the invariant gl_Position of the two
+// programs comes from the same expressions and flow control
+vec3 CalcWorldPosition()
+{
+	mat4 objectModel = model;
+	if (bUseInstancing == true)
+	{
+		objectModel = instanceModel;
+	}
+
+	vec3 position = inVertexPosition * positionScale + positionOffset;
+	return(vec3(objectModel * vec4(position, 1.0f)));
+}
+
+void main()
+{
+	mat4 objectModel = model;
+	vec4 color = objectColor;
+	vec2 uvScale = UVscale;
+	int objectMaterialIndex = materialIndex;
+	int objectTextureLayer = textureLayer;
+
+	if (bUseInstancing == true)
+	{
+		objectModel = instanceModel;
+		color = instanceColor;
+		uvScale = instanceUVScale;
+		objectMaterialIndex = instanceMaterialIndex;
+		objectTextureLayer = instanceTextureLayer;
+	}
+
+	vec3 normal = inVertexNormal;
+	if (bCompactVertices == true)
+	{
+		normal = DecodeOctahedral(inVertexNormal.xy);
+	}
+
+	// the vertex position in world space, used for lighting
+	fragmentPosition = CalcWorldPosition();
+	gl_Position = viewProjection * vec4(fragmentPosition, 1.0f);
+
+	fragmentVertexNormal = mat3(transpose(inverse(objectModel))) * normal;
+	fragmentTextureCoordinate = inTextureCoordinate * uvScale;
+	fragmentColor = color;
+	fragmentMaterialIndex = objectMaterialIndex;
+	fragmentTextureLayer = objectTextureLayer;
+}
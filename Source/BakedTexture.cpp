@@ -0,0 +1,243 @@
+///////////////////////////////////////////////////////////////////////////////
+// bakedtexture.cpp
+// ============
+// read and write the pre-mipmapped texture files made by the texture baker
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "BakedTexture.h"
+#include "BlockCompressor.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	const char g_Magic[4] = { 'B', 'T', 'E', 'X' };
+	const uint32_t FILE_VERSION = 1;
+
+	// extension of the baked files, next to the source images
+	const char* BAKED_EXTENSION = ".btex";
+
+	// alignment of the level data in the file
+	const size_t LEVEL_ALIGNMENT = 16;
+	// more levels than any texture size OpenGL allows
+	const uint32_t MAX_LEVELS = 32;
+}
+
+/***********************************************************
+ *  BakedTexture()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+BakedTexture::BakedTexture()
+{
+	m_header = NULL;
+	m_levels = NULL;
+}
+
+/***********************************************************
+ *  ~BakedTexture()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+BakedTexture::~BakedTexture()
+{
+	Close();
+}
+
+/***********************************************************
+ *  Open()
+ *
+ *  This method is used for memory mapping the passed in
+ *  baked texture file read-only.  The pages are only read
+ *  from disk when a level is uploaded.
+ ***********************************************************/
+bool BakedTexture::Open(const std::string& filename)
+{
+	Close();
+
+	if (!m_file.Open(filename))
+	{
+		return false;
+	}
+
+	m_header = (const BAKED_HEADER*)m_file.GetData();
+	m_levels = (const BAKED_LEVEL*)(m_file.GetData() + sizeof(BAKED_HEADER));
+
+	if (!Validate())
+	{
+		std::cout << "Invalid baked texture file:" << filename << std::endl;
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+/***********************************************************
+ *  Close()
+ *
+ *  This method is used for unmapping the file.  Levels that
+ *  were already uploaded are not affected.
+ ***********************************************************/
+void BakedTexture::Close()
+{
+	m_file.Close();
+	m_header = NULL;
+	m_levels = NULL;
+}
+
+/***********************************************************
+ *  Validate()
+ *
+ *  This method is used for checking that the mapped file is
+ *  a baked texture of this version, and that every level
+ *  has the expected size and lies inside the file, so a
+ *  truncated file can never be read past its end.
+ ***********************************************************/
+bool BakedTexture::Validate() const
+{
+	size_t size = m_file.GetSize();
+	if (size < sizeof(BAKED_HEADER))
+	{
+		return false;
+	}
+	if ((memcmp(m_header->magic, g_Magic, sizeof(g_Magic)) != 0) ||
+		(m_header->version != FILE_VERSION) ||
+		(m_header->format >= FORMAT_COUNT) ||
+		(m_header->width == 0) || (m_header->height == 0) ||
+		(m_header->levelCount == 0) || (m_header->levelCount > MAX_LEVELS))
+	{
+		return false;
+	}
+	if (size < sizeof(BAKED_HEADER) + sizeof(BAKED_LEVEL) * m_header->levelCount)
+	{
+		return false;
+	}
+
+	for (uint32_t level = 0; level < m_header->levelCount; level++)
+	{
+		size_t expectedSize = GetLevelByteSize(
+			(BAKED_FORMAT)m_header->format,
+			(int)m_header->width,
+			(int)m_header->height,
+			(int)level);
+		if ((m_levels[level].size != expectedSize) ||
+			(m_levels[level].offset > size) ||
+			(m_levels[level].size > size - m_levels[level].offset))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/***********************************************************
+ *  Write()
+ *
+ *  This method is used for writing a baked texture file
+ *  with the passed in format and levels.  The level data is
+ *  written as is, so it must already be in that format.
+ ***********************************************************/
+bool BakedTexture::Write(
+	const std::string& filename,
+	BAKED_FORMAT format,
+	int width,
+	int height,
+	const std::vector<std::vector<unsigned char> >& levels)
+{
+	if (levels.empty() || (levels.size() > MAX_LEVELS))
+	{
+		return false;
+	}
+
+	BAKED_HEADER header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, g_Magic, sizeof(g_Magic));
+	header.version = FILE_VERSION;
+	header.format = (uint32_t)format;
+	header.width = (uint32_t)width;
+	header.height = (uint32_t)height;
+	header.levelCount = (uint32_t)levels.size();
+
+	// lay out the levels after the level table
+	std::vector<BAKED_LEVEL> table(levels.size());
+	size_t offset = sizeof(BAKED_HEADER) + sizeof(BAKED_LEVEL) * levels.size();
+	for (size_t level = 0; level < levels.size(); level++)
+	{
+		offset = (offset + LEVEL_ALIGNMENT - 1) / LEVEL_ALIGNMENT * LEVEL_ALIGNMENT;
+		table[level].offset = offset;
+		table[level].size = levels[level].size();
+		offset += levels[level].size();
+	}
+
+	std::ofstream file(filename, std::ios::binary);
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	file.write((const char*)&header, sizeof(header));
+	file.write((const char*)table.data(), sizeof(BAKED_LEVEL) * table.size());
+
+	const char padding[LEVEL_ALIGNMENT] = { 0 };
+	size_t position = sizeof(BAKED_HEADER) + sizeof(BAKED_LEVEL) * levels.size();
+	for (size_t level = 0; level < levels.size(); level++)
+	{
+		file.write(padding, (std::streamsize)(table[level].offset - position));
+		file.write((const char*)levels[level].data(), (std::streamsize)levels[level].size());
+		position = (size_t)(table[level].offset + table[level].size);
+	}
+
+	file.close();
+
+	return(!file.fail());
+}
+
+/***********************************************************
+ *  GetBakedFilename()
+ *
+ *  This method is used for getting the name of the baked
+ *  file for an image, which replaces its extension.
+ ***********************************************************/
+std::string BakedTexture::GetBakedFilename(const std::string& imageFilename)
+{
+	size_t extension = imageFilename.find_last_of('.');
+	size_t separator = imageFilename.find_last_of("/\\");
+	if ((extension == std::string::npos) ||
+		((separator != std::string::npos) && (extension < separator)))
+	{
+		return(imageFilename + BAKED_EXTENSION);
+	}
+
+	return(imageFilename.substr(0, extension) + BAKED_EXTENSION);
+}
+
+/***********************************************************
+ *  GetLevelByteSize()
+ *
+ *  This method is used for getting the byte size of a level
+ *  of an image in the passed in format.
+ ***********************************************************/
+size_t BakedTexture::GetLevelByteSize(BAKED_FORMAT format, int width, int height, int level)
+{
+	int levelWidth = std::max(1, width >> level);
+	int levelHeight = std::max(1, height >> level);
+
+	switch (format)
+	{
+	case FORMAT_BC1:
+		return(BlockCompressor::GetCompressedSize(levelWidth, levelHeight, BlockCompressor::BC1_BLOCK_BYTES));
+	case FORMAT_BC3:
+		return(BlockCompressor::GetCompressedSize(levelWidth, levelHeight, BlockCompressor::BC3_BLOCK_BYTES));
+	default:
+		return((size_t)levelWidth * levelHeight * 4);
+	}
+}
@@ -0,0 +1,105 @@
+///////////////////////////////////////////////////////////////////////////////
+// bakedtexture.h
+// ============
+// read and write the pre-mipmapped texture files made by the texture baker
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  BakedTexture
+ *
+ *  This class reads a baked texture file by memory mapping
+ *  it, so the levels can be handed to OpenGL straight from
+ *  the file without decoding or copying them first.
+ *
+ *  File layout, little endian:
+ *    header       BAKED_HEADER
+ *    level table  one BAKED_LEVEL per mipmap level
+ *    level data   each level starting on a 16 byte boundary
+ *  The levels run from full resolution down to 1 x 1, with
+ *  the first row at the bottom, as OpenGL expects.
+ ***********************************************************/
+class BakedTexture
+{
+public:
+	// constructor
+	BakedTexture();
+	// destructor
+	~BakedTexture();
+
+	// how the pixels of the levels are stored
+	enum BAKED_FORMAT
+	{
+		FORMAT_RGBA8 = 0,
+		FORMAT_BC1,
+		FORMAT_BC3,
+		FORMAT_COUNT
+	};
+
+	// map the passed in file, false if it is missing or invalid
+	bool Open(const std::string& filename);
+	// unmap the file
+	void Close();
+
+	// write a baked texture file with the passed in levels
+	static bool Write(
+		const std::string& filename,
+		BAKED_FORMAT format,
+		int width,
+		int height,
+		const std::vector<std::vector<unsigned char> >& levels);
+	// get the baked file name for the passed in image file
+	static std::string GetBakedFilename(const std::string& imageFilename);
+	// get the byte size of a level in the passed in format
+	static size_t GetLevelByteSize(BAKED_FORMAT format, int width, int height, int level);
+
+	bool IsOpen() const { return(m_file.IsOpen()); }
+	BAKED_FORMAT GetFormat() const { return((BAKED_FORMAT)m_header->format); }
+	int GetWidth() const { return((int)m_header->width); }
+	int GetHeight() const { return((int)m_header->height); }
+	int GetLevelCount() const { return((int)m_header->levelCount); }
+	// get the mapped data and byte size of a level
+	const unsigned char* GetLevelData(int level) const { return(m_file.GetData() + m_levels[level].offset); }
+	size_t GetLevelSize(int level) const { return((size_t)m_levels[level].size); }
+
+private:
+	struct BAKED_HEADER
+	{
+		char magic[4];
+		uint32_t version;
+		uint32_t format;
+		uint32_t width;
+		uint32_t height;
+		uint32_t levelCount;
+		uint32_t reserved[2];
+	};
+
+	struct BAKED_LEVEL
+	{
+		uint64_t offset;
+		uint64_t size;
+	};
+
+	// BakedTexture objects own a mapping and cannot be copied
+	BakedTexture(const BakedTexture&);
+	BakedTexture& operator=(const BakedTexture&);
+
+	// check the mapped header and level table
+	bool Validate() const;
+
+	// the mapped file, and its header and level table
+	MappedFile m_file;
+	const BAKED_HEADER* m_header;
+	const BAKED_LEVEL* m_levels;
+};
@@ -0,0 +1,337 @@
+///////////////////////////////////////////////////////////////////////////////
+// blockcompressor.cpp
+// ============
+// compress RGBA images into BC1 and BC3 blocks for the texture baker
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "BlockCompressor.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+// declaration of global variables
+namespace
+{
+	// pixels along each side of a block
+	const int BLOCK_SIZE = 4;
+	const int CHANNELS = 4;
+
+	/***********************************************************
+	 *  PackColor565()
+	 *
+	 *  This function is used for rounding an 8 bit per channel
+	 *  color to the 5:6:5 bit color stored in a block.
+	 ***********************************************************/
+	unsigned short PackColor565(const int color[3])
+	{
+		int red = (color[0] * 31 + 127) / 255;
+		int green = (color[1] * 63 + 127) / 255;
+		int blue = (color[2] * 31 + 127) / 255;
+		return((unsigned short)((red << 11) | (green << 5) | blue));
+	}
+
+	/***********************************************************
+	 *  UnpackColor565()
+	 *
+	 *  This function is used for expanding a 5:6:5 bit color
+	 *  back to 8 bits per channel, the way the GPU does.
+	 ***********************************************************/
+	void UnpackColor565(unsigned short packed, int color[3])
+	{
+		int red = (packed >> 11) & 31;
+		int green = (packed >> 5) & 63;
+		int blue = packed & 31;
+		color[0] = (red << 3) | (red >> 2);
+		color[1] = (green << 2) | (green >> 4);
+		color[2] = (blue << 3) | (blue >> 2);
+	}
+}
+
+/***********************************************************
+ *  GetCompressedSize()
+ *
+ *  This method is used for getting the byte size of an image
+ *  of the passed in size stored as blocks.  Partial blocks
+ *  at the edges take a whole block.
+ ***********************************************************/
+size_t BlockCompressor::GetCompressedSize(int width, int height, int blockBytes)
+{
+	size_t blocksX = (size_t)(width + BLOCK_SIZE - 1) / BLOCK_SIZE;
+	size_t blocksY = (size_t)(height + BLOCK_SIZE - 1) / BLOCK_SIZE;
+	return(blocksX * blocksY * blockBytes);
+}
+
+/***********************************************************
+ *  CompressBC1()
+ *
+ *  This method is used for encoding an RGBA image as BC1
+ *  blocks, in rows from the first line of the image.  The
+ *  alpha channel is dropped.
+ ***********************************************************/
+void BlockCompressor::CompressBC1(
+	const unsigned char* pixels,
+	int width,
+	int height,
+	std::vector<unsigned char>& output)
+{
+	unsigned char block[64];
+
+	for (int blockY = 0; blockY < height; blockY += BLOCK_SIZE)
+	{
+		for (int blockX = 0; blockX < width; blockX += BLOCK_SIZE)
+		{
+			ReadBlock(pixels, width, height, blockX, blockY, block);
+
+			size_t offset = output.size();
+			output.resize(offset + BC1_BLOCK_BYTES);
+			EncodeColorBlock(block, output.data() + offset);
+		}
+	}
+}
+
+/***********************************************************
+ *  CompressBC3()
+ *
+ *  This method is used for encoding an RGBA image as BC3
+ *  blocks, each holding the alpha block then the color
+ *  block of the same 4 x 4 pixels.
+ ***********************************************************/
+void BlockCompressor::CompressBC3(
+	const unsigned char* pixels,
+	int width,
+	int height,
+	std::vector<unsigned char>& output)
+{
+	unsigned char block[64];
+
+	for (int blockY = 0; blockY < height; blockY += BLOCK_SIZE)
+	{
+		for (int blockX = 0; blockX < width; blockX += BLOCK_SIZE)
+		{
+			ReadBlock(pixels, width, height, blockX, blockY, block);
+
+			size_t offset = output.size();
+			output.resize(offset + BC3_BLOCK_BYTES);
+			EncodeAlphaBlock(block, output.data() + offset);
+			EncodeColorBlock(block, output.data() + offset + 8);
+		}
+	}
+}
+
+/***********************************************************
+ *  IsOpaque()
+ *
+ *  This method is used for checking whether the alpha of
+ *  every pixel is 255, in which case BC1 loses nothing.
+ ***********************************************************/
+bool BlockCompressor::IsOpaque(const unsigned char* pixels, int width, int height)
+{
+	size_t pixelCount = (size_t)width * height;
+	for (size_t i = 0; i < pixelCount; i++)
+	{
+		if (pixels[i * CHANNELS + 3] != 255)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/***********************************************************
+ *  ReadBlock()
+ *
+ *  This method is used for copying the 16 RGBA pixels of
+ *  the block at the passed in corner.  The small mipmap
+ *  levels are narrower than a block, so the coordinates are
+ *  clamped to the last row and column of the image.
+ ***********************************************************/
+void BlockCompressor::ReadBlock(
+	const unsigned char* pixels,
+	int width,
+	int height,
+	int blockX,
+	int blockY,
+	unsigned char block[64])
+{
+	for (int y = 0; y < BLOCK_SIZE; y++)
+	{
+		int sourceY = std::min(blockY + y, height - 1);
+		for (int x = 0; x < BLOCK_SIZE; x++)
+		{
+			int sourceX = std::min(blockX + x, width - 1);
+			const unsigned char* source = pixels + ((size_t)sourceY * width + sourceX) * CHANNELS;
+			unsigned char* destination = block + (y * BLOCK_SIZE + x) * CHANNELS;
+			for (int c = 0; c < CHANNELS; c++)
+			{
+				destination[c] = source[c];
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  EncodeColorBlock()
+ *
+ *  This method is used for encoding the color of 16 pixels
+ *  as two 5:6:5 end colors and a 2 bit palette index per
+ *  pixel.  The end colors are the corners of the bounding
+ *  box of the pixels, moved in slightly, and the red and
+ *  blue ranges are flipped when they fall as green rises,
+ *  so the line between the ends follows the pixel colors.
+ ***********************************************************/
+void BlockCompressor::EncodeColorBlock(const unsigned char block[64], unsigned char* output)
+{
+	int minColor[3] = { 255, 255, 255 };
+	int maxColor[3] = { 0, 0, 0 };
+	int mean[3] = { 0, 0, 0 };
+
+	for (int i = 0; i < 16; i++)
+	{
+		for (int c = 0; c < 3; c++)
+		{
+			minColor[c] = std::min(minColor[c], (int)block[i * CHANNELS + c]);
+			maxColor[c] = std::max(maxColor[c], (int)block[i * CHANNELS + c]);
+			mean[c] += block[i * CHANNELS + c];
+		}
+	}
+
+	// the sign of the covariance with green picks the diagonal
+	// of the box for the red and blue channels
+	int covariance[3] = { 0, 0, 0 };
+	for (int i = 0; i < 16; i++)
+	{
+		int green = block[i * CHANNELS + 1] * 16 - mean[1];
+		covariance[0] += (block[i * CHANNELS + 0] * 16 - mean[0]) * green;
+		covariance[2] += (block[i * CHANNELS + 2] * 16 - mean[2]) * green;
+	}
+	for (int c = 0; c < 3; c += 2)
+	{
+		if (covariance[c] < 0)
+		{
+			std::swap(minColor[c], maxColor[c]);
+		}
+	}
+
+	// move the ends in by 1/16 of the range, since the
+	// extreme pixels are rarely the best end colors
+	for (int c = 0; c < 3; c++)
+	{
+		int inset = (maxColor[c] - minColor[c]) / 16;
+		maxColor[c] = std::min(255, std::max(0, maxColor[c] - inset));
+		minColor[c] = std::min(255, std::max(0, minColor[c] + inset));
+	}
+
+	unsigned short color0 = PackColor565(maxColor);
+	unsigned short color1 = PackColor565(minColor);
+
+	// the first end color must be the larger one, otherwise
+	// BC1 switches to its 3 color mode with transparency
+	if (color0 < color1)
+	{
+		std::swap(color0, color1);
+	}
+
+	int palette[4][3];
+	UnpackColor565(color0, palette[0]);
+	UnpackColor565(color1, palette[1]);
+	for (int c = 0; c < 3; c++)
+	{
+		palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+		palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+	}
+
+	unsigned int indices = 0;
+	if (color0 != color1)
+	{
+		for (int i = 0; i < 16; i++)
+		{
+			int bestIndex = 0;
+			int bestDistance = 0x7fffffff;
+			for (int p = 0; p < 4; p++)
+			{
+				int distance = 0;
+				for (int c = 0; c < 3; c++)
+				{
+					int difference = block[i * CHANNELS + c] - palette[p][c];
+					distance += difference * difference;
+				}
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					bestIndex = p;
+				}
+			}
+			indices |= (unsigned int)bestIndex << (i * 2);
+		}
+	}
+
+	// the values are stored little endian
+	output[0] = (unsigned char)(color0 & 0xff);
+	output[1] = (unsigned char)(color0 >> 8);
+	output[2] = (unsigned char)(color1 & 0xff);
+	output[3] = (unsigned char)(color1 >> 8);
+	for (int i = 0; i < 4; i++)
+	{
+		output[4 + i] = (unsigned char)((indices >> (i * 8)) & 0xff);
+	}
+}
+
+/***********************************************************
+ *  EncodeAlphaBlock()
+ *
+ *  This method is used for encoding the alpha of 16 pixels
+ *  as the largest and smallest alpha and a 3 bit index per
+ *  pixel into the 8 values between them.
+ ***********************************************************/
+void BlockCompressor::EncodeAlphaBlock(const unsigned char block[64], unsigned char* output)
+{
+	int alpha0 = 0;
+	int alpha1 = 255;
+	for (int i = 0; i < 16; i++)
+	{
+		alpha0 = std::max(alpha0, (int)block[i * CHANNELS + 3]);
+		alpha1 = std::min(alpha1, (int)block[i * CHANNELS + 3]);
+	}
+
+	// with the first alpha larger, the block uses 6 values
+	// evenly spaced between the two ends
+	int palette[8];
+	palette[0] = alpha0;
+	palette[1] = alpha1;
+	for (int p = 2; p < 8; p++)
+	{
+		palette[p] = ((8 - p) * alpha0 + (p - 1) * alpha1) / 7;
+	}
+
+	unsigned long long indices = 0;
+	if (alpha0 != alpha1)
+	{
+		for (int i = 0; i < 16; i++)
+		{
+			int alpha = block[i * CHANNELS + 3];
+			int bestIndex = 0;
+			int bestDistance = 256;
+			for (int p = 0; p < 8; p++)
+			{
+				int distance = std::abs(alpha - palette[p]);
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					bestIndex = p;
+				}
+			}
+			indices |= (unsigned long long)bestIndex << (i * 3);
+		}
+	}
+
+	output[0] = (unsigned char)alpha0;
+	output[1] = (unsigned char)alpha1;
+	for (int i = 0; i < 6; i++)
+	{
+		output[2 + i] = (unsigned char)((indices >> (i * 8)) & 0xff);
+	}
+}
@@ -0,0 +1,67 @@
+///////////////////////////////////////////////////////////////////////////////
+// blockcompressor.h
+// ============
+// compress RGBA images into BC1 and BC3 blocks for the texture baker
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/***********************************************************
+ *  BlockCompressor
+ *
+ *  This class encodes RGBA images into the 4 x 4 pixel
+ *  blocks read by the GPU (S3TC):
+ *    BC1  8 bytes per block, opaque color
+ *    BC3  16 bytes per block, color plus smooth alpha
+ *  Each block takes the two end colors of the bounding box
+ *  of its pixels and picks the nearest of the colors in
+ *  between for every pixel.  This is fast and good enough
+ *  for the scene textures; no OpenGL function is called.
+ ***********************************************************/
+class BlockCompressor
+{
+public:
+	// bytes of one compressed 4 x 4 block
+	static const int BC1_BLOCK_BYTES = 8;
+	static const int BC3_BLOCK_BYTES = 16;
+
+	// get the byte size of an image compressed with the
+	// passed in block size
+	static size_t GetCompressedSize(int width, int height, int blockBytes);
+
+	// compress an RGBA image, appending the blocks to output
+	static void CompressBC1(
+		const unsigned char* pixels,
+		int width,
+		int height,
+		std::vector<unsigned char>& output);
+	static void CompressBC3(
+		const unsigned char* pixels,
+		int width,
+		int height,
+		std::vector<unsigned char>& output);
+
+	// true when every pixel of the RGBA image is opaque
+	static bool IsOpaque(const unsigned char* pixels, int width, int height);
+
+private:
+	// copy the 4 x 4 block at the passed in corner, repeating
+	// the last row and column past the edge of the image
+	static void ReadBlock(
+		const unsigned char* pixels,
+		int width,
+		int height,
+		int blockX,
+		int blockY,
+		unsigned char block[64]);
+	// encode the color of a block into 8 bytes
+	static void EncodeColorBlock(const unsigned char block[64], unsigned char* output);
+	// encode the alpha of a block into 8 bytes
+	static void EncodeAlphaBlock(const unsigned char block[64], unsigned char* output);
+};
@@ -0,0 +1,196 @@
+///////////////////////////////////////////////////////////////////////////////
+// camerabuffer.cpp
+// ============
+// share the per-frame camera values with every shader program
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "CameraBuffer.h"
+#include "ShaderBindings.h"
+
+#include <cstring>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	const char* g_CameraBlockName = "CameraBlock";
+
+	// longest single wait on a fence, in nanoseconds, before
+	// the wait is repeated
+	const GLuint64 FENCE_WAIT_TIMEOUT = 100000000;
+}
+
+static_assert(sizeof(CameraBuffer::GPU_CAMERA) == 416,
+	"GPU_CAMERA must match the std140 layout of the shader CameraBlock");
+
+/***********************************************************
+ *  CameraBuffer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+CameraBuffer::CameraBuffer()
+{
+	m_bufferID = 0;
+	m_pMapped = NULL;
+	m_regionStride = 0;
+	m_region = -1;
+	for (int i = 0; i < FRAME_COUNT; i++)
+	{
+		m_fences[i] = NULL;
+	}
+}
+
+/***********************************************************
+ *  ~CameraBuffer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+CameraBuffer::~CameraBuffer()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  AttachProgram()
+ *
+ *  This method is used for checking whether the passed in
+ *  shader program declares the CameraBlock.  If it does,
+ *  the block is connected to the fixed binding point and
+ *  true is returned.  Shaders without the block keep using
+ *  the individual view uniforms.
+ ***********************************************************/
+bool CameraBuffer::AttachProgram(GLuint programID)
+{
+	GLuint blockIndex = glGetUniformBlockIndex(programID, g_CameraBlockName);
+	if (blockIndex == GL_INVALID_INDEX)
+	{
+		return false;
+	}
+
+	glUniformBlockBinding(programID, blockIndex, CAMERA_BLOCK_BINDING);
+
+	return true;
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for creating the uniform buffer with
+ *  immutable storage and mapping all its regions at once.
+ *  The mapping is coherent, so the written values reach the
+ *  GPU without a flush or unmap.
+ ***********************************************************/
+bool CameraBuffer::Create()
+{
+	GLint alignment = 0;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	alignment = (alignment > 0) ? alignment : 256;
+	m_regionStride = (sizeof(GPU_CAMERA) + alignment - 1) / alignment * alignment;
+
+	GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	glCreateBuffers(1, &m_bufferID);
+	glNamedBufferStorage(m_bufferID, m_regionStride * FRAME_COUNT, NULL, flags);
+	m_pMapped = (unsigned char*)glMapNamedBufferRange(m_bufferID, 0, m_regionStride * FRAME_COUNT, flags);
+	if (m_pMapped == NULL)
+	{
+		std::cout << "Failed to map the camera uniform buffer" << std::endl;
+		Destroy();
+		return false;
+	}
+
+	m_region = 0;
+
+	return true;
+}
+
+/***********************************************************
+ *  WaitForRegion()
+ *
+ *  This method is used for blocking until the draws that
+ *  last read the passed in region have finished.  The fence
+ *  is usually signaled long before, as it was placed two
+ *  frames earlier.
+ ***********************************************************/
+void CameraBuffer::WaitForRegion(int region)
+{
+	if (m_fences[region] == NULL)
+	{
+		return;
+	}
+
+	GLenum result = glClientWaitSync(m_fences[region], GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_WAIT_TIMEOUT);
+	while (result == GL_TIMEOUT_EXPIRED)
+	{
+		result = glClientWaitSync(m_fences[region], 0, FENCE_WAIT_TIMEOUT);
+	}
+
+	glDeleteSync(m_fences[region]);
+	m_fences[region] = NULL;
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for writing the camera values of the
+ *  frame and binding them to the CameraBlock.  It is called
+ *  once per frame, before any draw, so every draw of the
+ *  previous frame has been submitted when it runs and the
+ *  fence placed for that frame's region covers them all.
+ ***********************************************************/
+void CameraBuffer::Update(const GPU_CAMERA& camera)
+{
+	if ((m_bufferID == 0) && (Create() == false))
+	{
+		return;
+	}
+
+	// the previous region is done being submitted to
+	int previous = (m_region + FRAME_COUNT - 1) % FRAME_COUNT;
+	if (m_fences[previous] != NULL)
+	{
+		glDeleteSync(m_fences[previous]);
+	}
+	m_fences[previous] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+	WaitForRegion(m_region);
+
+	GLintptr offset = m_regionStride * m_region;
+	memcpy(m_pMapped + offset, &camera, sizeof(GPU_CAMERA));
+	glBindBufferRange(GL_UNIFORM_BUFFER, CAMERA_BLOCK_BINDING, m_bufferID, offset, sizeof(GPU_CAMERA));
+
+	m_region = (m_region + 1) % FRAME_COUNT;
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for freeing the fences and the
+ *  uniform buffer, which also ends its mapping.
+ ***********************************************************/
+void CameraBuffer::Destroy()
+{
+	for (int i = 0; i < FRAME_COUNT; i++)
+	{
+		if (m_fences[i] != NULL)
+		{
+			glDeleteSync(m_fences[i]);
+			m_fences[i] = NULL;
+		}
+	}
+
+	if (m_bufferID != 0)
+	{
+		if (m_pMapped != NULL)
+		{
+			glUnmapNamedBuffer(m_bufferID);
+		}
+		glDeleteBuffers(1, &m_bufferID);
+		m_bufferID = 0;
+	}
+	m_pMapped = NULL;
+	m_regionStride = 0;
+	m_region = -1;
+}
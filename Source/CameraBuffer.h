@@ -0,0 +1,87 @@
+///////////////////////////////////////////////////////////////////////////////
+// camerabuffer.h
+// ============
+// share the per-frame camera values with every shader program
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+/***********************************************************
+ *  CameraBuffer
+ *
+ *  This class holds the camera values of each frame in one
+ *  std140 uniform buffer bound to the CameraBlock of the
+ *  shaders.  The block has a fixed binding point, so every
+ *  shader program that declares it reads the same values
+ *  without any uniform being set per program.
+ *
+ *  The buffer is mapped once for the life of the program
+ *  and split into one region per frame in flight.  Each
+ *  frame writes the next region, after waiting on the fence
+ *  placed when that region was last read, so the CPU never
+ *  overwrites values the GPU has not drawn with yet.
+ ***********************************************************/
+class CameraBuffer
+{
+public:
+	// constructor
+	CameraBuffer();
+	// destructor
+	~CameraBuffer();
+
+	// number of frames the CPU may run ahead of the GPU
+	static const int FRAME_COUNT = 3;
+
+	// the camera values in the std140 layout of the CameraBlock
+	struct GPU_CAMERA
+	{
+		glm::mat4 view;
+		glm::mat4 projection;
+		glm::mat4 viewProjection;
+		glm::mat4 inverseView;
+		glm::mat4 inverseProjection;
+		glm::mat4 inverseViewProjection;
+		glm::vec3 cameraPosition;
+		// seconds since the program started
+		float time;
+		// size of the rendered viewport in pixels
+		glm::vec2 viewportSize;
+		glm::vec2 padding;
+	};
+
+	// check whether the shader program declares the CameraBlock
+	// and connect the block to its binding point
+	bool AttachProgram(GLuint programID);
+	// write the camera values of this frame into the next
+	// region and bind that region to the CameraBlock
+	void Update(const GPU_CAMERA& camera);
+	// unmap and free the uniform buffer
+	void Destroy();
+
+	// true when the buffer is created and mapped
+	bool IsReady() const { return(m_bufferID != 0); }
+
+private:
+	// create the buffer and map it for the life of the program
+	bool Create();
+	// wait until the GPU has finished reading a region
+	void WaitForRegion(int region);
+
+	// OpenGL uniform buffer object
+	GLuint m_bufferID;
+	// start of the mapped buffer
+	unsigned char* m_pMapped;
+	// distance between the regions, rounded up to the uniform
+	// buffer offset alignment
+	GLsizeiptr m_regionStride;
+	// region written by the next update, -1 before the first
+	int m_region;
+	// fences placed after the last draws that read each region
+	GLsync m_fences[FRAME_COUNT];
+};
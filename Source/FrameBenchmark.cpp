@@ -0,0 +1,394 @@
+///////////////////////////////////////////////////////////////////////////////
+// framebenchmark.cpp
+// ============
+// replay a scripted camera path and measure the frame timings
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FrameBenchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// number of timer queries in flight before a result is read
+	const int TIMER_QUERY_COUNT = 4;
+
+	// name of the scripted camera path written into the report
+	const char* g_CameraPathName = "desk_orbit";
+
+	/***********************************************************
+	 *  EscapeJSON()
+	 *
+	 *  This function is used for escaping the passed in text
+	 *  so it can be written as a JSON string value.
+	 ***********************************************************/
+	std::string EscapeJSON(const char* text)
+	{
+		std::string escaped;
+
+		if (text == NULL)
+		{
+			return(escaped);
+		}
+
+		for (const char* c = text; *c != '\0'; c++)
+		{
+			if ((*c == '"') || (*c == '\\'))
+			{
+				escaped += '\\';
+			}
+			escaped += *c;
+		}
+
+		return(escaped);
+	}
+
+	/***********************************************************
+	 *  WriteStats()
+	 *
+	 *  This function is used for writing the passed in timing
+	 *  statistics as a JSON object.
+	 ***********************************************************/
+	void WriteStats(std::ostream& out, const FrameBenchmark::TIMING_STATS& stats)
+	{
+		out << "{ \"min\": " << stats.minimum
+			<< ", \"median\": " << stats.median
+			<< ", \"mean\": " << stats.mean
+			<< ", \"p95\": " << stats.p95
+			<< ", \"p99\": " << stats.p99
+			<< ", \"max\": " << stats.maximum << " }";
+	}
+}
+
+/***********************************************************
+ *  FrameBenchmark()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FrameBenchmark::FrameBenchmark(
+	ViewManager* pViewManager,
+	int measuredFrames,
+	int warmupFrames)
+{
+	m_pViewManager = pViewManager;
+	m_measuredFrames = measuredFrames;
+	m_warmupFrames = warmupFrames;
+	m_currentFrame = -1;
+	m_completedFrames = 0;
+
+	m_cpuTimes.assign(measuredFrames, 0.0);
+	m_gpuTimes.assign(measuredFrames, 0.0);
+	for (int i = 0; i < RenderStats::COUNTER_COUNT; i++)
+	{
+		m_counterTotals[i] = 0.0;
+	}
+
+	// the scripted camera path orbits the desk once, passes
+	// close to the books and the mouse, and ends back at the
+	// default camera position
+	m_cameraPath = {
+		{ glm::vec3(0.0f, 5.0f, 12.0f),   glm::vec3(0.0f, 1.5f, 0.0f) },
+		{ glm::vec3(10.0f, 4.0f, 8.0f),   glm::vec3(0.0f, 1.5f, 0.0f) },
+		{ glm::vec3(12.0f, 3.0f, -2.0f),  glm::vec3(0.0f, 1.5f, 0.0f) },
+		{ glm::vec3(0.0f, 6.0f, -12.0f),  glm::vec3(0.0f, 1.5f, 0.0f) },
+		{ glm::vec3(-12.0f, 3.0f, -2.0f), glm::vec3(0.0f, 1.5f, 0.0f) },
+		{ glm::vec3(-8.0f, 2.0f, 6.0f),   glm::vec3(-6.0f, 0.75f, 1.0f) },
+		{ glm::vec3(-3.0f, 1.5f, 6.0f),   glm::vec3(-3.0f, -0.5f, 2.5f) },
+		{ glm::vec3(0.0f, 5.0f, 12.0f),   glm::vec3(0.0f, 1.5f, 0.0f) }
+	};
+
+	m_timerQueries.assign(TIMER_QUERY_COUNT, 0);
+	m_queryFrames.assign(TIMER_QUERY_COUNT, -1);
+	glGenQueries(TIMER_QUERY_COUNT, m_timerQueries.data());
+
+	// the camera is driven by the path only, so the keyboard,
+	// the mouse and the frame time must not move it
+	m_pViewManager->SetScriptedCamera(true);
+}
+
+/***********************************************************
+ *  ~FrameBenchmark()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+FrameBenchmark::~FrameBenchmark()
+{
+	glDeleteQueries(TIMER_QUERY_COUNT, m_timerQueries.data());
+	m_pViewManager = NULL;
+}
+
+/***********************************************************
+ *  ApplyCameraPath()
+ *
+ *  This method is used for moving the camera to the point
+ *  on the scripted path for the passed in frame.  The path
+ *  is evaluated from the frame index alone, never from the
+ *  elapsed time, so all runs render identical frames.
+ ***********************************************************/
+void FrameBenchmark::ApplyCameraPath(int frameIndex)
+{
+	float pathPosition = 0.0f;
+
+	// the warmup frames are all rendered from the first keyframe
+	if ((frameIndex >= m_warmupFrames) && (m_measuredFrames > 1))
+	{
+		pathPosition = float(frameIndex - m_warmupFrames) / float(m_measuredFrames - 1);
+	}
+
+	float segment = pathPosition * float(m_cameraPath.size() - 1);
+	int first = std::min(int(segment), int(m_cameraPath.size()) - 2);
+	float blend = segment - float(first);
+
+	const CAMERA_KEYFRAME& from = m_cameraPath[first];
+	const CAMERA_KEYFRAME& to = m_cameraPath[first + 1];
+
+	glm::vec3 position = glm::mix(from.position, to.position, blend);
+	glm::vec3 target = glm::mix(from.target, to.target, blend);
+
+	m_pViewManager->SetCameraPose(position, glm::normalize(target - position));
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for positioning the camera and
+ *  starting the CPU and GPU timers for the passed in frame.
+ ***********************************************************/
+void FrameBenchmark::BeginFrame(int frameIndex)
+{
+	m_currentFrame = frameIndex;
+
+	ApplyCameraPath(frameIndex);
+
+	// reuse the oldest timer query, reading its result first
+	int slot = frameIndex % TIMER_QUERY_COUNT;
+	if (m_queryFrames[slot] >= 0)
+	{
+		CollectQuery(slot);
+	}
+	m_queryFrames[slot] = frameIndex;
+
+	m_frameStart = std::chrono::steady_clock::now();
+	if (frameIndex == m_warmupFrames)
+	{
+		m_measureStart = m_frameStart;
+	}
+
+	glBeginQuery(GL_TIME_ELAPSED, m_timerQueries[slot]);
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for stopping the CPU and GPU timers
+ *  of the current frame.
+ ***********************************************************/
+void FrameBenchmark::EndFrame()
+{
+	glEndQuery(GL_TIME_ELAPSED);
+
+	std::chrono::steady_clock::time_point frameEnd = std::chrono::steady_clock::now();
+
+	int measuredIndex = m_currentFrame - m_warmupFrames;
+	if ((measuredIndex >= 0) && (measuredIndex < m_measuredFrames))
+	{
+		m_cpuTimes[measuredIndex] =
+			std::chrono::duration<double, std::milli>(frameEnd - m_frameStart).count();
+
+		// the last measured frame waits for the GPU so that the
+		// frame rate includes all of the submitted work
+		if (measuredIndex == m_measuredFrames - 1)
+		{
+			glFinish();
+			m_measureEnd = std::chrono::steady_clock::now();
+		}
+	}
+
+	m_completedFrames++;
+}
+
+/***********************************************************
+ *  RecordRenderStats()
+ *
+ *  This method is used for adding the renderer counters of
+ *  the current frame to the totals, when it is measured.
+ ***********************************************************/
+void FrameBenchmark::RecordRenderStats(const RenderStats& stats)
+{
+	int measuredIndex = m_currentFrame - m_warmupFrames;
+	if ((measuredIndex < 0) || (measuredIndex >= m_measuredFrames))
+	{
+		return;
+	}
+
+	for (int i = 0; i < RenderStats::COUNTER_COUNT; i++)
+	{
+		m_counterTotals[i] += (double)stats.Get((RenderStats::COUNTER_ID)i);
+	}
+}
+
+/***********************************************************
+ *  IsComplete()
+ *
+ *  This method returns true when all the warmup and measured
+ *  frames have been rendered.
+ ***********************************************************/
+bool FrameBenchmark::IsComplete() const
+{
+	return(m_completedFrames >= GetTotalFrames());
+}
+
+/***********************************************************
+ *  CollectQuery()
+ *
+ *  This method is used for reading the elapsed GPU time of
+ *  the timer query in the passed in slot.
+ ***********************************************************/
+void FrameBenchmark::CollectQuery(int slot)
+{
+	GLuint64 elapsedNanoseconds = 0;
+	glGetQueryObjectui64v(m_timerQueries[slot], GL_QUERY_RESULT, &elapsedNanoseconds);
+
+	int measuredIndex = m_queryFrames[slot] - m_warmupFrames;
+	if ((measuredIndex >= 0) && (measuredIndex < m_measuredFrames))
+	{
+		m_gpuTimes[measuredIndex] = double(elapsedNanoseconds) / 1000000.0;
+	}
+
+	m_queryFrames[slot] = -1;
+}
+
+/***********************************************************
+ *  CalculateStats()
+ *
+ *  This method is used for calculating the statistics of
+ *  the passed in timings.  Percentiles use the nearest-rank
+ *  method on the sorted timings.
+ ***********************************************************/
+FrameBenchmark::TIMING_STATS FrameBenchmark::CalculateStats(std::vector<double> timings)
+{
+	TIMING_STATS stats = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+
+	if (timings.empty())
+	{
+		return(stats);
+	}
+
+	std::sort(timings.begin(), timings.end());
+
+	size_t count = timings.size();
+	double total = 0.0;
+	for (size_t i = 0; i < count; i++)
+	{
+		total += timings[i];
+	}
+
+	// nearest-rank percentile of the sorted timings, the
+	// smallest rank covering the fraction of the frames
+	auto percentile = [&timings, count](double fraction)
+	{
+		size_t rank = (size_t)std::ceil(fraction * double(count));
+		rank = std::max<size_t>(1, std::min(rank, count));
+		return(timings[rank - 1]);
+	};
+
+	stats.minimum = timings.front();
+	stats.maximum = timings.back();
+	stats.mean = total / double(count);
+	stats.median = (count % 2 == 1) ?
+		timings[count / 2] :
+		(timings[count / 2 - 1] + timings[count / 2]) * 0.5;
+	stats.p95 = percentile(0.95);
+	stats.p99 = percentile(0.99);
+
+	return(stats);
+}
+
+/***********************************************************
+ *  WriteReport()
+ *
+ *  This method is used for reading the outstanding timer
+ *  queries, calculating the timing statistics and writing
+ *  them as JSON into the passed in file, or to the console
+ *  when no filename is passed in.
+ ***********************************************************/
+bool FrameBenchmark::WriteReport(const std::string& filename)
+{
+	for (int slot = 0; slot < TIMER_QUERY_COUNT; slot++)
+	{
+		if (m_queryFrames[slot] >= 0)
+		{
+			CollectQuery(slot);
+		}
+	}
+
+	TIMING_STATS cpuStats = CalculateStats(m_cpuTimes);
+	TIMING_STATS gpuStats = CalculateStats(m_gpuTimes);
+
+	double measuredSeconds =
+		std::chrono::duration<double>(m_measureEnd - m_measureStart).count();
+	double framesPerSecond = 0.0;
+	if (measuredSeconds > 0.0)
+	{
+		framesPerSecond = double(m_measuredFrames) / measuredSeconds;
+	}
+
+	std::ofstream file;
+	if (!filename.empty())
+	{
+		file.open(filename);
+		if (!file)
+		{
+			std::cout << "Could not open benchmark report:" << filename << std::endl;
+			return false;
+		}
+	}
+	std::ostream& out = filename.empty() ? std::cout : file;
+
+	out << std::fixed << std::setprecision(4);
+	out << "{\n";
+	out << "  \"camera_path\": \"" << g_CameraPathName << "\",\n";
+	out << "  \"renderer\": \"" << EscapeJSON((const char*)glGetString(GL_RENDERER)) << "\",\n";
+	out << "  \"gl_version\": \"" << EscapeJSON((const char*)glGetString(GL_VERSION)) << "\",\n";
+	out << "  \"viewport\": [" << m_pViewManager->GetViewportWidth() << ", "
+		<< m_pViewManager->GetViewportHeight() << "],\n";
+	out << "  \"warmup_frames\": " << m_warmupFrames << ",\n";
+	out << "  \"measured_frames\": " << m_measuredFrames << ",\n";
+	out << "  \"fps\": " << framesPerSecond << ",\n";
+	out << "  \"cpu_ms\": ";
+	WriteStats(out, cpuStats);
+	out << ",\n";
+	out << "  \"gpu_ms\": ";
+	WriteStats(out, gpuStats);
+	out << ",\n";
+	// renderer counters, as the mean per measured frame
+	out << "  \"counters\": {";
+	for (int i = 0; i < RenderStats::COUNTER_COUNT; i++)
+	{
+		double mean = (m_measuredFrames > 0) ? m_counterTotals[i] / double(m_measuredFrames) : 0.0;
+		out << ((i == 0) ? " " : ", ") << "\"" << RenderStats::GetName((RenderStats::COUNTER_ID)i) << "\": " << mean;
+	}
+	out << " },\n";
+	out << "  \"frames\": [\n";
+	for (int i = 0; i < m_measuredFrames; i++)
+	{
+		out << "    { \"cpu_ms\": " << m_cpuTimes[i] << ", \"gpu_ms\": " << m_gpuTimes[i] << " }";
+		out << ((i + 1 < m_measuredFrames) ? ",\n" : "\n");
+	}
+	out << "  ]\n";
+	out << "}\n";
+
+	std::cout << "INFO: Benchmark " << m_measuredFrames << " frames, "
+		<< framesPerSecond << " FPS, CPU median " << cpuStats.median
+		<< " ms, GPU median " << gpuStats.median << " ms" << std::endl;
+
+	return true;
+}
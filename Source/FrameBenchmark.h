@@ -0,0 +1,112 @@
+///////////////////////////////////////////////////////////////////////////////
+// framebenchmark.h
+// ============
+// replay a scripted camera path and measure the frame timings
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ViewManager.h"
+#include "RenderStats.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  FrameBenchmark
+ *
+ *  This class drives the camera along a fixed path through
+ *  the 3D scene, one step per frame, so that every run sees
+ *  exactly the same sequence of views.  The CPU time of each
+ *  frame is measured with a steady clock and the GPU time
+ *  with OpenGL timer queries, then the statistics are
+ *  reported as JSON.
+ ***********************************************************/
+class FrameBenchmark
+{
+public:
+	// constructor
+	FrameBenchmark(
+		ViewManager* pViewManager,
+		int measuredFrames,
+		int warmupFrames);
+	// destructor
+	~FrameBenchmark();
+
+	struct CAMERA_KEYFRAME
+	{
+		glm::vec3 position;
+		glm::vec3 target;
+	};
+
+	struct TIMING_STATS
+	{
+		double minimum;
+		double median;
+		double mean;
+		double p95;
+		double p99;
+		double maximum;
+	};
+
+	// position the camera and start timing the passed in frame
+	void BeginFrame(int frameIndex);
+	// stop timing the current frame
+	void EndFrame();
+	// add the counters of the current frame to the report
+	void RecordRenderStats(const RenderStats& stats);
+	// true when all the warmup and measured frames are done
+	bool IsComplete() const;
+	// total number of frames to render for the benchmark
+	int GetTotalFrames() const { return(m_warmupFrames + m_measuredFrames); }
+
+	// collect outstanding GPU timings and write the JSON report
+	bool WriteReport(const std::string& filename);
+
+private:
+	// pointer to view manager object
+	ViewManager* m_pViewManager;
+	// number of frames recorded in the report
+	int m_measuredFrames;
+	// number of frames rendered before recording starts
+	int m_warmupFrames;
+	// index of the frame being measured
+	int m_currentFrame;
+	// number of frames that have completed
+	int m_completedFrames;
+
+	// keyframes of the scripted camera path
+	std::vector<CAMERA_KEYFRAME> m_cameraPath;
+
+	// ring of timer queries so the GPU results can be read
+	// a few frames later without stalling the pipeline
+	std::vector<GLuint> m_timerQueries;
+	std::vector<int> m_queryFrames;
+
+	// start time of the current frame on the CPU
+	std::chrono::steady_clock::time_point m_frameStart;
+	// start time of the first measured frame
+	std::chrono::steady_clock::time_point m_measureStart;
+	// end time of the last measured frame
+	std::chrono::steady_clock::time_point m_measureEnd;
+
+	// recorded timings of the measured frames in milliseconds
+	std::vector<double> m_cpuTimes;
+	std::vector<double> m_gpuTimes;
+	// sums of the renderer counters over the measured frames
+	double m_counterTotals[RenderStats::COUNTER_COUNT];
+
+	// move the camera to the path position of the passed in frame
+	void ApplyCameraPath(int frameIndex);
+	// read back the result of a timer query into the GPU timings
+	void CollectQuery(int slot);
+	// calculate the statistics of the passed in timings
+	static TIMING_STATS CalculateStats(std::vector<double> timings);
+};
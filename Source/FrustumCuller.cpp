@@ -0,0 +1,187 @@
+///////////////////////////////////////////////////////////////////////////////
+// frustumculler.cpp
+// ============
+// test the bounding boxes of the scene objects against the view frustum
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FrustumCuller.h"
+
+#include <cmath>
+
+/***********************************************************
+ *  FrustumCuller()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FrustumCuller::FrustumCuller()
+{
+	// until a frustum is set, every plane accepts everything
+	for (int i = 0; i < PLANE_COUNT; i++)
+	{
+		m_planeA[i] = 0.0f;
+		m_planeB[i] = 0.0f;
+		m_planeC[i] = 0.0f;
+		m_planeD[i] = 1.0f;
+	}
+}
+
+/***********************************************************
+ *  Resize()
+ *
+ *  This method is used for setting the number of bounding
+ *  boxes.  Existing boxes keep their values.
+ ***********************************************************/
+void FrustumCuller::Resize(size_t count)
+{
+	m_centerX.resize(count, 0.0f);
+	m_centerY.resize(count, 0.0f);
+	m_centerZ.resize(count, 0.0f);
+	m_extentX.resize(count, 0.0f);
+	m_extentY.resize(count, 0.0f);
+	m_extentZ.resize(count, 0.0f);
+	m_visible.resize(count, 1);
+}
+
+/***********************************************************
+ *  SetBounds()
+ *
+ *  This method is used for setting the world-space bounding
+ *  box of the object at the passed in index.
+ ***********************************************************/
+void FrustumCuller::SetBounds(
+	size_t index,
+	const glm::vec3& center,
+	const glm::vec3& extent)
+{
+	m_centerX[index] = center.x;
+	m_centerY[index] = center.y;
+	m_centerZ[index] = center.z;
+	m_extentX[index] = extent.x;
+	m_extentY[index] = extent.y;
+	m_extentZ[index] = extent.z;
+}
+
+/***********************************************************
+ *  SetFrustum()
+ *
+ *  This method is used for extracting the six frustum planes
+ *  from the passed in view projection matrix, by adding and
+ *  subtracting its rows.  The planes are not normalized; the
+ *  box test compares two distances with the same scale.
+ ***********************************************************/
+void FrustumCuller::SetFrustum(const glm::mat4& viewProjection)
+{
+	// rows of the matrix, which glm stores by column
+	glm::vec4 rows[4];
+	for (int row = 0; row < 4; row++)
+	{
+		rows[row] = glm::vec4(
+			viewProjection[0][row],
+			viewProjection[1][row],
+			viewProjection[2][row],
+			viewProjection[3][row]);
+	}
+
+	// left, right, bottom, top, near and far
+	glm::vec4 planes[PLANE_COUNT] =
+	{
+		rows[3] + rows[0],
+		rows[3] - rows[0],
+		rows[3] + rows[1],
+		rows[3] - rows[1],
+		rows[3] + rows[2],
+		rows[3] - rows[2]
+	};
+
+	for (int i = 0; i < PLANE_COUNT; i++)
+	{
+		m_planeA[i] = planes[i].x;
+		m_planeB[i] = planes[i].y;
+		m_planeC[i] = planes[i].z;
+		m_planeD[i] = planes[i].w;
+	}
+}
+
+/***********************************************************
+ *  Cull()
+ *
+ *  This method is used for testing every bounding box
+ *  against the frustum planes.  A box is outside when its
+ *  center lies further behind a plane than the box reaches
+ *  along the plane normal.  Boxes that cross a plane are
+ *  kept, so nothing visible is ever removed.
+ ***********************************************************/
+int FrustumCuller::Cull()
+{
+	size_t count = m_visible.size();
+
+	const float* centerX = m_centerX.data();
+	const float* centerY = m_centerY.data();
+	const float* centerZ = m_centerZ.data();
+	const float* extentX = m_extentX.data();
+	const float* extentY = m_extentY.data();
+	const float* extentZ = m_extentZ.data();
+	uint8_t* visible = m_visible.data();
+
+	for (size_t i = 0; i < count; i++)
+	{
+		visible[i] = 1;
+	}
+
+	for (int plane = 0; plane < PLANE_COUNT; plane++)
+	{
+		float a = m_planeA[plane];
+		float b = m_planeB[plane];
+		float c = m_planeC[plane];
+		float d = m_planeD[plane];
+		float absA = std::fabs(a);
+		float absB = std::fabs(b);
+		float absC = std::fabs(c);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			float distance = a * centerX[i] + b * centerY[i] + c * centerZ[i] + d;
+			float reach = absA * extentX[i] + absB * extentY[i] + absC * extentZ[i];
+			visible[i] &= (uint8_t)(distance + reach >= 0.0f);
+		}
+	}
+
+	int visibleCount = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		visibleCount += visible[i];
+	}
+
+	return(visibleCount);
+}
+
+/***********************************************************
+ *  TransformBounds()
+ *
+ *  This method is used for building the world bounding box
+ *  that encloses a local bounding box after the passed in
+ *  model matrix is applied.  The center is transformed as a
+ *  point, and the half extent by the absolute values of the
+ *  rotation and scale part of the matrix.
+ ***********************************************************/
+void FrustumCuller::TransformBounds(
+	const glm::mat4& modelMatrix,
+	const glm::vec3& localCenter,
+	const glm::vec3& localExtent,
+	glm::vec3& worldCenter,
+	glm::vec3& worldExtent)
+{
+	glm::vec4 center = modelMatrix * glm::vec4(localCenter, 1.0f);
+	worldCenter = glm::vec3(center.x, center.y, center.z);
+
+	for (int row = 0; row < 3; row++)
+	{
+		worldExtent[row] =
+			std::fabs(modelMatrix[0][row]) * localExtent.x +
+			std::fabs(modelMatrix[1][row]) * localExtent.y +
+			std::fabs(modelMatrix[2][row]) * localExtent.z;
+	}
+}
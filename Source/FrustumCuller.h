@@ -0,0 +1,76 @@
+///////////////////////////////////////////////////////////////////////////////
+// frustumculler.h
+// ============
+// test the bounding boxes of the scene objects against the view frustum
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  FrustumCuller
+ *
+ *  This class keeps the world-space bounding box of every
+ *  scene object as a center and a half extent, with each
+ *  component in its own array, and the six frustum planes
+ *  in the same layout.  The test runs one plane at a time
+ *  over all the boxes in straight loops of float math with
+ *  no branches, which the compiler turns into SIMD code.
+ ***********************************************************/
+class FrustumCuller
+{
+public:
+	// constructor
+	FrustumCuller();
+
+	// number of planes bounding the view frustum
+	static const int PLANE_COUNT = 6;
+
+	// set the number of bounding boxes
+	void Resize(size_t count);
+	// set the world-space bounding box of an object
+	void SetBounds(
+		size_t index,
+		const glm::vec3& center,
+		const glm::vec3& extent);
+	// extract the frustum planes from the view projection matrix
+	void SetFrustum(const glm::mat4& viewProjection);
+	// test all the bounding boxes and return the visible count
+	int Cull();
+
+	// true when the object was inside the frustum at the last test
+	bool IsVisible(size_t index) const { return(m_visible[index] != 0); }
+
+	// transform a local bounding box into a world bounding box
+	static void TransformBounds(
+		const glm::mat4& modelMatrix,
+		const glm::vec3& localCenter,
+		const glm::vec3& localExtent,
+		glm::vec3& worldCenter,
+		glm::vec3& worldExtent);
+
+private:
+	// frustum planes as a.x + b.y + c.z + d, pointing inward
+	float m_planeA[PLANE_COUNT];
+	float m_planeB[PLANE_COUNT];
+	float m_planeC[PLANE_COUNT];
+	float m_planeD[PLANE_COUNT];
+
+	// bounding box centers and half extents, one array per axis
+	std::vector<float> m_centerX;
+	std::vector<float> m_centerY;
+	std::vector<float> m_centerZ;
+	std::vector<float> m_extentX;
+	std::vector<float> m_extentY;
+	std::vector<float> m_extentZ;
+
+	// result of the last test, 1 for visible
+	std::vector<uint8_t> m_visible;
+};
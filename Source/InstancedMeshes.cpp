@@ -0,0 +1,251 @@
+///////////////////////////////////////////////////////////////////////////////
+// instancedmeshes.cpp
+// ============
+// draw many copies of a basic mesh with one instanced draw call
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "InstancedMeshes.h"
+
+#include <cstddef>
+
+// declaration of global variables
+namespace
+{
+	// vertex attribute locations, matching the vertex shader
+	const GLuint ATTRIBUTE_INSTANCE_MODEL = 3;
+	const GLuint ATTRIBUTE_INSTANCE_COLOR = 7;
+	const GLuint ATTRIBUTE_INSTANCE_UV_SCALE = 8;
+	const GLuint ATTRIBUTE_INSTANCE_MATERIAL = 9;
+	const GLuint ATTRIBUTE_INSTANCE_TEXTURE_LAYER = 10;
+	// vertex array binding the instance buffer is read from,
+	// after the vertex buffer of the arena
+	const GLuint INSTANCE_BINDING = 1;
+
+	// number of instances the buffer first makes room for
+	const size_t INITIAL_INSTANCE_CAPACITY = 256;
+	// number of draw commands the buffer first makes room for
+	const size_t INITIAL_COMMAND_CAPACITY = 64;
+}
+
+/***********************************************************
+ *  InstancedMeshes()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+InstancedMeshes::InstancedMeshes(MeshArena* pMeshArena)
+{
+	m_pMeshArena = pMeshArena;
+	m_instanceBuffer = 0;
+	m_instanceCapacity = 0;
+	m_commandBuffer = 0;
+	m_commandCapacity = 0;
+}
+
+/***********************************************************
+ *  ~InstancedMeshes()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+InstancedMeshes::~InstancedMeshes()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  CreateInstanceBuffer()
+ *
+ *  This method is used for creating the instance buffer and
+ *  adding the instance attributes to the vertex array of
+ *  the arena, advanced once per copy instead of per vertex.
+ *  The buffer is only ever orphaned, never replaced, so the
+ *  vertex array keeps reading from it as it grows.
+ ***********************************************************/
+void InstancedMeshes::CreateInstanceBuffer()
+{
+	GLuint vao = m_pMeshArena->GetVertexArray();
+
+	m_instanceCapacity = INITIAL_INSTANCE_CAPACITY;
+	glCreateBuffers(1, &m_instanceBuffer);
+	glNamedBufferData(m_instanceBuffer, sizeof(INSTANCE_DATA) * m_instanceCapacity, NULL, GL_STREAM_DRAW);
+
+	for (GLuint column = 0; column < 4; column++)
+	{
+		glEnableVertexArrayAttrib(vao, ATTRIBUTE_INSTANCE_MODEL + column);
+		glVertexArrayAttribFormat(vao, ATTRIBUTE_INSTANCE_MODEL + column, 4, GL_FLOAT, GL_FALSE,
+			(GLuint)(offsetof(INSTANCE_DATA, modelMatrix) + sizeof(glm::vec4) * column));
+		glVertexArrayAttribBinding(vao, ATTRIBUTE_INSTANCE_MODEL + column, INSTANCE_BINDING);
+	}
+	glEnableVertexArrayAttrib(vao, ATTRIBUTE_INSTANCE_COLOR);
+	glVertexArrayAttribFormat(vao, ATTRIBUTE_INSTANCE_COLOR, 4, GL_FLOAT, GL_FALSE,
+		offsetof(INSTANCE_DATA, color));
+	glVertexArrayAttribBinding(vao, ATTRIBUTE_INSTANCE_COLOR, INSTANCE_BINDING);
+	glEnableVertexArrayAttrib(vao, ATTRIBUTE_INSTANCE_UV_SCALE);
+	glVertexArrayAttribFormat(vao, ATTRIBUTE_INSTANCE_UV_SCALE, 2, GL_FLOAT, GL_FALSE,
+		offsetof(INSTANCE_DATA, uvScale));
+	glVertexArrayAttribBinding(vao, ATTRIBUTE_INSTANCE_UV_SCALE, INSTANCE_BINDING);
+	glEnableVertexArrayAttrib(vao, ATTRIBUTE_INSTANCE_MATERIAL);
+	glVertexArrayAttribIFormat(vao, ATTRIBUTE_INSTANCE_MATERIAL, 1, GL_INT,
+		offsetof(INSTANCE_DATA, materialIndex));
+	glVertexArrayAttribBinding(vao, ATTRIBUTE_INSTANCE_MATERIAL, INSTANCE_BINDING);
+	glEnableVertexArrayAttrib(vao, ATTRIBUTE_INSTANCE_TEXTURE_LAYER);
+	glVertexArrayAttribIFormat(vao, ATTRIBUTE_INSTANCE_TEXTURE_LAYER, 1, GL_INT,
+		offsetof(INSTANCE_DATA, textureLayer));
+	glVertexArrayAttribBinding(vao, ATTRIBUTE_INSTANCE_TEXTURE_LAYER, INSTANCE_BINDING);
+
+	glVertexArrayVertexBuffer(vao, INSTANCE_BINDING, m_instanceBuffer, 0, sizeof(INSTANCE_DATA));
+	glVertexArrayBindingDivisor(vao, INSTANCE_BINDING, 1);
+}
+
+/***********************************************************
+ *  UploadInstances()
+ *
+ *  This method is used for uploading the per-instance values
+ *  of all the batches drawn in the current frame in one go.
+ *  The old storage is orphaned first, so the upload never
+ *  waits for the draws of the previous frame to finish.
+ ***********************************************************/
+void InstancedMeshes::UploadInstances(const std::vector<INSTANCE_DATA>& instances)
+{
+	if ((m_pMeshArena->GetVertexArray() == 0) || instances.empty())
+	{
+		return;
+	}
+
+	if (m_instanceBuffer == 0)
+	{
+		CreateInstanceBuffer();
+	}
+
+	// grow by doubling so the buffer settles after a few frames
+	while (m_instanceCapacity < instances.size())
+	{
+		m_instanceCapacity *= 2;
+	}
+
+	glNamedBufferData(m_instanceBuffer, sizeof(INSTANCE_DATA) * m_instanceCapacity, NULL, GL_STREAM_DRAW);
+	glNamedBufferSubData(m_instanceBuffer, 0, sizeof(INSTANCE_DATA) * instances.size(), instances.data());
+}
+
+/***********************************************************
+ *  DrawInstances()
+ *
+ *  This method is used for drawing a range of the uploaded
+ *  instances with the passed in mesh in one draw call, with
+ *  the values currently set into the shader.
+ ***********************************************************/
+void InstancedMeshes::DrawInstances(int meshID, int firstInstance, int instanceCount)
+{
+	if ((meshID < 0) || (meshID >= m_pMeshArena->GetMeshCount()) || (instanceCount <= 0))
+	{
+		return;
+	}
+
+	const MeshArena::MESH_RANGE& mesh = m_pMeshArena->GetMesh(meshID);
+
+	m_pMeshArena->Bind();
+	glDrawElementsInstancedBaseVertexBaseInstance(
+		GL_TRIANGLES,
+		(GLsizei)mesh.indexCount,
+		m_pMeshArena->GetIndexType(),
+		(void*)((size_t)m_pMeshArena->GetIndexSize() * mesh.firstIndex),
+		instanceCount,
+		mesh.baseVertex,
+		(GLuint)firstInstance);
+}
+
+/***********************************************************
+ *  MakeCommand()
+ *
+ *  This method is used for filling in the indirect draw
+ *  command that draws a range of the uploaded instances
+ *  with the passed in mesh.
+ ***********************************************************/
+void InstancedMeshes::MakeCommand(int meshID, int firstInstance, int instanceCount, DRAW_COMMAND& command) const
+{
+	const MeshArena::MESH_RANGE& mesh = m_pMeshArena->GetMesh(meshID);
+
+	command.indexCount = mesh.indexCount;
+	command.instanceCount = (GLuint)instanceCount;
+	command.firstIndex = mesh.firstIndex;
+	command.baseVertex = mesh.baseVertex;
+	command.baseInstance = (GLuint)firstInstance;
+}
+/***********************************************************
+ *  UploadCommands()
+ *
+ *  This method is used for uploading the indirect draw
+ *  commands of the current frame, orphaning the old storage
+ *  the same way as the instances.
+ ***********************************************************/
+void InstancedMeshes::UploadCommands(const std::vector<DRAW_COMMAND>& commands)
+{
+	if (commands.empty())
+	{
+		return;
+	}
+
+	if (m_commandBuffer == 0)
+	{
+		glGenBuffers(1, &m_commandBuffer);
+		m_commandCapacity = INITIAL_COMMAND_CAPACITY;
+	}
+	while (m_commandCapacity < commands.size())
+	{
+		m_commandCapacity *= 2;
+	}
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+	glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(DRAW_COMMAND) * m_commandCapacity, NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof(DRAW_COMMAND) * commands.size(), commands.data());
+}
+
+/***********************************************************
+ *  DrawCommands()
+ *
+ *  This method is used for drawing a range of the uploaded
+ *  commands with one call.  The commands are read from the
+ *  indirect buffer on the GPU, so the cost on this thread
+ *  does not depend on the number of commands.
+ ***********************************************************/
+void InstancedMeshes::DrawCommands(int firstCommand, int commandCount)
+{
+	if ((m_commandBuffer == 0) || (commandCount <= 0))
+	{
+		return;
+	}
+
+	m_pMeshArena->Bind();
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+	glMultiDrawElementsIndirect(
+		GL_TRIANGLES,
+		m_pMeshArena->GetIndexType(),
+		(void*)(sizeof(DRAW_COMMAND) * firstCommand),
+		commandCount,
+		0);
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for freeing the instance and command
+ *  buffers.  The meshes belong to the arena.
+ ***********************************************************/
+void InstancedMeshes::Destroy()
+{
+	if (m_instanceBuffer != 0)
+	{
+		glDeleteBuffers(1, &m_instanceBuffer);
+	}
+	if (m_commandBuffer != 0)
+	{
+		glDeleteBuffers(1, &m_commandBuffer);
+	}
+
+	m_instanceBuffer = 0;
+	m_instanceCapacity = 0;
+	m_commandBuffer = 0;
+	m_commandCapacity = 0;
+}
@@ -0,0 +1,98 @@
+///////////////////////////////////////////////////////////////////////////////
+// instancedmeshes.h
+// ============
+// draw many copies of a basic mesh with one instanced draw call
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "MeshArena.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  InstancedMeshes
+ *
+ *  This class draws many copies of the meshes of a
+ *  MeshArena.  The per-instance values of a frame are
+ *  uploaded together into one instance buffer that the
+ *  vertex array of the arena reads from a second binding.
+ *  Each batch of copies of a mesh is then drawn with one
+ *  instanced call, or a list of batches is drawn with one
+ *  glMultiDrawElementsIndirect call.
+ *
+ *  Per-instance vertex attribute locations:
+ *    3 - 6  model matrix, one column per location
+ *    7      object color
+ *    8      texture UV scale
+ *    9      material index into the MaterialBlock
+ *    10     texture layer in the bound texture array
+ ***********************************************************/
+class InstancedMeshes
+{
+public:
+	// constructor
+	InstancedMeshes(MeshArena* pMeshArena);
+	// destructor
+	~InstancedMeshes();
+
+	// the per-instance values of one copy of a mesh
+	struct INSTANCE_DATA
+	{
+		glm::mat4 modelMatrix;
+		glm::vec4 color;
+		glm::vec2 uvScale;
+		GLint materialIndex;
+		// layer of the texture array - the copies of one draw
+		// must share the array, but can each use another layer
+		GLint textureLayer;
+	};
+
+	// one draw of a multi-draw, laid out as OpenGL reads it
+	// from the indirect buffer
+	struct DRAW_COMMAND
+	{
+		GLuint indexCount;
+		GLuint instanceCount;
+		GLuint firstIndex;
+		GLint baseVertex;
+		GLuint baseInstance;
+	};
+
+	// upload all the instances drawn in the current frame
+	void UploadInstances(const std::vector<INSTANCE_DATA>& instances);
+	// draw a range of the uploaded instances with the passed in mesh
+	void DrawInstances(int meshID, int firstInstance, int instanceCount);
+
+	// fill in the command drawing a range of the uploaded
+	// instances with the passed in mesh
+	void MakeCommand(int meshID, int firstInstance, int instanceCount, DRAW_COMMAND& command) const;
+	// upload all the draw commands of the current frame
+	void UploadCommands(const std::vector<DRAW_COMMAND>& commands);
+	// draw a range of the uploaded commands with one call
+	void DrawCommands(int firstCommand, int commandCount);
+	// free the instance and command buffers
+	void Destroy();
+
+private:
+	// create the instance buffer and attach it to the vertex
+	// array of the arena
+	void CreateInstanceBuffer();
+
+	// pointer to the arena holding the meshes
+	MeshArena* m_pMeshArena;
+	// buffer holding the per-instance values of the frame
+	GLuint m_instanceBuffer;
+	// allocated size of the instance buffer in instances
+	size_t m_instanceCapacity;
+	// buffer holding the draw commands of the frame
+	GLuint m_commandBuffer;
+	// allocated size of the command buffer in commands
+	size_t m_commandCapacity;
+};
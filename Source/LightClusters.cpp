@@ -0,0 +1,352 @@
+///////////////////////////////////////////////////////////////////////////////
+// lightclusters.cpp
+// ============
+// assign the scene point lights to the view frustum clusters they reach
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "LightClusters.h"
+#include "ShaderBindings.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// declaration of global variables
+namespace
+{
+	// smallest size the buffers are created with, in bytes
+	const size_t MIN_BUFFER_CAPACITY = 4096;
+}
+
+static_assert(sizeof(LightClusters::CLUSTER_RANGE) == 8,
+	"CLUSTER_RANGE must match the std430 layout of a shader uvec2");
+
+/***********************************************************
+ *  LightClusters()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+LightClusters::LightClusters()
+{
+	m_lightCount = 0;
+	m_firstLight = 0;
+	m_lightVersion = 0;
+	m_nearDepth = 0.1f;
+	m_farDepth = 100.0f;
+	m_sliceScale = 0.0f;
+	m_sliceBias = 0.0f;
+	m_clusterBuffer = 0;
+	m_indexBuffer = 0;
+	m_clusterCapacity = 0;
+	m_indexCapacity = 0;
+}
+
+/***********************************************************
+ *  ~LightClusters()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+LightClusters::~LightClusters()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  GatherLights()
+ *
+ *  This method is used for copying the centers and radii of
+ *  the lights with a radius, one array per value, for
+ *  assigning them to the clusters.  They follow the lights
+ *  without a radius in the light array.
+ ***********************************************************/
+void LightClusters::GatherLights(const LightManager& lights)
+{
+	m_firstLight = (size_t)lights.GetGlobalLightCount();
+	m_lightCount = (size_t)lights.GetLightCount() - m_firstLight;
+	m_lightVersion = lights.GetVersion();
+	m_positionX.resize(m_lightCount);
+	m_positionY.resize(m_lightCount);
+	m_positionZ.resize(m_lightCount);
+	m_radius.resize(m_lightCount);
+	m_viewX.resize(m_lightCount);
+	m_viewY.resize(m_lightCount);
+	m_viewZ.resize(m_lightCount);
+	m_clusterMinimum.resize(m_lightCount);
+	m_clusterMaximum.resize(m_lightCount);
+
+	for (size_t i = 0; i < m_lightCount; i++)
+	{
+		const LightManager::GPU_LIGHT& light = lights.GetLight((int)(m_firstLight + i));
+		m_positionX[i] = light.position.x;
+		m_positionY[i] = light.position.y;
+		m_positionZ[i] = light.position.z;
+		m_radius[i] = light.radius;
+	}
+}
+
+/***********************************************************
+ *  GetSlice()
+ *
+ *  This method is used for getting the depth slice that
+ *  holds the passed in distance in front of the camera.
+ *  The fragment shader finds its slice the same way.
+ ***********************************************************/
+int LightClusters::GetSlice(float viewDepth) const
+{
+	int slice = (int)std::floor(std::log(std::max(viewDepth, m_nearDepth)) * m_sliceScale + m_sliceBias);
+	return(std::max(0, std::min(CLUSTER_COUNT_Z - 1, slice)));
+}
+
+/***********************************************************
+ *  GetClusterBounds()
+ *
+ *  This method is used for finding the block of clusters
+ *  covered by the view-space bounding box of a light.  Along
+ *  X and Y, the box spreads widest on screen at its nearest
+ *  or its farthest depth, so projecting the corners at those
+ *  two depths bounds it for both projections.
+ ***********************************************************/
+bool LightClusters::GetClusterBounds(
+	size_t light,
+	const glm::mat4& projection,
+	glm::ivec3& minimum,
+	glm::ivec3& maximum) const
+{
+	float radius = m_radius[light];
+	float depth = -m_viewZ[light];
+	float nearest = depth - radius;
+	float farthest = depth + radius;
+	if ((farthest < m_nearDepth) || (nearest > m_farDepth))
+	{
+		return false;
+	}
+	nearest = std::max(nearest, m_nearDepth);
+	farthest = std::min(farthest, m_farDepth);
+
+	glm::vec2 screenMinimum(1e30f, 1e30f);
+	glm::vec2 screenMaximum(-1e30f, -1e30f);
+	const float depths[2] = { nearest, farthest };
+	for (int d = 0; d < 2; d++)
+	{
+		for (int corner = 0; corner < 4; corner++)
+		{
+			float x = m_viewX[light] + (((corner & 1) != 0) ? radius : -radius);
+			float y = m_viewY[light] + (((corner & 2) != 0) ? radius : -radius);
+			glm::vec4 clip = projection * glm::vec4(x, y, -depths[d], 1.0f);
+			glm::vec2 ndc(clip.x / clip.w, clip.y / clip.w);
+			screenMinimum = glm::min(screenMinimum, ndc);
+			screenMaximum = glm::max(screenMaximum, ndc);
+		}
+	}
+	if ((screenMaximum.x < -1.0f) || (screenMinimum.x > 1.0f) ||
+		(screenMaximum.y < -1.0f) || (screenMinimum.y > 1.0f))
+	{
+		return false;
+	}
+
+	minimum.x = std::max(0, (int)std::floor((screenMinimum.x * 0.5f + 0.5f) * CLUSTER_COUNT_X));
+	minimum.y = std::max(0, (int)std::floor((screenMinimum.y * 0.5f + 0.5f) * CLUSTER_COUNT_Y));
+	minimum.z = GetSlice(nearest);
+	maximum.x = std::min(CLUSTER_COUNT_X - 1, (int)std::floor((screenMaximum.x * 0.5f + 0.5f) * CLUSTER_COUNT_X));
+	maximum.y = std::min(CLUSTER_COUNT_Y - 1, (int)std::floor((screenMaximum.y * 0.5f + 0.5f) * CLUSTER_COUNT_Y));
+	maximum.z = GetSlice(farthest);
+
+	return true;
+}
+
+/***********************************************************
+ *  Build()
+ *
+ *  This method is used for building the light list of every
+ *  cluster for the passed in view.  The lists are packed one
+ *  after the other: the clusters are first counted, then the
+ *  counts are turned into offsets, and the indices are then
+ *  written in a second pass, so no list is allocated on its
+ *  own.  The cluster ranges and the lists are uploaded to
+ *  freshly orphaned storage, so the previous frame is never
+ *  waited on.  The light centers are only copied again when
+ *  a light has changed.
+ ***********************************************************/
+int LightClusters::Build(
+	const LightManager& lights,
+	const glm::mat4& view,
+	const glm::mat4& projection)
+{
+	if ((lights.GetVersion() != m_lightVersion) ||
+		(m_lightCount + m_firstLight != (size_t)lights.GetLightCount()))
+	{
+		GatherLights(lights);
+	}
+
+	// the depth range comes from the projection itself, so it
+	// holds for the perspective and the orthographic one
+	glm::mat4 inverseProjection = glm::inverse(projection);
+	glm::vec4 nearPoint = inverseProjection * glm::vec4(0.0f, 0.0f, -1.0f, 1.0f);
+	glm::vec4 farPoint = inverseProjection * glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+	m_nearDepth = std::max(-nearPoint.z / nearPoint.w, 0.001f);
+	m_farDepth = std::max(-farPoint.z / farPoint.w, m_nearDepth * 2.0f);
+	float logRange = std::log(m_farDepth / m_nearDepth);
+	m_sliceScale = CLUSTER_COUNT_Z / logRange;
+	m_sliceBias = -CLUSTER_COUNT_Z * std::log(m_nearDepth) / logRange;
+
+	// move the light centers into view space, one component
+	// at a time over all the lights
+	const float* positionX = m_positionX.data();
+	const float* positionY = m_positionY.data();
+	const float* positionZ = m_positionZ.data();
+	for (int row = 0; row < 3; row++)
+	{
+		float* result = (row == 0) ? m_viewX.data() : ((row == 1) ? m_viewY.data() : m_viewZ.data());
+		float a = view[0][row];
+		float b = view[1][row];
+		float c = view[2][row];
+		float d = view[3][row];
+		for (size_t i = 0; i < m_lightCount; i++)
+		{
+			result[i] = a * positionX[i] + b * positionY[i] + c * positionZ[i] + d;
+		}
+	}
+
+	m_clusterData.assign(sizeof(CLUSTER_HEADER) + sizeof(CLUSTER_RANGE) * CLUSTER_COUNT, 0);
+	CLUSTER_HEADER* header = (CLUSTER_HEADER*)m_clusterData.data();
+	CLUSTER_RANGE* ranges = (CLUSTER_RANGE*)(m_clusterData.data() + sizeof(CLUSTER_HEADER));
+	header->gridSize[0] = CLUSTER_COUNT_X;
+	header->gridSize[1] = CLUSTER_COUNT_Y;
+	header->gridSize[2] = CLUSTER_COUNT_Z;
+	header->gridSize[3] = (GLuint)m_lightCount;
+	header->depthSlicing[0] = m_nearDepth;
+	header->depthSlicing[1] = m_farDepth;
+	header->depthSlicing[2] = m_sliceScale;
+	header->depthSlicing[3] = m_sliceBias;
+
+	// count the lights of each cluster
+	int visibleCount = 0;
+	for (size_t i = 0; i < m_lightCount; i++)
+	{
+		if (!GetClusterBounds(i, projection, m_clusterMinimum[i], m_clusterMaximum[i]))
+		{
+			m_clusterMinimum[i] = glm::ivec3(-1, -1, -1);
+			continue;
+		}
+		visibleCount++;
+
+		for (int z = m_clusterMinimum[i].z; z <= m_clusterMaximum[i].z; z++)
+		{
+			for (int y = m_clusterMinimum[i].y; y <= m_clusterMaximum[i].y; y++)
+			{
+				CLUSTER_RANGE* row = ranges + (z * CLUSTER_COUNT_Y + y) * CLUSTER_COUNT_X;
+				for (int x = m_clusterMinimum[i].x; x <= m_clusterMaximum[i].x; x++)
+				{
+					row[x].count++;
+				}
+			}
+		}
+	}
+
+	// turn the counts into offsets, then fill the lists
+	GLuint offset = 0;
+	for (int cluster = 0; cluster < CLUSTER_COUNT; cluster++)
+	{
+		ranges[cluster].offset = offset;
+		offset += ranges[cluster].count;
+		ranges[cluster].count = 0;
+	}
+	m_lightIndices.resize(offset);
+
+	for (size_t i = 0; i < m_lightCount; i++)
+	{
+		if (m_clusterMinimum[i].x < 0)
+		{
+			continue;
+		}
+
+		for (int z = m_clusterMinimum[i].z; z <= m_clusterMaximum[i].z; z++)
+		{
+			for (int y = m_clusterMinimum[i].y; y <= m_clusterMaximum[i].y; y++)
+			{
+				CLUSTER_RANGE* row = ranges + (z * CLUSTER_COUNT_Y + y) * CLUSTER_COUNT_X;
+				for (int x = m_clusterMinimum[i].x; x <= m_clusterMaximum[i].x; x++)
+				{
+					m_lightIndices[row[x].offset + row[x].count++] = (GLuint)(m_firstLight + i);
+				}
+			}
+		}
+	}
+
+	UploadBuffer(m_clusterBuffer, m_clusterCapacity, m_clusterData.data(), m_clusterData.size());
+	if (!m_lightIndices.empty())
+	{
+		UploadBuffer(m_indexBuffer, m_indexCapacity, m_lightIndices.data(), sizeof(GLuint) * m_lightIndices.size());
+	}
+
+	Bind();
+
+	return(visibleCount);
+}
+
+/***********************************************************
+ *  UploadBuffer()
+ *
+ *  This method is used for replacing the storage of a
+ *  buffer and filling it with the passed in data.  The
+ *  capacity grows by doubling, so it settles after a few
+ *  frames.
+ ***********************************************************/
+void LightClusters::UploadBuffer(GLuint& buffer, size_t& capacity, const void* data, size_t size)
+{
+	if (buffer == 0)
+	{
+		glCreateBuffers(1, &buffer);
+		capacity = MIN_BUFFER_CAPACITY;
+	}
+	while (capacity < size)
+	{
+		capacity *= 2;
+	}
+
+	glNamedBufferData(buffer, capacity, NULL, GL_STREAM_DRAW);
+	glNamedBufferSubData(buffer, 0, size, data);
+}
+
+/***********************************************************
+ *  Bind()
+ *
+ *  This method is used for binding the cluster and light
+ *  index buffers to their fixed binding points.
+ ***********************************************************/
+void LightClusters::Bind()
+{
+	if (m_clusterBuffer != 0)
+	{
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CLUSTER_BUFFER_BINDING, m_clusterBuffer);
+	}
+	if (m_indexBuffer != 0)
+	{
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CLUSTER_INDEX_BUFFER_BINDING, m_indexBuffer);
+	}
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for freeing the buffers.
+ ***********************************************************/
+void LightClusters::Destroy()
+{
+	if (m_clusterBuffer != 0)
+	{
+		glDeleteBuffers(1, &m_clusterBuffer);
+	}
+	if (m_indexBuffer != 0)
+	{
+		glDeleteBuffers(1, &m_indexBuffer);
+	}
+
+	m_clusterBuffer = 0;
+	m_indexBuffer = 0;
+	m_clusterCapacity = 0;
+	m_indexCapacity = 0;
+}
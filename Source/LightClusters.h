@@ -0,0 +1,146 @@
+///////////////////////////////////////////////////////////////////////////////
+// lightclusters.h
+// ============
+// assign the scene point lights to the view frustum clusters they reach
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "LightManager.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  LightClusters
+ *
+ *  This class splits the view frustum into a grid of
+ *  clusters, tiles across the screen and slices in depth,
+ *  and lists for each cluster the point lights whose sphere
+ *  of influence reaches it.  The fragment shader finds the
+ *  cluster of its pixel and only lights it with that list,
+ *  so the cost per fragment follows the number of nearby
+ *  lights instead of the number of lights in the scene.
+ *
+ *  The depth slices are spaced exponentially between the
+ *  near and far planes, so the clusters stay roughly cube
+ *  shaped at every distance.  The lists are built on the
+ *  CPU every frame: the light centers are moved into view
+ *  space in straight loops over one array per component,
+ *  which the compiler turns into SIMD code, then each light
+ *  marks the block of clusters its bounding box covers.
+ *
+ *  The lights themselves are kept by the LightManager, and
+ *  the lists hold indices into its array.  Only the lights
+ *  with a radius are listed, the others reach everywhere.
+ *
+ *  Shader storage buffers, read by the fragment shader:
+ *    CLUSTER_BUFFER_BINDING        grid size, depth slicing
+ *                                  and one CLUSTER_RANGE per
+ *                                  cluster
+ *    CLUSTER_INDEX_BUFFER_BINDING  the light index lists
+ ***********************************************************/
+class LightClusters
+{
+public:
+	// constructor
+	LightClusters();
+	// destructor
+	~LightClusters();
+
+	// size of the cluster grid
+	static const int CLUSTER_COUNT_X = 16;
+	static const int CLUSTER_COUNT_Y = 12;
+	static const int CLUSTER_COUNT_Z = 24;
+	static const int CLUSTER_COUNT = CLUSTER_COUNT_X * CLUSTER_COUNT_Y * CLUSTER_COUNT_Z;
+
+	// first light index and light count of one cluster
+	struct CLUSTER_RANGE
+	{
+		GLuint offset;
+		GLuint count;
+	};
+
+	// assign the lights with a radius to the clusters of the
+	// passed in view and upload the lists, returning the
+	// number of lights that reach at least one cluster
+	int Build(
+		const LightManager& lights,
+		const glm::mat4& view,
+		const glm::mat4& projection);
+	// bind the buffers to their shader storage binding points
+	void Bind();
+	// free the buffers
+	void Destroy();
+
+	// get the number of lights with a radius
+	int GetLightCount() const { return((int)m_lightCount); }
+	// get the number of light indices in the cluster lists
+	size_t GetIndexCount() const { return(m_lightIndices.size()); }
+
+private:
+	// values at the start of the ClusterBlock
+	struct CLUSTER_HEADER
+	{
+		// cluster counts along X, Y and Z, then the light count
+		GLuint gridSize[4];
+		// near and far depth, then the scale and bias turning
+		// the log of a view depth into a slice index
+		float depthSlicing[4];
+	};
+
+	// copy the centers and radii of the lights with a radius
+	void GatherLights(const LightManager& lights);
+	// get the depth slice holding the passed in view depth
+	int GetSlice(float viewDepth) const;
+	// find the block of clusters a light may reach, false if
+	// it reaches none
+	bool GetClusterBounds(
+		size_t light,
+		const glm::mat4& projection,
+		glm::ivec3& minimum,
+		glm::ivec3& maximum) const;
+	// upload the data into a buffer, growing it when needed
+	static void UploadBuffer(GLuint& buffer, size_t& capacity, const void* data, size_t size);
+
+	// number of lights with a radius, the index of the first
+	// one in the light array, and the version of the light
+	// values last gathered
+	size_t m_lightCount;
+	size_t m_firstLight;
+	unsigned int m_lightVersion;
+	// world-space light centers and radii, one array per value
+	std::vector<float> m_positionX;
+	std::vector<float> m_positionY;
+	std::vector<float> m_positionZ;
+	std::vector<float> m_radius;
+	// view-space light centers of the current frame
+	std::vector<float> m_viewX;
+	std::vector<float> m_viewY;
+	std::vector<float> m_viewZ;
+	// block of clusters each light reaches, -1 when none
+	std::vector<glm::ivec3> m_clusterMinimum;
+	std::vector<glm::ivec3> m_clusterMaximum;
+
+	// depth range of the clusters and the slice mapping
+	float m_nearDepth;
+	float m_farDepth;
+	float m_sliceScale;
+	float m_sliceBias;
+
+	// cluster ranges after the header, and the light lists
+	std::vector<unsigned char> m_clusterData;
+	std::vector<GLuint> m_lightIndices;
+
+	// shader storage buffers and their sizes in bytes
+	GLuint m_clusterBuffer;
+	GLuint m_indexBuffer;
+	size_t m_clusterCapacity;
+	size_t m_indexCapacity;
+};
@@ -0,0 +1,297 @@
+///////////////////////////////////////////////////////////////////////////////
+// lightmanager.cpp
+// ============
+// keep the scene lights in a shader storage buffer, uploading only changes
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "LightManager.h"
+#include "ShaderBindings.h"
+
+#include <algorithm>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	const char* g_LightBlockName = "LightBlock";
+
+	// smallest number of lights the buffer is created for
+	const size_t MIN_LIGHT_CAPACITY = 16;
+}
+
+static_assert(sizeof(LightManager::GPU_LIGHT) == 64,
+	"GPU_LIGHT must match the std430 layout of the shader Light struct");
+
+/***********************************************************
+ *  LightManager()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+LightManager::LightManager()
+{
+	m_globalLightCount = 0;
+	m_bHeaderDirty = true;
+	m_version = 0;
+	m_bufferID = 0;
+	m_lightCapacity = 0;
+}
+
+/***********************************************************
+ *  ~LightManager()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+LightManager::~LightManager()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  AttachProgram()
+ *
+ *  This method is used for checking whether the passed in
+ *  shader program declares the LightBlock.  If it does, the
+ *  block is connected to the fixed binding point and true
+ *  is returned.
+ ***********************************************************/
+bool LightManager::AttachProgram(GLuint programID)
+{
+	GLuint blockIndex = glGetProgramResourceIndex(programID, GL_SHADER_STORAGE_BLOCK, g_LightBlockName);
+	if (blockIndex == GL_INVALID_INDEX)
+	{
+		return false;
+	}
+
+	glShaderStorageBlockBinding(programID, blockIndex, LIGHT_BUFFER_BINDING);
+
+	return true;
+}
+
+/***********************************************************
+ *  AddLight()
+ *
+ *  This method is used for adding a light at the end of the
+ *  light array.  A light without a radius is refused once a
+ *  light with a radius has been added, since the shader
+ *  expects those lights first.
+ ***********************************************************/
+int LightManager::AddLight(const GPU_LIGHT& light)
+{
+	bool bGlobal = (light.radius <= 0.0f);
+	if (bGlobal && (m_globalLightCount < (int)m_lights.size()))
+	{
+		std::cout << "Lights without a radius must be added before the other lights" << std::endl;
+		return -1;
+	}
+
+	int lightIndex = (int)m_lights.size();
+	m_lights.push_back(light);
+	m_bLightDirty.push_back(false);
+	if (bGlobal)
+	{
+		m_globalLightCount++;
+	}
+
+	MarkDirty(lightIndex);
+	m_bHeaderDirty = true;
+
+	return(lightIndex);
+}
+
+/***********************************************************
+ *  SetLight()
+ *
+ *  This method is used for replacing the values of a light.
+ *  A light keeps reaching the whole scene, or keeps having
+ *  a radius, so its place in the array stays valid.
+ ***********************************************************/
+void LightManager::SetLight(int lightIndex, const GPU_LIGHT& light)
+{
+	if ((lightIndex < 0) || (lightIndex >= (int)m_lights.size()))
+	{
+		return;
+	}
+
+	bool bGlobal = (lightIndex < m_globalLightCount);
+	if (bGlobal != (light.radius <= 0.0f))
+	{
+		std::cout << "Light " << lightIndex << " cannot gain or lose its radius" << std::endl;
+		return;
+	}
+
+	m_lights[lightIndex] = light;
+	MarkDirty(lightIndex);
+}
+
+/***********************************************************
+ *  SetLightPosition()
+ *
+ *  This method is used for moving a light.
+ ***********************************************************/
+void LightManager::SetLightPosition(int lightIndex, const glm::vec3& position)
+{
+	if ((lightIndex < 0) || (lightIndex >= (int)m_lights.size()))
+	{
+		return;
+	}
+
+	m_lights[lightIndex].position = position;
+	MarkDirty(lightIndex);
+}
+
+/***********************************************************
+ *  MarkDirty()
+ *
+ *  This method is used for listing a light for the next
+ *  upload.  A light changed several times in one frame is
+ *  listed once.
+ ***********************************************************/
+void LightManager::MarkDirty(int lightIndex)
+{
+	if (m_bLightDirty[lightIndex] == false)
+	{
+		m_bLightDirty[lightIndex] = true;
+		m_dirtyLights.push_back(lightIndex);
+	}
+	m_version++;
+}
+
+/***********************************************************
+ *  CreateBuffer()
+ *
+ *  This method is used for creating the buffer with room
+ *  for the passed in number of lights.  Every light is then
+ *  listed for upload, since the new storage is empty.
+ ***********************************************************/
+void LightManager::CreateBuffer(size_t lightCapacity)
+{
+	if (m_bufferID != 0)
+	{
+		glDeleteBuffers(1, &m_bufferID);
+	}
+
+	m_lightCapacity = lightCapacity;
+	glCreateBuffers(1, &m_bufferID);
+	glNamedBufferStorage(
+		m_bufferID,
+		sizeof(LIGHT_HEADER) + sizeof(GPU_LIGHT) * m_lightCapacity,
+		NULL,
+		GL_DYNAMIC_STORAGE_BIT);
+
+	for (size_t i = 0; i < m_lights.size(); i++)
+	{
+		MarkDirty((int)i);
+	}
+	m_bHeaderDirty = true;
+
+	Bind();
+}
+
+/***********************************************************
+ *  Upload()
+ *
+ *  This method is used for sending the lights changed since
+ *  the last upload to the buffer.  The changed indices are
+ *  sorted and each run of neighbouring lights is sent with
+ *  one call, so a few moving lights never resend the whole
+ *  array.  Nothing is sent when no light has changed.
+ ***********************************************************/
+size_t LightManager::Upload()
+{
+	if ((m_bufferID == 0) || (m_lights.size() > m_lightCapacity))
+	{
+		size_t capacity = std::max(m_lightCapacity, MIN_LIGHT_CAPACITY);
+		while (capacity < m_lights.size())
+		{
+			capacity *= 2;
+		}
+		CreateBuffer(capacity);
+	}
+
+	size_t uploadedBytes = 0;
+	if (m_bHeaderDirty)
+	{
+		LIGHT_HEADER header;
+		header.lightCounts[0] = (GLuint)m_globalLightCount;
+		header.lightCounts[1] = (GLuint)m_lights.size();
+		header.lightCounts[2] = 0;
+		header.lightCounts[3] = 0;
+		glNamedBufferSubData(m_bufferID, 0, sizeof(header), &header);
+		uploadedBytes += sizeof(header);
+		m_bHeaderDirty = false;
+	}
+
+	if (m_dirtyLights.empty())
+	{
+		return(uploadedBytes);
+	}
+
+	std::sort(m_dirtyLights.begin(), m_dirtyLights.end());
+	size_t runStart = 0;
+	for (size_t i = 1; i <= m_dirtyLights.size(); i++)
+	{
+		// send the run when the next light does not follow it
+		if ((i < m_dirtyLights.size()) && (m_dirtyLights[i] == m_dirtyLights[i - 1] + 1))
+		{
+			continue;
+		}
+
+		int firstLight = m_dirtyLights[runStart];
+		size_t size = sizeof(GPU_LIGHT) * (i - runStart);
+		glNamedBufferSubData(
+			m_bufferID,
+			sizeof(LIGHT_HEADER) + sizeof(GPU_LIGHT) * firstLight,
+			size,
+			&m_lights[firstLight]);
+		uploadedBytes += size;
+		runStart = i;
+	}
+
+	for (size_t i = 0; i < m_dirtyLights.size(); i++)
+	{
+		m_bLightDirty[m_dirtyLights[i]] = false;
+	}
+	m_dirtyLights.clear();
+
+	return(uploadedBytes);
+}
+
+/***********************************************************
+ *  Bind()
+ *
+ *  This method is used for binding the buffer to the
+ *  LightBlock binding point.
+ ***********************************************************/
+void LightManager::Bind()
+{
+	if (m_bufferID != 0)
+	{
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, LIGHT_BUFFER_BINDING, m_bufferID);
+	}
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for freeing the buffer and removing
+ *  all the lights.
+ ***********************************************************/
+void LightManager::Destroy()
+{
+	if (m_bufferID != 0)
+	{
+		glDeleteBuffers(1, &m_bufferID);
+		m_bufferID = 0;
+	}
+	m_lightCapacity = 0;
+
+	m_lights.clear();
+	m_globalLightCount = 0;
+	m_dirtyLights.clear();
+	m_bLightDirty.clear();
+	m_bHeaderDirty = true;
+	m_version++;
+}
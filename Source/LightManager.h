@@ -0,0 +1,116 @@
+///////////////////////////////////////////////////////////////////////////////
+// lightmanager.h
+// ============
+// keep the scene lights in a shader storage buffer, uploading only changes
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  LightManager
+ *
+ *  This class holds every light of the scene, both on the
+ *  CPU and in one std430 shader storage buffer bound to the
+ *  LightBlock of the fragment shader.  Changing a light only
+ *  marks it as changed; the next upload sends the changed
+ *  lights alone, merging neighbours into one range, so a
+ *  moving light costs its own 64 bytes per frame and static
+ *  lights cost nothing.
+ *
+ *  Lights without a radius reach the whole scene and light
+ *  every fragment.  They must be added before the lights
+ *  with a radius, which are only read through the cluster
+ *  light lists, so the shader finds them at the start of
+ *  the array.
+ ***********************************************************/
+class LightManager
+{
+public:
+	// constructor
+	LightManager();
+	// destructor
+	~LightManager();
+
+	// one light in the std430 layout of the LightBlock, each
+	// vec3 is followed by a float to fill its 16 bytes
+	struct GPU_LIGHT
+	{
+		glm::vec3 position;
+		// distance at which the light has faded out, 0 for a
+		// light that reaches the whole scene without fading
+		float radius;
+		glm::vec3 ambientColor;
+		float focalStrength;
+		glm::vec3 diffuseColor;
+		float specularIntensity;
+		glm::vec3 specularColor;
+		float padding;
+	};
+
+	// check whether the shader program declares the LightBlock
+	// and connect the block to its binding point
+	bool AttachProgram(GLuint programID);
+	// add a light, returning its index or -1 on failure
+	int AddLight(const GPU_LIGHT& light);
+	// replace all the values of a light
+	void SetLight(int lightIndex, const GPU_LIGHT& light);
+	// move a light
+	void SetLightPosition(int lightIndex, const glm::vec3& position);
+	// send the changed lights to the shader storage buffer,
+	// returning the number of bytes uploaded
+	size_t Upload();
+	// bind the buffer to the LightBlock binding point
+	void Bind();
+	// free the buffer and forget the lights
+	void Destroy();
+
+	// get a light by index
+	const GPU_LIGHT& GetLight(int lightIndex) const { return(m_lights[lightIndex]); }
+	// get the number of lights
+	int GetLightCount() const { return((int)m_lights.size()); }
+	// get the number of lights that reach the whole scene
+	int GetGlobalLightCount() const { return(m_globalLightCount); }
+	// get a number that changes whenever a light is added or
+	// changed, so users of the light values know to reread them
+	unsigned int GetVersion() const { return(m_version); }
+
+private:
+	// values at the start of the LightBlock
+	struct LIGHT_HEADER
+	{
+		// lights reaching the whole scene, all the lights,
+		// then padding to 16 bytes
+		GLuint lightCounts[4];
+	};
+
+	// mark a light as changed since the last upload
+	void MarkDirty(int lightIndex);
+	// create the buffer with room for the passed in lights
+	void CreateBuffer(size_t lightCapacity);
+
+	// values of all the lights, in buffer order
+	std::vector<GPU_LIGHT> m_lights;
+	// number of leading lights without a radius
+	int m_globalLightCount;
+	// indices of the lights changed since the last upload,
+	// and a flag per light so each is listed once
+	std::vector<int> m_dirtyLights;
+	std::vector<bool> m_bLightDirty;
+	// true when the light counts must be uploaded
+	bool m_bHeaderDirty;
+	// changes whenever a light is added or changed
+	unsigned int m_version;
+
+	// OpenGL shader storage buffer object
+	GLuint m_bufferID;
+	// number of lights the buffer has room for
+	size_t m_lightCapacity;
+};
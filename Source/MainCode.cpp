@@ -1,5 +1,9 @@
 #include <iostream>         // error handling and output
 #include <cstdlib>          // EXIT_FAILURE
+#include <cstring>          // strcmp
+#include <string>
+#include <vector>
+#include <algorithm>
 
 #include <GL/glew.h>        // GLEW library
 #include "GLFW/glfw3.h"     // GLFW library
@@ -13,6 +17,9 @@
 #include "ViewManager.h"
 #include "ShapeMeshes.h"
 #include "ShaderManager.h"
+#include "UniformCache.h"
+#include "OffscreenTarget.h"
+#include "FrameBenchmark.h"
 
 // Namespace for declaring global variables
 namespace
@@ -27,12 +34,53 @@ namespace
 	SceneManager* g_SceneManager = nullptr;
 	// shader manager object for dynamic interaction with the shader code
 	ShaderManager* g_ShaderManager = nullptr;
+	// shader manager object holding the depth only shadow program
+	ShaderManager* g_ShadowShaderManager = nullptr;
+	// shader manager object holding the depth pre-pass program
+	ShaderManager* g_DepthShaderManager = nullptr;
+	// uniform cache object holding the resolved shader uniform locations
+	UniformCache* g_UniformCache = nullptr;
 	// view manager object for managing the 3D view setup and projection to 2D
 	ViewManager* g_ViewManager = nullptr;
+	// offscreen framebuffer used when rendering without a display
+	OffscreenTarget* g_OffscreenTarget = nullptr;
+	// frame benchmark object for replaying the scripted camera path
+	FrameBenchmark* g_FrameBenchmark = nullptr;
+
+	// command line options for headless rendering
+	bool g_bHeadless = false;
+	int g_HeadlessFrameCount = 300;
+	std::vector<int> g_CaptureFrames;
+	std::string g_CaptureDirectory = ".";
+
+	// command line options for the frame benchmark
+	int g_BenchmarkFrameCount = 0;
+	int g_BenchmarkWarmupCount = 60;
+	std::string g_BenchmarkReport;
+
+	// scene file to load instead of the default desk scene
+	std::string g_SceneFile;
+	// false to draw the scene in batches instead of with
+	// multi-draw indirect calls
+	bool g_bIndirectDraws = true;
+	// true to store the meshes in the compact vertex layout
+	bool g_bCompactVertices = false;
+	// false to generate the shape meshes instead of loading
+	// them from the mesh cache file
+	bool g_bMeshCache = true;
+	// false to draw every object into the shadow maps each
+	// frame instead of caching the static objects
+	bool g_bShadowCache = true;
+	// true to draw the depth of the opaque objects before the
+	// scene, so each pixel is only shaded once
+	bool g_bDepthPrepass = false;
+	// true to draw the number of fragments shaded at each pixel
+	bool g_bOverdraw = false;
 }
 
 // Function declarations - all functions that are called manually
 // need to be pre-declared at the beginning of the source code.
+bool ParseCommandLine(int argc, char* argv[]);
 bool InitializeGLFW();
 bool InitializeGLEW();
 
@@ -45,6 +93,12 @@ bool InitializeGLEW();
  ***********************************************************/
 int main(int argc, char* argv[])
 {
+	// if the command line options are not valid, then terminate the application
+	if (ParseCommandLine(argc, argv) == false)
+	{
+		return(EXIT_FAILURE);
+	}
+
 	// if GLFW fails initialization, then terminate the application
 	if (InitializeGLFW() == false)
 	{
@@ -53,12 +107,27 @@ int main(int argc, char* argv[])
 
 	// try to create a new shader manager object
 	g_ShaderManager = new ShaderManager();
+	// try to create a new uniform cache object
+	g_UniformCache = new UniformCache();
 	// try to create a new view manager object
 	g_ViewManager = new ViewManager(
-		g_ShaderManager);
+		g_ShaderManager,
+		g_UniformCache);
 
-	// try to create the main display window
-	g_Window = g_ViewManager->CreateDisplayWindow(WINDOW_TITLE);
+	// try to create the main display window, or only a hidden
+	// context window when rendering headless
+	if (g_bHeadless)
+	{
+		g_Window = g_ViewManager->CreateOffscreenWindow(WINDOW_TITLE);
+	}
+	else
+	{
+		g_Window = g_ViewManager->CreateDisplayWindow(WINDOW_TITLE);
+	}
+	if (g_Window == NULL)
+	{
+		return(EXIT_FAILURE);
+	}
 
 	// if GLEW fails initialization, then terminate the application
 	if (InitializeGLEW() == false)
@@ -66,20 +135,121 @@ int main(int argc, char* argv[])
 		return(EXIT_FAILURE);
 	}
 
+	// when rendering headless, all the frames are drawn into
+	// an offscreen framebuffer instead of the window surface
+	if (g_bHeadless)
+	{
+		g_OffscreenTarget = new OffscreenTarget();
+		if (g_OffscreenTarget->Create(
+			g_ViewManager->GetViewportWidth(),
+			g_ViewManager->GetViewportHeight()) == false)
+		{
+			return(EXIT_FAILURE);
+		}
+		if (!g_CaptureFrames.empty() &&
+			(OffscreenTarget::CreateCaptureDirectory(g_CaptureDirectory) == false))
+		{
+			return(EXIT_FAILURE);
+		}
+	}
+
 	// load the shader code from the external GLSL files
 	g_ShaderManager->LoadShaders(
-		"../../Utilities/shaders/vertexShader.glsl",
-		"../../Utilities/shaders/fragmentShader.glsl");
+		"Shaders/vertexShader.glsl",
+		"Shaders/fragmentShader.glsl");
+	g_ShaderManager->use();
+
+	// resolve the uniform locations of the linked shader program
+	// once, so they are never looked up by name while rendering
+	GLint programID = 0;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &programID);
+	g_UniformCache->ResolveLocations(programID);
+	// the camera values of each frame are shared with the shader
+	// through a uniform buffer when it declares the camera block
+	if (g_ViewManager->AttachCameraBlock(programID) == false)
+	{
+		std::cout << "INFO: The shader does not declare the camera block" << std::endl;
+	}
+
+	// load the depth only program the shadow maps are drawn
+	// with, then make the scene program current again
+	g_ShadowShaderManager = new ShaderManager();
+	GLuint shadowProgramID = g_ShadowShaderManager->LoadShaders(
+		"Shaders/shadowVertexShader.glsl",
+		"Shaders/shadowFragmentShader.glsl");
+	// the depth pre-pass program reads the camera block too
+	GLuint depthProgramID = 0;
+	if (g_bDepthPrepass)
+	{
+		g_DepthShaderManager = new ShaderManager();
+		depthProgramID = g_DepthShaderManager->LoadShaders(
+			"Shaders/depthVertexShader.glsl",
+			"Shaders/depthFragmentShader.glsl");
+		g_ViewManager->AttachCameraBlock(depthProgramID);
+	}
 	g_ShaderManager->use();
 
 	// try to create a new scene manager object and prepare the 3D scene
-	g_SceneManager = new SceneManager(g_ShaderManager);
-	g_SceneManager->PrepareScene();
+	g_SceneManager = new SceneManager(g_ShaderManager, g_UniformCache);
+	if (!g_SceneFile.empty())
+	{
+		g_SceneManager->SetSceneFile(g_SceneFile);
+	}
+	g_SceneManager->SetIndirectDraws(g_bIndirectDraws);
+	g_SceneManager->SetCompactVertices(g_bCompactVertices);
+	g_SceneManager->SetShadowProgram(shadowProgramID);
+	g_SceneManager->SetShadowCache(g_bShadowCache);
+	g_SceneManager->SetDepthPrepassProgram(depthProgramID);
+	g_SceneManager->SetOverdrawView(g_bOverdraw);
+	if (!g_bMeshCache)
+	{
+		g_SceneManager->SetMeshCacheFile("");
+	}
+	// a captured or measured run of a broken scene would report
+	// on the wrong objects, so it is stopped
+	if ((g_SceneManager->PrepareScene() == false) && (g_bHeadless || (g_BenchmarkFrameCount > 0)))
+	{
+		return(EXIT_FAILURE);
+	}
+
+	// the textures are decoded in the background while the first
+	// frames are drawn, but captured and measured frames must all
+	// show the final textures
+	if (g_bHeadless || (g_BenchmarkFrameCount > 0))
+	{
+		g_SceneManager->FinishTextureLoading();
+	}
+
+	// try to create the frame benchmark when it was requested - the
+	// swap interval is disabled so the display does not limit timings
+	if (g_BenchmarkFrameCount > 0)
+	{
+		glfwSwapInterval(0);
+		g_FrameBenchmark = new FrameBenchmark(
+			g_ViewManager,
+			g_BenchmarkFrameCount,
+			g_BenchmarkWarmupCount);
+	}
+
+	int frameIndex = 0;
+	double startTime = glfwGetTime();
 
 	// loop will keep running until the application is closed 
 	// or until an error has occurred
 	while (!glfwWindowShouldClose(g_Window))
 	{
+		// direct the frame into the offscreen framebuffer
+		if (NULL != g_OffscreenTarget)
+		{
+			g_OffscreenTarget->Bind();
+		}
+
+		// move the camera along the scripted path and start timing
+		if (NULL != g_FrameBenchmark)
+		{
+			g_FrameBenchmark->BeginFrame(frameIndex);
+		}
+
 		// Enable z-depth
 		glEnable(GL_DEPTH_TEST);
 
@@ -89,19 +259,80 @@ int main(int argc, char* argv[])
 
 		// convert from 3D object space to 2D view
 		g_ViewManager->PrepareSceneView();
+		g_SceneManager->SetViewTransforms(
+			g_ViewManager->GetViewMatrix(),
+			g_ViewManager->GetProjectionMatrix());
 
 		// refresh the 3D scene
 		g_SceneManager->RenderScene();
 
+		if (NULL != g_FrameBenchmark)
+		{
+			g_FrameBenchmark->EndFrame();
+			g_FrameBenchmark->RecordRenderStats(g_SceneManager->GetRenderStats());
+		}
+
+		if (g_bHeadless)
+		{
+			// save the frame if it was requested for capture
+			if (std::find(g_CaptureFrames.begin(), g_CaptureFrames.end(), frameIndex) != g_CaptureFrames.end())
+			{
+				g_OffscreenTarget->SaveFramePPM(
+					g_CaptureDirectory + "/frame_" + std::to_string(frameIndex) + ".ppm");
+			}
+		}
+		else
+		{
+			// Flips the the back buffer with the front buffer every frame.
+			glfwSwapBuffers(g_Window);
+		}
 
-		// Flips the the back buffer with the front buffer every frame.
-		glfwSwapBuffers(g_Window);
+		// stop after the requested number of frames, or when the
+		// benchmark camera path has been completed
+		frameIndex++;
+		if (NULL != g_FrameBenchmark)
+		{
+			if (g_FrameBenchmark->IsComplete())
+			{
+				glfwSetWindowShouldClose(g_Window, true);
+			}
+		}
+		else if (g_bHeadless && (frameIndex >= g_HeadlessFrameCount))
+		{
+			glfwSetWindowShouldClose(g_Window, true);
+		}
 
 		// query the latest GLFW events
 		glfwPollEvents();
 	}
 
+	// write the benchmark report
+	if (NULL != g_FrameBenchmark)
+	{
+		g_FrameBenchmark->WriteReport(g_BenchmarkReport);
+		delete g_FrameBenchmark;
+		g_FrameBenchmark = NULL;
+	}
+	// report the headless rendering throughput
+	else if (g_bHeadless)
+	{
+		// wait for all queued rendering to complete before timing
+		glFinish();
+		double elapsedTime = glfwGetTime() - startTime;
+		std::cout << "INFO: Rendered " << frameIndex << " frames in " << elapsedTime << " seconds";
+		if (elapsedTime > 0.0)
+		{
+			std::cout << " (" << frameIndex / elapsedTime << " FPS)";
+		}
+		std::cout << std::endl;
+	}
+
 	// clear the allocated manager objects from memory
+	if (NULL != g_OffscreenTarget)
+	{
+		delete g_OffscreenTarget;
+		g_OffscreenTarget = NULL;
+	}
 	if (NULL != g_SceneManager)
 	{
 		delete g_SceneManager;
@@ -112,6 +343,21 @@ int main(int argc, char* argv[])
 		delete g_ViewManager;
 		g_ViewManager = NULL;
 	}
+	if (NULL != g_UniformCache)
+	{
+		delete g_UniformCache;
+		g_UniformCache = NULL;
+	}
+	if (NULL != g_DepthShaderManager)
+	{
+		delete g_DepthShaderManager;
+		g_DepthShaderManager = NULL;
+	}
+	if (NULL != g_ShadowShaderManager)
+	{
+		delete g_ShadowShaderManager;
+		g_ShadowShaderManager = NULL;
+	}
 	if (NULL != g_ShaderManager)
 	{
 		delete g_ShaderManager;
@@ -122,6 +368,121 @@ int main(int argc, char* argv[])
 	exit(EXIT_SUCCESS); 
 }
 
+/***********************************************************
+ *	ParseCommandLine()
+ *
+ *  This function is used to read the command line options.
+ *
+ *    --headless          render into an offscreen framebuffer
+ *    --frames N          number of frames to render headless
+ *    --capture N         save frame N as a PPM image, can be
+ *                        passed more than once
+ *    --capture-dir PATH  folder for the captured images
+ *    --benchmark N       replay the scripted camera path and
+ *                        measure N frames
+ *    --benchmark-warmup N  frames rendered before measuring
+ *    --benchmark-out PATH  JSON report file, the report is
+ *                        written to the console if not passed
+ *    --scene PATH        scene file describing the objects
+ *    --no-indirect       draw the scene in batches instead of
+ *                        with multi-draw indirect calls
+ *    --compact-vertices  store the meshes in the compact
+ *                        vertex layout
+ *    --no-mesh-cache     generate the shape meshes instead of
+ *                        loading or saving the mesh cache file
+ *    --no-shadow-cache   draw every object into the shadow maps
+ *                        each frame
+ *    --depth-prepass     draw the depth of the opaque objects
+ *                        before shading them
+ *    --overdraw          show the shaded fragments per pixel
+ *                        instead of the lit scene
+ ***********************************************************/
+bool ParseCommandLine(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; i++)
+	{
+		bool bHasValue = (i + 1 < argc);
+
+		if (strcmp(argv[i], "--headless") == 0)
+		{
+			g_bHeadless = true;
+		}
+		else if ((strcmp(argv[i], "--frames") == 0) && bHasValue)
+		{
+			g_HeadlessFrameCount = atoi(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--capture") == 0) && bHasValue)
+		{
+			g_CaptureFrames.push_back(atoi(argv[++i]));
+		}
+		else if ((strcmp(argv[i], "--capture-dir") == 0) && bHasValue)
+		{
+			g_CaptureDirectory = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--benchmark") == 0) && bHasValue)
+		{
+			g_BenchmarkFrameCount = atoi(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--benchmark-warmup") == 0) && bHasValue)
+		{
+			g_BenchmarkWarmupCount = atoi(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--benchmark-out") == 0) && bHasValue)
+		{
+			g_BenchmarkReport = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--scene") == 0) && bHasValue)
+		{
+			g_SceneFile = argv[++i];
+		}
+		else if (strcmp(argv[i], "--no-indirect") == 0)
+		{
+			g_bIndirectDraws = false;
+		}
+		else if (strcmp(argv[i], "--compact-vertices") == 0)
+		{
+			g_bCompactVertices = true;
+		}
+		else if (strcmp(argv[i], "--no-mesh-cache") == 0)
+		{
+			g_bMeshCache = false;
+		}
+		else if (strcmp(argv[i], "--no-shadow-cache") == 0)
+		{
+			g_bShadowCache = false;
+		}
+		else if (strcmp(argv[i], "--depth-prepass") == 0)
+		{
+			g_bDepthPrepass = true;
+		}
+		else if (strcmp(argv[i], "--overdraw") == 0)
+		{
+			g_bOverdraw = true;
+		}
+		else
+		{
+			std::cerr << "Unknown or incomplete option: " << argv[i] << "\n"
+				<< "Usage: " << argv[0] << " [--headless] [--frames N] [--capture N] [--capture-dir PATH]"
+				<< " [--benchmark N] [--benchmark-warmup N] [--benchmark-out PATH] [--scene PATH] [--no-indirect] [--compact-vertices] [--no-mesh-cache] [--no-shadow-cache]"
+				<< " [--depth-prepass] [--overdraw]" << std::endl;
+			return(false);
+		}
+	}
+
+	if (g_HeadlessFrameCount <= 0)
+	{
+		std::cerr << "The number of frames must be greater than zero" << std::endl;
+		return(false);
+	}
+	if ((g_BenchmarkFrameCount < 0) || (g_BenchmarkWarmupCount < 0))
+	{
+		std::cerr << "The number of benchmark frames must not be negative" << std::endl;
+		return(false);
+	}
+
+	return(true);
+}
+
 /***********************************************************
  *	InitializeGLFW()
  * 
@@ -131,7 +492,30 @@ bool InitializeGLFW()
 {
 	// GLFW: initialize and configure library
 	// --------------------------------------
-	glfwInit();
+	// when rendering headless on machines without a display or a
+	// GPU, GLFW must not connect to X11 or Wayland, so it is
+	// started on its null platform (GLFW 3.4) before initializing
+#ifndef _WIN32
+	if (g_bHeadless)
+	{
+		glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+	}
+#endif
+	if (glfwInit() == GLFW_FALSE)
+	{
+		std::cerr << "Failed to initialize GLFW" << std::endl;
+		return(false);
+	}
+
+	// the null platform has no native context, so ask GLFW for an
+	// OSMesa (Mesa llvmpipe) software context instead - this needs
+	// GLFW built with OSMesa support
+#ifndef _WIN32
+	if (g_bHeadless)
+	{
+		glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+	}
+#endif
 
 #ifdef __APPLE__
 	// set the version of OpenGL and profile to use
@@ -139,9 +523,10 @@ bool InitializeGLFW()
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
 	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 #else
-	// set the version of OpenGL and profile to use
+	// set the version of OpenGL and profile to use - Mesa llvmpipe
+	// provides up to OpenGL 4.5 for headless rendering
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, g_bHeadless ? 5 : 6);
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 #endif
 	// GLFW: end -------------------------------
@@ -160,8 +545,17 @@ bool InitializeGLEW()
 	// -----------------------------------------
 	GLenum GLEWInitResult = GLEW_OK;
 
-	// try to initialize the GLEW library
-	GLEWInitResult = glewInit();
+	// try to initialize the GLEW library - glewInit() also loads
+	// the GLX extensions, which fails when there is no X display,
+	// so headless runs only load the OpenGL entry points
+	if (g_bHeadless)
+	{
+		GLEWInitResult = glewContextInit();
+	}
+	else
+	{
+		GLEWInitResult = glewInit();
+	}
 	if (GLEW_OK != GLEWInitResult)
 	{
 		std::cerr << glewGetErrorString(GLEWInitResult) << std::endl;
@@ -0,0 +1,52 @@
+///////////////////////////////////////////////////////////////////////////////
+// mappedfile.h
+// ============
+// map a whole file into memory for reading
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/***********************************************************
+ *  MappedFile
+ *
+ *  This class maps a file read-only into the address space
+ *  of the program, so its contents can be read in place.
+ *  The pages are only loaded from disk when they are first
+ *  touched, and nothing is copied into a buffer of its own.
+ ***********************************************************/
+class MappedFile
+{
+public:
+	// constructor
+	MappedFile();
+	// destructor
+	~MappedFile();
+
+	// map the passed in file, false if it is missing or empty
+	bool Open(const std::string& filename);
+	// unmap the file
+	void Close();
+
+	bool IsOpen() const { return(m_data != NULL); }
+	// get the start and the byte size of the mapped file
+	const unsigned char* GetData() const { return(m_data); }
+	size_t GetSize() const { return(m_size); }
+
+private:
+	// MappedFile objects own a mapping and cannot be copied
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+
+	// start of the mapped file
+	const unsigned char* m_data;
+	size_t m_size;
+	// handles of the open file and its mapping
+	void* m_fileHandle;
+	void* m_mappingHandle;
+};
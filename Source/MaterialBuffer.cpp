@@ -0,0 +1,134 @@
+///////////////////////////////////////////////////////////////////////////////
+// materialbuffer.cpp
+// ============
+// pack the scene materials into a uniform buffer indexed per draw
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MaterialBuffer.h"
+#include "ShaderBindings.h"
+
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	const char* g_MaterialBlockName = "MaterialBlock";
+}
+
+static_assert(sizeof(MaterialBuffer::GPU_MATERIAL) == 48,
+	"GPU_MATERIAL must match the std140 layout of the shader Material struct");
+
+/***********************************************************
+ *  MaterialBuffer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+MaterialBuffer::MaterialBuffer()
+{
+	m_bufferID = 0;
+	m_materialCount = 0;
+}
+
+/***********************************************************
+ *  ~MaterialBuffer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+MaterialBuffer::~MaterialBuffer()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  AttachProgram()
+ *
+ *  This method is used for checking whether the passed in
+ *  shader program declares the MaterialBlock.  If it does,
+ *  the block is connected to the fixed binding point and
+ *  true is returned.  Shaders without the block keep using
+ *  the individual material uniforms.
+ ***********************************************************/
+bool MaterialBuffer::AttachProgram(GLuint programID)
+{
+	GLuint blockIndex = glGetUniformBlockIndex(programID, g_MaterialBlockName);
+	if (blockIndex == GL_INVALID_INDEX)
+	{
+		return false;
+	}
+
+	glUniformBlockBinding(programID, blockIndex, MATERIAL_BLOCK_BINDING);
+
+	return true;
+}
+
+/***********************************************************
+ *  Upload()
+ *
+ *  This method is used for uploading the passed in materials
+ *  into the uniform buffer.  The buffer always holds the
+ *  full MaterialBlock array so the whole block is backed.
+ ***********************************************************/
+bool MaterialBuffer::Upload(const std::vector<GPU_MATERIAL>& materials)
+{
+	if (materials.size() > (size_t)MAX_SCENE_MATERIALS)
+	{
+		std::cout << "Too many materials for the MaterialBlock:" << materials.size()
+			<< ", maximum:" << MAX_SCENE_MATERIALS << std::endl;
+		return false;
+	}
+
+	if (m_bufferID == 0)
+	{
+		glGenBuffers(1, &m_bufferID);
+		glBindBuffer(GL_UNIFORM_BUFFER, m_bufferID);
+		glBufferData(GL_UNIFORM_BUFFER, sizeof(GPU_MATERIAL) * MAX_SCENE_MATERIALS, NULL, GL_STATIC_DRAW);
+	}
+	else
+	{
+		glBindBuffer(GL_UNIFORM_BUFFER, m_bufferID);
+	}
+
+	if (!materials.empty())
+	{
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(GPU_MATERIAL) * materials.size(), materials.data());
+	}
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	m_materialCount = (int)materials.size();
+
+	Bind();
+
+	return true;
+}
+
+/***********************************************************
+ *  Bind()
+ *
+ *  This method is used for binding the uniform buffer to
+ *  the MaterialBlock binding point.
+ ***********************************************************/
+void MaterialBuffer::Bind()
+{
+	if (m_bufferID != 0)
+	{
+		glBindBufferBase(GL_UNIFORM_BUFFER, MATERIAL_BLOCK_BINDING, m_bufferID);
+	}
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for freeing the uniform buffer.
+ ***********************************************************/
+void MaterialBuffer::Destroy()
+{
+	if (m_bufferID != 0)
+	{
+		glDeleteBuffers(1, &m_bufferID);
+		m_bufferID = 0;
+	}
+	m_materialCount = 0;
+}
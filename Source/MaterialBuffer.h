@@ -0,0 +1,63 @@
+///////////////////////////////////////////////////////////////////////////////
+// materialbuffer.h
+// ============
+// pack the scene materials into a uniform buffer indexed per draw
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  MaterialBuffer
+ *
+ *  This class stores all the defined object materials in one
+ *  std140 uniform buffer bound to the MaterialBlock of the
+ *  shader.  The materials are uploaded one time, and each
+ *  draw then only selects its material by index.
+ ***********************************************************/
+class MaterialBuffer
+{
+public:
+	// constructor
+	MaterialBuffer();
+	// destructor
+	~MaterialBuffer();
+
+	// one material in the std140 layout of the MaterialBlock,
+	// each vec3 is followed by a float to fill its 16 bytes
+	struct GPU_MATERIAL
+	{
+		glm::vec3 ambientColor;
+		float ambientStrength;
+		glm::vec3 diffuseColor;
+		float shininess;
+		glm::vec3 specularColor;
+		float padding;
+	};
+
+	// check whether the shader program declares the MaterialBlock
+	// and connect the block to its binding point
+	bool AttachProgram(GLuint programID);
+	// upload the passed in materials into the uniform buffer
+	bool Upload(const std::vector<GPU_MATERIAL>& materials);
+	// bind the uniform buffer to the MaterialBlock binding point
+	void Bind();
+	// free the uniform buffer
+	void Destroy();
+
+	// true when the materials are uploaded and can be indexed
+	bool IsReady() const { return(m_bufferID != 0); }
+
+private:
+	// OpenGL uniform buffer object
+	GLuint m_bufferID;
+	// number of uploaded materials
+	int m_materialCount;
+};
@@ -0,0 +1,444 @@
+///////////////////////////////////////////////////////////////////////////////
+// mesharena.cpp
+// ============
+// store the geometry of all the meshes in one vertex and one index buffer
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MeshArena.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// vertex attribute locations, matching the vertex shader
+	const GLuint ATTRIBUTE_POSITION = 0;
+	const GLuint ATTRIBUTE_NORMAL = 1;
+	const GLuint ATTRIBUTE_TEXTURE_COORDINATE = 2;
+	// vertex array binding the vertex buffer is read from
+	const GLuint VERTEX_BINDING = 0;
+
+	// sizes the buffers first make room for, which hold all
+	// the basic shapes without growing
+	const size_t INITIAL_VERTEX_CAPACITY = 16384;
+	const size_t INITIAL_INDEX_CAPACITY = 65536;
+
+	/***********************************************************
+	 *  ToSnorm16()
+	 *
+	 *  This function is used for storing a value between -1
+	 *  and 1 as a signed normalized 16 bit integer.
+	 ***********************************************************/
+	GLshort ToSnorm16(float value)
+	{
+		value = std::max(-1.0f, std::min(1.0f, value));
+		return((GLshort)std::lround(value * 32767.0f));
+	}
+
+	/***********************************************************
+	 *  ToUnorm16()
+	 *
+	 *  This function is used for storing a value between 0 and
+	 *  1 as an unsigned normalized 16 bit integer.
+	 ***********************************************************/
+	GLushort ToUnorm16(float value)
+	{
+		value = std::max(0.0f, std::min(1.0f, value));
+		return((GLushort)std::lround(value * 65535.0f));
+	}
+
+	/***********************************************************
+	 *  EncodeOctahedral()
+	 *
+	 *  This function is used for mapping a unit normal onto
+	 *  the octahedron |x| + |y| + |z| = 1 and unfolding the
+	 *  lower half over the corners, which gives two values
+	 *  between -1 and 1.  The vertex shader reverses it.
+	 ***********************************************************/
+	glm::vec2 EncodeOctahedral(glm::vec3 normal)
+	{
+		normal = normal * (1.0f / (std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z)));
+
+		glm::vec2 encoded(normal.x, normal.y);
+		if (normal.z < 0.0f)
+		{
+			encoded.x = (1.0f - std::fabs(normal.y)) * ((normal.x >= 0.0f) ? 1.0f : -1.0f);
+			encoded.y = (1.0f - std::fabs(normal.x)) * ((normal.y >= 0.0f) ? 1.0f : -1.0f);
+		}
+		return(encoded);
+	}
+}
+
+/***********************************************************
+ *  MeshArena()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+MeshArena::MeshArena(StateCache* pStateCache)
+{
+	m_pStateCache = pStateCache;
+	m_format = VERTEX_FULL;
+	m_vertexSize = sizeof(ShapeGeometry::SHAPE_VERTEX);
+	m_indexType = GL_UNSIGNED_INT;
+	m_indexSize = sizeof(GLuint);
+	m_positionScale = glm::vec3(1.0f, 1.0f, 1.0f);
+	m_positionOffset = glm::vec3(0.0f, 0.0f, 0.0f);
+	m_vao = 0;
+	m_vertexBuffer = 0;
+	m_indexBuffer = 0;
+	m_vertexCount = 0;
+	m_vertexCapacity = 0;
+	m_indexCount = 0;
+	m_indexCapacity = 0;
+}
+
+/***********************************************************
+ *  ~MeshArena()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+MeshArena::~MeshArena()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  SetVertexFormat()
+ *
+ *  This method is used for choosing the layout the vertices
+ *  and indices are stored in.  The layout is fixed once the
+ *  first mesh is added.  In the compact layout, the stored
+ *  positions run from -1 to 1 across the passed in box, so
+ *  all the meshes must fit in it.
+ ***********************************************************/
+void MeshArena::SetVertexFormat(
+	VERTEX_FORMAT format,
+	const glm::vec3& boxCenter,
+	const glm::vec3& boxExtent)
+{
+	if (m_vao != 0)
+	{
+		std::cout << "The vertex format cannot change after meshes are added" << std::endl;
+		return;
+	}
+
+	m_format = format;
+	if (format == VERTEX_COMPACT)
+	{
+		m_vertexSize = sizeof(COMPACT_VERTEX);
+		m_indexType = GL_UNSIGNED_SHORT;
+		m_indexSize = sizeof(GLushort);
+		m_positionScale = glm::max(boxExtent, glm::vec3(1e-6f, 1e-6f, 1e-6f));
+		m_positionOffset = boxCenter;
+	}
+	else
+	{
+		m_vertexSize = sizeof(ShapeGeometry::SHAPE_VERTEX);
+		m_indexType = GL_UNSIGNED_INT;
+		m_indexSize = sizeof(GLuint);
+		m_positionScale = glm::vec3(1.0f, 1.0f, 1.0f);
+		m_positionOffset = glm::vec3(0.0f, 0.0f, 0.0f);
+	}
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for creating the vertex array and
+ *  the shared buffers.  The vertex format is stored apart
+ *  from the buffers, so a grown buffer is attached again
+ *  without setting up the attributes.
+ ***********************************************************/
+void MeshArena::Create()
+{
+	glCreateVertexArrays(1, &m_vao);
+
+	m_vertexCapacity = INITIAL_VERTEX_CAPACITY;
+	glCreateBuffers(1, &m_vertexBuffer);
+	glNamedBufferData(m_vertexBuffer, (size_t)m_vertexSize * m_vertexCapacity, NULL, GL_STATIC_DRAW);
+
+	m_indexCapacity = INITIAL_INDEX_CAPACITY;
+	glCreateBuffers(1, &m_indexBuffer);
+	glNamedBufferData(m_indexBuffer, (size_t)m_indexSize * m_indexCapacity, NULL, GL_STATIC_DRAW);
+
+	glEnableVertexArrayAttrib(m_vao, ATTRIBUTE_POSITION);
+	glEnableVertexArrayAttrib(m_vao, ATTRIBUTE_NORMAL);
+	glEnableVertexArrayAttrib(m_vao, ATTRIBUTE_TEXTURE_COORDINATE);
+
+	if (m_format == VERTEX_COMPACT)
+	{
+		// the normalized integers reach the shader as floats
+		glVertexArrayAttribFormat(m_vao, ATTRIBUTE_POSITION, 3, GL_SHORT, GL_TRUE,
+			offsetof(COMPACT_VERTEX, position));
+		glVertexArrayAttribFormat(m_vao, ATTRIBUTE_NORMAL, 2, GL_SHORT, GL_TRUE,
+			offsetof(COMPACT_VERTEX, normal));
+		glVertexArrayAttribFormat(m_vao, ATTRIBUTE_TEXTURE_COORDINATE, 2, GL_UNSIGNED_SHORT, GL_TRUE,
+			offsetof(COMPACT_VERTEX, textureCoordinate));
+	}
+	else
+	{
+		glVertexArrayAttribFormat(m_vao, ATTRIBUTE_POSITION, 3, GL_FLOAT, GL_FALSE,
+			offsetof(ShapeGeometry::SHAPE_VERTEX, position));
+		glVertexArrayAttribFormat(m_vao, ATTRIBUTE_NORMAL, 3, GL_FLOAT, GL_FALSE,
+			offsetof(ShapeGeometry::SHAPE_VERTEX, normal));
+		glVertexArrayAttribFormat(m_vao, ATTRIBUTE_TEXTURE_COORDINATE, 2, GL_FLOAT, GL_FALSE,
+			offsetof(ShapeGeometry::SHAPE_VERTEX, textureCoordinate));
+	}
+
+	glVertexArrayAttribBinding(m_vao, ATTRIBUTE_POSITION, VERTEX_BINDING);
+	glVertexArrayAttribBinding(m_vao, ATTRIBUTE_NORMAL, VERTEX_BINDING);
+	glVertexArrayAttribBinding(m_vao, ATTRIBUTE_TEXTURE_COORDINATE, VERTEX_BINDING);
+
+	glVertexArrayVertexBuffer(m_vao, VERTEX_BINDING, m_vertexBuffer, 0, m_vertexSize);
+	glVertexArrayElementBuffer(m_vao, m_indexBuffer);
+}
+
+/***********************************************************
+ *  GrowBuffer()
+ *
+ *  This method is used for replacing the passed in buffer
+ *  with a larger one.  The used part of the old buffer is
+ *  copied on the GPU, so the meshes are not kept in main
+ *  memory.
+ ***********************************************************/
+void MeshArena::GrowBuffer(GLuint& buffer, size_t usedBytes, size_t newCapacityBytes)
+{
+	GLuint newBuffer = 0;
+	glCreateBuffers(1, &newBuffer);
+	glNamedBufferData(newBuffer, newCapacityBytes, NULL, GL_STATIC_DRAW);
+	if (usedBytes > 0)
+	{
+		glCopyNamedBufferSubData(buffer, newBuffer, 0, 0, usedBytes);
+	}
+
+	glDeleteBuffers(1, &buffer);
+	buffer = newBuffer;
+}
+
+/***********************************************************
+ *  PackVertices()
+ *
+ *  This method is used for converting the vertices of a
+ *  shape to the compact layout.  It fails when the mesh is
+ *  outside the quantization box or has too many vertices
+ *  for 16 bit indices.
+ ***********************************************************/
+bool MeshArena::PackVertices(
+	const ShapeGeometry::SHAPE_VERTEX* vertices,
+	size_t vertexCount,
+	std::vector<COMPACT_VERTEX>& compact) const
+{
+	if (vertexCount > MAX_COMPACT_MESH_VERTICES)
+	{
+		std::cout << "Mesh has too many vertices for 16 bit indices:" << vertexCount << std::endl;
+		return false;
+	}
+
+	compact.resize(vertexCount);
+	for (size_t i = 0; i < vertexCount; i++)
+	{
+		glm::vec3 position = (vertices[i].position - m_positionOffset) / m_positionScale;
+		if ((std::fabs(position.x) > 1.0001f) || (std::fabs(position.y) > 1.0001f) || (std::fabs(position.z) > 1.0001f))
+		{
+			std::cout << "Mesh is outside the vertex quantization box" << std::endl;
+			return false;
+		}
+
+		glm::vec2 normal = EncodeOctahedral(vertices[i].normal);
+
+		compact[i].position[0] = ToSnorm16(position.x);
+		compact[i].position[1] = ToSnorm16(position.y);
+		compact[i].position[2] = ToSnorm16(position.z);
+		compact[i].position[3] = 0;
+		compact[i].normal[0] = ToSnorm16(normal.x);
+		compact[i].normal[1] = ToSnorm16(normal.y);
+		compact[i].textureCoordinate[0] = ToUnorm16(vertices[i].textureCoordinate.x);
+		compact[i].textureCoordinate[1] = ToUnorm16(vertices[i].textureCoordinate.y);
+	}
+
+	return true;
+}
+
+/***********************************************************
+ *  PackIndices()
+ *
+ *  This method is used for converting the indices of a shape
+ *  to 16 bits.  The indices are relative to the first vertex
+ *  of the shape, so they fit whenever the shape has few
+ *  enough vertices.
+ ***********************************************************/
+void MeshArena::PackIndices(
+	const GLuint* indices,
+	size_t indexCount,
+	std::vector<GLushort>& shortIndices) const
+{
+	shortIndices.resize(indexCount);
+	for (size_t i = 0; i < indexCount; i++)
+	{
+		shortIndices[i] = (GLushort)indices[i];
+	}
+}
+
+/***********************************************************
+ *  AddMesh()
+ *
+ *  This method is used for appending the passed in shape to
+ *  the shared buffers.
+ ***********************************************************/
+int MeshArena::AddMesh(const ShapeGeometry::SHAPE_GEOMETRY& geometry)
+{
+	return(AddMesh(
+		geometry.vertices.data(),
+		geometry.vertices.size(),
+		geometry.indices.data(),
+		geometry.indices.size()));
+}
+
+/***********************************************************
+ *  AddMesh()
+ *
+ *  This method is used for appending the passed in vertices
+ *  and indices to the shared buffers, growing them when
+ *  needed.  The indices stay relative to the first vertex
+ *  of the mesh, which the draws pass as the base vertex.
+ *  The full layout is uploaded straight from the passed in
+ *  memory, which may be a mapped file, without a copy.
+ ***********************************************************/
+int MeshArena::AddMesh(
+	const ShapeGeometry::SHAPE_VERTEX* vertices,
+	size_t vertexCount,
+	const GLuint* indices,
+	size_t indexCount)
+{
+	const void* vertexData = vertices;
+	const void* indexData = indices;
+
+	std::vector<COMPACT_VERTEX> compactVertices;
+	std::vector<GLushort> shortIndices;
+	if (m_format == VERTEX_COMPACT)
+	{
+		if (!PackVertices(vertices, vertexCount, compactVertices))
+		{
+			return(-1);
+		}
+		PackIndices(indices, indexCount, shortIndices);
+		vertexData = compactVertices.data();
+		indexData = shortIndices.data();
+	}
+
+	if (m_vao == 0)
+	{
+		Create();
+	}
+
+	if (m_vertexCount + vertexCount > m_vertexCapacity)
+	{
+		size_t capacity = m_vertexCapacity;
+		while (m_vertexCount + vertexCount > capacity)
+		{
+			capacity *= 2;
+		}
+		GrowBuffer(m_vertexBuffer, (size_t)m_vertexSize * m_vertexCount, (size_t)m_vertexSize * capacity);
+		glVertexArrayVertexBuffer(m_vao, VERTEX_BINDING, m_vertexBuffer, 0, m_vertexSize);
+		m_vertexCapacity = capacity;
+	}
+	if (m_indexCount + indexCount > m_indexCapacity)
+	{
+		size_t capacity = m_indexCapacity;
+		while (m_indexCount + indexCount > capacity)
+		{
+			capacity *= 2;
+		}
+		GrowBuffer(m_indexBuffer, (size_t)m_indexSize * m_indexCount, (size_t)m_indexSize * capacity);
+		glVertexArrayElementBuffer(m_vao, m_indexBuffer);
+		m_indexCapacity = capacity;
+	}
+
+	MESH_RANGE mesh;
+	mesh.firstIndex = (GLuint)m_indexCount;
+	mesh.indexCount = (GLuint)indexCount;
+	mesh.baseVertex = (GLint)m_vertexCount;
+	m_meshes.push_back(mesh);
+
+	if (vertexCount > 0)
+	{
+		glNamedBufferSubData(m_vertexBuffer, (size_t)m_vertexSize * m_vertexCount, (size_t)m_vertexSize * vertexCount, vertexData);
+	}
+	if (indexCount > 0)
+	{
+		glNamedBufferSubData(m_indexBuffer, (size_t)m_indexSize * m_indexCount, (size_t)m_indexSize * indexCount, indexData);
+	}
+
+	m_vertexCount += vertexCount;
+	m_indexCount += indexCount;
+
+	return((int)m_meshes.size() - 1);
+}
+
+/***********************************************************
+ *  Bind()
+ *
+ *  This method is used for binding the shared vertex array.
+ *  It is left bound after the draws, so drawing the next
+ *  mesh does not bind it again.
+ ***********************************************************/
+void MeshArena::Bind()
+{
+	m_pStateCache->BindVertexArray(m_vao);
+}
+
+/***********************************************************
+ *  DrawMesh()
+ *
+ *  This method is used for drawing one of the meshes with
+ *  the values currently set into the shader.
+ ***********************************************************/
+void MeshArena::DrawMesh(int meshID)
+{
+	if ((meshID < 0) || (meshID >= (int)m_meshes.size()))
+	{
+		return;
+	}
+
+	const MESH_RANGE& mesh = m_meshes[meshID];
+
+	Bind();
+	glDrawElementsBaseVertex(
+		GL_TRIANGLES,
+		(GLsizei)mesh.indexCount,
+		m_indexType,
+		(void*)((size_t)m_indexSize * mesh.firstIndex),
+		mesh.baseVertex);
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for freeing the vertex array and the
+ *  shared buffers.
+ ***********************************************************/
+void MeshArena::Destroy()
+{
+	if (m_vao != 0)
+	{
+		glDeleteVertexArrays(1, &m_vao);
+		glDeleteBuffers(1, &m_vertexBuffer);
+		glDeleteBuffers(1, &m_indexBuffer);
+		m_pStateCache->InvalidateVertexArray();
+	}
+
+	m_vao = 0;
+	m_vertexBuffer = 0;
+	m_indexBuffer = 0;
+	m_vertexCount = 0;
+	m_vertexCapacity = 0;
+	m_indexCount = 0;
+	m_indexCapacity = 0;
+	m_meshes.clear();
+}
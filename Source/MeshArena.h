@@ -0,0 +1,164 @@
+///////////////////////////////////////////////////////////////////////////////
+// mesharena.h
+// ============
+// store the geometry of all the meshes in one vertex and one index buffer
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShapeGeometry.h"
+#include "StateCache.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  MeshArena
+ *
+ *  This class suballocates the vertices and indices of all
+ *  the meshes from one large vertex buffer and one index
+ *  buffer, read through a single vertex array.  A mesh is a
+ *  range of the index buffer with the offset of its first
+ *  vertex, so drawing another mesh only changes the draw
+ *  call arguments and never binds another vertex array.
+ *
+ *  Meshes can be added at any time.  When a buffer is full
+ *  it is replaced by one twice as large, and the existing
+ *  data is copied over on the GPU.
+ *
+ *  Per-vertex attribute locations, read from binding 0:
+ *    0  position
+ *    1  normal
+ *    2  texture coordinate
+ *  Other bindings of the vertex array can be set up by the
+ *  users of the arena, such as InstancedMeshes.
+ *
+ *  The vertices are stored in one of two layouts:
+ *    full     float position, normal and texture coordinate,
+ *             32 bit indices - 32 bytes per vertex
+ *    compact  snorm16 position within a quantization box,
+ *             octahedral snorm16 normal, unorm16 texture
+ *             coordinate, 16 bit indices - 16 bytes per vertex
+ *  The compact positions are scaled back into the box by the
+ *  vertex shader, and its normals are decoded there too.
+ ***********************************************************/
+class MeshArena
+{
+public:
+	// constructor
+	MeshArena(StateCache* pStateCache);
+	// destructor
+	~MeshArena();
+
+	// most vertices a mesh can have with the 16 bit indices of
+	// the compact layout
+	static const size_t MAX_COMPACT_MESH_VERTICES = 65536;
+
+	// layouts the vertices can be stored in
+	enum VERTEX_FORMAT
+	{
+		VERTEX_FULL = 0,
+		VERTEX_COMPACT
+	};
+
+	// one vertex in the compact layout
+	struct COMPACT_VERTEX
+	{
+		// position in the quantization box, the fourth value
+		// pads the normal to a 4 byte boundary
+		GLshort position[4];
+		// octahedral encoding of the unit normal
+		GLshort normal[2];
+		GLushort textureCoordinate[2];
+	};
+
+	// the range of the shared buffers holding one mesh
+	struct MESH_RANGE
+	{
+		GLuint firstIndex;
+		GLuint indexCount;
+		GLint baseVertex;
+	};
+
+	// choose the vertex layout, before any mesh is added; the
+	// compact positions cover the passed in box
+	void SetVertexFormat(
+		VERTEX_FORMAT format,
+		const glm::vec3& boxCenter,
+		const glm::vec3& boxExtent);
+	// copy the passed in shape into the arena and return its
+	// mesh ID, or -1 if it does not fit the vertex layout
+	int AddMesh(const ShapeGeometry::SHAPE_GEOMETRY& geometry);
+	int AddMesh(
+		const ShapeGeometry::SHAPE_VERTEX* vertices,
+		size_t vertexCount,
+		const GLuint* indices,
+		size_t indexCount);
+	// draw a mesh with the values currently set into the shader
+	void DrawMesh(int meshID);
+	// bind the shared vertex array, unless already bound
+	void Bind();
+	// free the vertex array and buffers
+	void Destroy();
+
+	// get the range of an added mesh
+	const MESH_RANGE& GetMesh(int meshID) const { return(m_meshes[meshID]); }
+	// get the number of added meshes
+	int GetMeshCount() const { return((int)m_meshes.size()); }
+	// get the shared vertex array
+	GLuint GetVertexArray() const { return(m_vao); }
+	// get the vertex layout and the type and size of the indices
+	VERTEX_FORMAT GetVertexFormat() const { return(m_format); }
+	GLenum GetIndexType() const { return(m_indexType); }
+	GLsizei GetIndexSize() const { return(m_indexSize); }
+	// get the scale and offset that turn the stored positions
+	// into mesh positions
+	glm::vec3 GetPositionScale() const { return(m_positionScale); }
+	glm::vec3 GetPositionOffset() const { return(m_positionOffset); }
+	// get the bytes used by the vertices and indices
+	size_t GetUsedBytes() const { return(m_vertexCount * m_vertexSize + m_indexCount * m_indexSize); }
+
+private:
+	// create the vertex array with empty buffers
+	void Create();
+	// replace a buffer with a larger one holding the same data
+	void GrowBuffer(GLuint& buffer, size_t usedBytes, size_t newCapacityBytes);
+	// convert the vertices and indices of a shape to the
+	// compact layout
+	bool PackVertices(
+		const ShapeGeometry::SHAPE_VERTEX* vertices,
+		size_t vertexCount,
+		std::vector<COMPACT_VERTEX>& compact) const;
+	void PackIndices(
+		const GLuint* indices,
+		size_t indexCount,
+		std::vector<GLushort>& shortIndices) const;
+
+	// pointer to the cache of the vertex array binding
+	StateCache* m_pStateCache;
+	// added meshes, indexed by mesh ID
+	std::vector<MESH_RANGE> m_meshes;
+	// layout of the stored vertices and indices
+	VERTEX_FORMAT m_format;
+	GLsizei m_vertexSize;
+	GLenum m_indexType;
+	GLsizei m_indexSize;
+	// mapping of the stored positions to mesh positions
+	glm::vec3 m_positionScale;
+	glm::vec3 m_positionOffset;
+	// vertex array reading the shared buffers
+	GLuint m_vao;
+	GLuint m_vertexBuffer;
+	GLuint m_indexBuffer;
+	// used and allocated sizes of the buffers, in vertices
+	// and in indices
+	size_t m_vertexCount;
+	size_t m_vertexCapacity;
+	size_t m_indexCount;
+	size_t m_indexCapacity;
+};
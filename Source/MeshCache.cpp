@@ -0,0 +1,304 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshcache.cpp
+// ============
+// save the generated shape meshes to disk and map them back on later runs
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MeshCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+// declaration of global variables
+namespace
+{
+	const char g_Magic[4] = { 'M', 'C', 'S', 'H' };
+	const uint32_t FILE_VERSION = 1;
+
+	// alignment of the vertex and index data in the file
+	const size_t DATA_ALIGNMENT = 16;
+	// more meshes than any scene generates
+	const uint32_t MAX_MESHES = 4096;
+
+	/***********************************************************
+	 *  AlignOffset()
+	 *
+	 *  This function is used for rounding a file offset up to
+	 *  the next data boundary.
+	 ***********************************************************/
+	size_t AlignOffset(size_t offset)
+	{
+		return((offset + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT);
+	}
+
+	/***********************************************************
+	 *  IsInside()
+	 *
+	 *  This function is used for checking that a range of the
+	 *  passed in byte size lies within the file, without the
+	 *  sum overflowing for damaged offsets.
+	 ***********************************************************/
+	bool IsInside(uint64_t offset, uint64_t count, size_t elementSize, size_t fileSize)
+	{
+		if ((offset > fileSize) || (offset % DATA_ALIGNMENT != 0))
+		{
+			return false;
+		}
+		return(count <= (fileSize - offset) / elementSize);
+	}
+}
+
+/***********************************************************
+ *  MeshCache()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+MeshCache::MeshCache()
+{
+	m_header = NULL;
+	m_meshes = NULL;
+}
+
+/***********************************************************
+ *  ~MeshCache()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+MeshCache::~MeshCache()
+{
+	Close();
+}
+
+/***********************************************************
+ *  Open()
+ *
+ *  This method is used for memory mapping the passed in
+ *  cache file read-only.  The file is only used when it was
+ *  saved with the same key, so meshes generated with other
+ *  settings are never loaded.
+ ***********************************************************/
+bool MeshCache::Open(const std::string& filename, const std::string& key)
+{
+	Close();
+
+	if (!m_file.Open(filename))
+	{
+		return false;
+	}
+
+	m_header = (const CACHE_HEADER*)m_file.GetData();
+	m_meshes = (const CACHE_MESH*)(m_file.GetData() + sizeof(CACHE_HEADER));
+
+	if (!Validate(HashKey(key)))
+	{
+		std::cout << "Mesh cache file is out of date or invalid:" << filename << std::endl;
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+/***********************************************************
+ *  Close()
+ *
+ *  This method is used for unmapping the file.  Meshes that
+ *  were already uploaded are not affected.
+ ***********************************************************/
+void MeshCache::Close()
+{
+	m_file.Close();
+	m_header = NULL;
+	m_meshes = NULL;
+}
+
+/***********************************************************
+ *  Validate()
+ *
+ *  This method is used for checking that the mapped file is
+ *  a mesh cache of this version and key, that every mesh
+ *  lies inside the file, and that no index points past the
+ *  vertices of its mesh, so a damaged file can never make
+ *  the GPU read outside the mesh arena.
+ ***********************************************************/
+bool MeshCache::Validate(uint64_t keyHash) const
+{
+	size_t size = m_file.GetSize();
+	if (size < sizeof(CACHE_HEADER))
+	{
+		return false;
+	}
+	if ((memcmp(m_header->magic, g_Magic, sizeof(g_Magic)) != 0) ||
+		(m_header->version != FILE_VERSION) ||
+		(m_header->keyHash != keyHash) ||
+		(m_header->vertexSize != sizeof(ShapeGeometry::SHAPE_VERTEX)) ||
+		(m_header->meshCount > MAX_MESHES))
+	{
+		return false;
+	}
+	if (size < sizeof(CACHE_HEADER) + sizeof(CACHE_MESH) * m_header->meshCount)
+	{
+		return false;
+	}
+
+	for (uint32_t mesh = 0; mesh < m_header->meshCount; mesh++)
+	{
+		const CACHE_MESH& entry = m_meshes[mesh];
+		if (!IsInside(entry.vertexOffset, entry.vertexCount, sizeof(ShapeGeometry::SHAPE_VERTEX), size) ||
+			!IsInside(entry.indexOffset, entry.indexCount, sizeof(GLuint), size) ||
+			(entry.indexCount % 3 != 0))
+		{
+			return false;
+		}
+
+		const GLuint* indices = (const GLuint*)(m_file.GetData() + entry.indexOffset);
+		for (uint64_t i = 0; i < entry.indexCount; i++)
+		{
+			if (indices[i] >= entry.vertexCount)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+/***********************************************************
+ *  GetMesh()
+ *
+ *  This method is used for getting pointers to the vertices
+ *  and indices of a mesh inside the mapped file.  They stay
+ *  valid until the file is closed.
+ ***********************************************************/
+MeshCache::CACHED_MESH MeshCache::GetMesh(int meshIndex) const
+{
+	const CACHE_MESH& entry = m_meshes[meshIndex];
+
+	CACHED_MESH mesh;
+	mesh.vertices = (const ShapeGeometry::SHAPE_VERTEX*)(m_file.GetData() + entry.vertexOffset);
+	mesh.vertexCount = (size_t)entry.vertexCount;
+	mesh.indices = (const GLuint*)(m_file.GetData() + entry.indexOffset);
+	mesh.indexCount = (size_t)entry.indexCount;
+	return(mesh);
+}
+
+/***********************************************************
+ *  Write()
+ *
+ *  This method is used for writing a cache file with the
+ *  passed in meshes, in order, saved under the passed in
+ *  key.  The file is written under a temporary name and
+ *  then renamed over the old one, so another process that
+ *  has the old file mapped keeps reading it whole, and no
+ *  process ever maps a partly written file.
+ ***********************************************************/
+bool MeshCache::Write(
+	const std::string& filename,
+	const std::string& key,
+	const std::vector<ShapeGeometry::SHAPE_GEOMETRY>& meshes)
+{
+	if (meshes.size() > MAX_MESHES)
+	{
+		return false;
+	}
+
+	CACHE_HEADER header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, g_Magic, sizeof(g_Magic));
+	header.version = FILE_VERSION;
+	header.keyHash = HashKey(key);
+	header.vertexSize = sizeof(ShapeGeometry::SHAPE_VERTEX);
+	header.meshCount = (uint32_t)meshes.size();
+
+	// lay out the meshes after the mesh table
+	std::vector<CACHE_MESH> table(meshes.size());
+	size_t offset = sizeof(CACHE_HEADER) + sizeof(CACHE_MESH) * meshes.size();
+	for (size_t mesh = 0; mesh < meshes.size(); mesh++)
+	{
+		offset = AlignOffset(offset);
+		table[mesh].vertexOffset = offset;
+		table[mesh].vertexCount = meshes[mesh].vertices.size();
+		offset += sizeof(ShapeGeometry::SHAPE_VERTEX) * meshes[mesh].vertices.size();
+
+		offset = AlignOffset(offset);
+		table[mesh].indexOffset = offset;
+		table[mesh].indexCount = meshes[mesh].indices.size();
+		offset += sizeof(GLuint) * meshes[mesh].indices.size();
+	}
+
+	std::string tempFilename = filename + ".tmp";
+	std::ofstream file(tempFilename, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	file.write((const char*)&header, sizeof(header));
+	file.write((const char*)table.data(), sizeof(CACHE_MESH) * table.size());
+
+	const char padding[DATA_ALIGNMENT] = { 0 };
+	size_t position = sizeof(CACHE_HEADER) + sizeof(CACHE_MESH) * meshes.size();
+	for (size_t mesh = 0; mesh < meshes.size(); mesh++)
+	{
+		file.write(padding, (std::streamsize)(table[mesh].vertexOffset - position));
+		file.write((const char*)meshes[mesh].vertices.data(),
+			(std::streamsize)(sizeof(ShapeGeometry::SHAPE_VERTEX) * meshes[mesh].vertices.size()));
+		position = (size_t)table[mesh].vertexOffset + sizeof(ShapeGeometry::SHAPE_VERTEX) * meshes[mesh].vertices.size();
+
+		file.write(padding, (std::streamsize)(table[mesh].indexOffset - position));
+		file.write((const char*)meshes[mesh].indices.data(),
+			(std::streamsize)(sizeof(GLuint) * meshes[mesh].indices.size()));
+		position = (size_t)table[mesh].indexOffset + sizeof(GLuint) * meshes[mesh].indices.size();
+	}
+
+	file.close();
+	if (file.fail())
+	{
+		std::remove(tempFilename.c_str());
+		return false;
+	}
+
+	// replacing the file keeps the old contents alive for any
+	// process that still has them mapped
+#ifdef _WIN32
+	bool bRenamed = (MoveFileExA(tempFilename.c_str(), filename.c_str(), MOVEFILE_REPLACE_EXISTING) != 0);
+#else
+	bool bRenamed = (std::rename(tempFilename.c_str(), filename.c_str()) == 0);
+#endif
+	if (!bRenamed)
+	{
+		std::remove(tempFilename.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+/***********************************************************
+ *  HashKey()
+ *
+ *  This method is used for hashing the passed in key text
+ *  with 64 bit FNV-1a, which is stored in the file instead
+ *  of the text itself.
+ ***********************************************************/
+uint64_t MeshCache::HashKey(const std::string& key)
+{
+	uint64_t hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < key.size(); i++)
+	{
+		hash ^= (unsigned char)key[i];
+		hash *= 1099511628211ULL;
+	}
+	return(hash);
+}
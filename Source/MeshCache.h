@@ -0,0 +1,107 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshcache.h
+// ============
+// save the generated shape meshes to disk and map them back on later runs
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "MappedFile.h"
+#include "ShapeGeometry.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  MeshCache
+ *
+ *  This class saves the vertices and indices of generated
+ *  meshes to a binary file, and reads them back on later
+ *  runs by memory mapping the file, so the meshes can be
+ *  handed to OpenGL straight from it without generating or
+ *  optimizing them again.
+ *
+ *  The file stores a hash of a key text that lists every
+ *  value the meshes were generated with.  A file with
+ *  another key, version or vertex size is not used, and the
+ *  meshes are generated and saved again.
+ *
+ *  File layout, little endian:
+ *    header      CACHE_HEADER
+ *    mesh table  one CACHE_MESH per mesh
+ *    mesh data   the vertices then the 32 bit indices of
+ *                each mesh, each starting on a 16 byte
+ *                boundary
+ ***********************************************************/
+class MeshCache
+{
+public:
+	// constructor
+	MeshCache();
+	// destructor
+	~MeshCache();
+
+	// one mesh read from the mapped file
+	struct CACHED_MESH
+	{
+		const ShapeGeometry::SHAPE_VERTEX* vertices;
+		size_t vertexCount;
+		const GLuint* indices;
+		size_t indexCount;
+	};
+
+	// map the passed in file, false if it is missing, invalid
+	// or was saved with another key
+	bool Open(const std::string& filename, const std::string& key);
+	// unmap the file
+	void Close();
+
+	// write a cache file holding the passed in meshes
+	static bool Write(
+		const std::string& filename,
+		const std::string& key,
+		const std::vector<ShapeGeometry::SHAPE_GEOMETRY>& meshes);
+	// get the 64 bit FNV-1a hash of a key text
+	static uint64_t HashKey(const std::string& key);
+
+	bool IsOpen() const { return(m_file.IsOpen()); }
+	int GetMeshCount() const { return((int)m_header->meshCount); }
+	// get the mapped vertices and indices of a mesh
+	CACHED_MESH GetMesh(int meshIndex) const;
+
+private:
+	struct CACHE_HEADER
+	{
+		char magic[4];
+		uint32_t version;
+		uint64_t keyHash;
+		uint32_t vertexSize;
+		uint32_t meshCount;
+		uint32_t reserved[2];
+	};
+
+	struct CACHE_MESH
+	{
+		uint64_t vertexOffset;
+		uint64_t vertexCount;
+		uint64_t indexOffset;
+		uint64_t indexCount;
+	};
+
+	// MeshCache objects own a mapping and cannot be copied
+	MeshCache(const MeshCache&);
+	MeshCache& operator=(const MeshCache&);
+
+	// check the mapped header, mesh table and indices
+	bool Validate(uint64_t keyHash) const;
+
+	// the mapped file, and its header and mesh table
+	MappedFile m_file;
+	const CACHE_HEADER* m_header;
+	const CACHE_MESH* m_meshes;
+};
@@ -0,0 +1,399 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshoptimizer.cpp
+// ============
+// reorder mesh triangles and vertices for the GPU vertex cache
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+
+// declaration of global variables
+namespace
+{
+	// marks a vertex that has not been numbered yet
+	const GLuint UNUSED_VERTEX = 0xffffffff;
+
+	// the triangles of one cluster and its overdraw sort value
+	struct CLUSTER
+	{
+		size_t firstTriangle;
+		size_t triangleCount;
+		float outwardness;
+	};
+
+	/***********************************************************
+	 *  IsMoreOutward()
+	 *
+	 *  This function is used for ordering the clusters, the
+	 *  most outward facing first.
+	 ***********************************************************/
+	bool IsMoreOutward(const CLUSTER& a, const CLUSTER& b)
+	{
+		return(a.outwardness > b.outwardness);
+	}
+}
+
+/***********************************************************
+ *  Optimize()
+ *
+ *  This method is used for running the whole pass on a mesh
+ *  and returning the cache statistics before and after.
+ *  The triangle order is only changed when it lowers the
+ *  cache misses.
+ ***********************************************************/
+MeshOptimizer::OPTIMIZE_REPORT MeshOptimizer::Optimize(
+	ShapeGeometry::SHAPE_GEOMETRY& geometry,
+	int cacheSize)
+{
+	OPTIMIZE_REPORT report;
+	report.acmrBefore = CalculateACMR(geometry.indices, geometry.vertices.size(), cacheSize);
+	report.atvrBefore = CalculateATVR(geometry.indices, geometry.vertices.size(), cacheSize);
+
+	// a mesh small enough to fit the cache can already be in
+	// a better order, which is then kept
+	std::vector<GLuint> inputIndices = geometry.indices;
+	OptimizeVertexCache(geometry, cacheSize);
+	if (CalculateACMR(geometry.indices, geometry.vertices.size(), cacheSize) > report.acmrBefore)
+	{
+		geometry.indices.swap(inputIndices);
+	}
+	OptimizeVertexFetch(geometry);
+
+	report.acmrAfter = CalculateACMR(geometry.indices, geometry.vertices.size(), cacheSize);
+	report.atvrAfter = CalculateATVR(geometry.indices, geometry.vertices.size(), cacheSize);
+
+	return(report);
+}
+
+/***********************************************************
+ *  OptimizeVertexCache()
+ *
+ *  This method is used for reordering the triangles with
+ *  the Tipsify algorithm.  It emits all the remaining
+ *  triangles around one vertex, then moves on to the vertex
+ *  of those triangles that is still in the cache and will
+ *  stay there once its own remaining triangles are emitted.
+ *  When no vertex qualifies, it goes back to a recently used
+ *  vertex with triangles left, or to the next such vertex
+ *  in input order; each of these jumps starts a new cluster.
+ ***********************************************************/
+void MeshOptimizer::OptimizeVertexCache(
+	ShapeGeometry::SHAPE_GEOMETRY& geometry,
+	int cacheSize)
+{
+	const std::vector<GLuint>& indices = geometry.indices;
+	size_t vertexCount = geometry.vertices.size();
+	size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0)
+	{
+		return;
+	}
+
+	// triangles around each vertex, as offsets into one list
+	std::vector<GLuint> liveCount(vertexCount, 0);
+	for (size_t i = 0; i < triangleCount * 3; i++)
+	{
+		liveCount[indices[i]]++;
+	}
+	std::vector<size_t> adjacencyStart(vertexCount + 1, 0);
+	for (size_t v = 0; v < vertexCount; v++)
+	{
+		adjacencyStart[v + 1] = adjacencyStart[v] + liveCount[v];
+	}
+	std::vector<GLuint> adjacency(adjacencyStart[vertexCount]);
+	std::vector<size_t> adjacencyFill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+	for (size_t i = 0; i < triangleCount * 3; i++)
+	{
+		adjacency[adjacencyFill[indices[i]]++] = (GLuint)(i / 3);
+	}
+
+	// time each vertex last entered the cache
+	std::vector<int> cacheTime(vertexCount, 0);
+	int time = cacheSize + 1;
+	std::vector<bool> bEmitted(triangleCount, false);
+	std::vector<GLuint> deadEnds;
+	std::vector<GLuint> candidates;
+	std::vector<GLuint> output;
+	std::vector<size_t> clusterStarts(1, 0);
+	output.reserve(triangleCount * 3);
+	size_t cursor = 0;
+
+	int fanVertex = (int)indices[0];
+	while (fanVertex >= 0)
+	{
+		candidates.clear();
+
+		for (size_t a = adjacencyStart[fanVertex]; a < adjacencyStart[fanVertex + 1]; a++)
+		{
+			GLuint triangle = adjacency[a];
+			if (bEmitted[triangle])
+			{
+				continue;
+			}
+
+			for (int corner = 0; corner < 3; corner++)
+			{
+				GLuint vertex = indices[triangle * 3 + corner];
+				output.push_back(vertex);
+				deadEnds.push_back(vertex);
+				candidates.push_back(vertex);
+				liveCount[vertex]--;
+				if (time - cacheTime[vertex] > cacheSize)
+				{
+					cacheTime[vertex] = time;
+					time++;
+				}
+			}
+			bEmitted[triangle] = true;
+		}
+
+		// the candidate that is in the cache and stays there
+		// longest once its remaining triangles are emitted
+		fanVertex = -1;
+		int bestPriority = -1;
+		for (size_t c = 0; c < candidates.size(); c++)
+		{
+			GLuint vertex = candidates[c];
+			if (liveCount[vertex] == 0)
+			{
+				continue;
+			}
+
+			int priority = 0;
+			if (time - cacheTime[vertex] + 2 * (int)liveCount[vertex] <= cacheSize)
+			{
+				priority = time - cacheTime[vertex];
+			}
+			if (priority > bestPriority)
+			{
+				bestPriority = priority;
+				fanVertex = (int)vertex;
+			}
+		}
+
+		if (fanVertex >= 0)
+		{
+			continue;
+		}
+
+		// dead end - go back to a recent vertex with triangles
+		// left, or else to the next one in input order
+		while (!deadEnds.empty() && (fanVertex < 0))
+		{
+			GLuint vertex = deadEnds.back();
+			deadEnds.pop_back();
+			if (liveCount[vertex] > 0)
+			{
+				fanVertex = (int)vertex;
+			}
+		}
+		while ((fanVertex < 0) && (cursor < vertexCount))
+		{
+			if (liveCount[cursor] > 0)
+			{
+				fanVertex = (int)cursor;
+			}
+			cursor++;
+		}
+
+		if ((fanVertex >= 0) && (output.size() / 3 > clusterStarts.back()))
+		{
+			clusterStarts.push_back(output.size() / 3);
+		}
+	}
+
+	geometry.indices.swap(output);
+	SortClusters(geometry, clusterStarts);
+}
+
+/***********************************************************
+ *  SortClusters()
+ *
+ *  This method is used for moving the clusters that face
+ *  away from the center of the mesh to the front.  Those
+ *  parts tend to hide the rest of the mesh rather than be
+ *  hidden, so drawing them first lets the depth test reject
+ *  more of the later fragments.  The order within each
+ *  cluster, and so most of the cache order, is kept.
+ ***********************************************************/
+void MeshOptimizer::SortClusters(
+	ShapeGeometry::SHAPE_GEOMETRY& geometry,
+	const std::vector<size_t>& clusterStarts)
+{
+	const std::vector<GLuint>& indices = geometry.indices;
+	size_t triangleCount = indices.size() / 3;
+	if (clusterStarts.size() < 2)
+	{
+		return;
+	}
+
+	glm::vec3 meshCenter(0.0f, 0.0f, 0.0f);
+	for (size_t v = 0; v < geometry.vertices.size(); v++)
+	{
+		meshCenter = meshCenter + geometry.vertices[v].position;
+	}
+	meshCenter = meshCenter * (1.0f / (float)geometry.vertices.size());
+
+	std::vector<CLUSTER> clusters(clusterStarts.size());
+	for (size_t c = 0; c < clusters.size(); c++)
+	{
+		CLUSTER& cluster = clusters[c];
+		cluster.firstTriangle = clusterStarts[c];
+		cluster.triangleCount = ((c + 1 < clusterStarts.size()) ? clusterStarts[c + 1] : triangleCount) - cluster.firstTriangle;
+
+		// area weighted normal and center of the cluster
+		glm::vec3 normal(0.0f, 0.0f, 0.0f);
+		glm::vec3 center(0.0f, 0.0f, 0.0f);
+		float area = 0.0f;
+		for (size_t t = cluster.firstTriangle; t < cluster.firstTriangle + cluster.triangleCount; t++)
+		{
+			glm::vec3 p0 = geometry.vertices[indices[t * 3]].position;
+			glm::vec3 p1 = geometry.vertices[indices[t * 3 + 1]].position;
+			glm::vec3 p2 = geometry.vertices[indices[t * 3 + 2]].position;
+			glm::vec3 faceNormal = glm::cross(p1 - p0, p2 - p0);
+			float faceArea = glm::length(faceNormal);
+
+			normal = normal + faceNormal;
+			center = center + (p0 + p1 + p2) * (faceArea / 3.0f);
+			area += faceArea;
+		}
+
+		cluster.outwardness = 0.0f;
+		float normalLength = glm::length(normal);
+		if ((area > 0.0f) && (normalLength > 0.0f))
+		{
+			center = center * (1.0f / area);
+			cluster.outwardness = glm::dot(center - meshCenter, normal * (1.0f / normalLength));
+		}
+	}
+
+	// a stable sort keeps the result deterministic
+	std::stable_sort(clusters.begin(), clusters.end(), IsMoreOutward);
+
+	std::vector<GLuint> sorted;
+	sorted.reserve(indices.size());
+	for (size_t c = 0; c < clusters.size(); c++)
+	{
+		sorted.insert(sorted.end(),
+			indices.begin() + clusters[c].firstTriangle * 3,
+			indices.begin() + (clusters[c].firstTriangle + clusters[c].triangleCount) * 3);
+	}
+	geometry.indices.swap(sorted);
+}
+
+/***********************************************************
+ *  OptimizeVertexFetch()
+ *
+ *  This method is used for renumbering the vertices in the
+ *  order the triangles first use them, so the vertex reads
+ *  move forward through memory.  Unused vertices are
+ *  dropped.
+ ***********************************************************/
+void MeshOptimizer::OptimizeVertexFetch(ShapeGeometry::SHAPE_GEOMETRY& geometry)
+{
+	std::vector<GLuint> remap(geometry.vertices.size(), UNUSED_VERTEX);
+	std::vector<ShapeGeometry::SHAPE_VERTEX> vertices;
+	vertices.reserve(geometry.vertices.size());
+
+	for (size_t i = 0; i < geometry.indices.size(); i++)
+	{
+		GLuint& index = geometry.indices[i];
+		if (remap[index] == UNUSED_VERTEX)
+		{
+			remap[index] = (GLuint)vertices.size();
+			vertices.push_back(geometry.vertices[index]);
+		}
+		index = remap[index];
+	}
+
+	geometry.vertices.swap(vertices);
+}
+
+/***********************************************************
+ *  CountCacheMisses()
+ *
+ *  This method is used for counting the vertices that a
+ *  first-in first-out cache of the passed in size would
+ *  have to transform for the passed in triangles.
+ ***********************************************************/
+size_t MeshOptimizer::CountCacheMisses(
+	const std::vector<GLuint>& indices,
+	size_t vertexCount,
+	int cacheSize)
+{
+	// a vertex is in the cache while fewer than cacheSize
+	// misses happened since it was loaded
+	std::vector<size_t> loadedAt(vertexCount, 0);
+	std::vector<bool> bLoaded(vertexCount, false);
+	size_t misses = 0;
+
+	for (size_t i = 0; i < indices.size(); i++)
+	{
+		GLuint vertex = indices[i];
+		if (!bLoaded[vertex] || (misses - loadedAt[vertex] >= (size_t)cacheSize))
+		{
+			loadedAt[vertex] = misses;
+			bLoaded[vertex] = true;
+			misses++;
+		}
+	}
+
+	return(misses);
+}
+
+/***********************************************************
+ *  CalculateACMR()
+ *
+ *  This method is used for getting the average cache miss
+ *  ratio, the transformed vertices per triangle.  It is 3
+ *  without any reuse and approaches 0.5 for large regular
+ *  grids.
+ ***********************************************************/
+float MeshOptimizer::CalculateACMR(
+	const std::vector<GLuint>& indices,
+	size_t vertexCount,
+	int cacheSize)
+{
+	size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0)
+	{
+		return(0.0f);
+	}
+
+	return((float)CountCacheMisses(indices, vertexCount, cacheSize) / (float)triangleCount);
+}
+
+/***********************************************************
+ *  CalculateATVR()
+ *
+ *  This method is used for getting the average transformed
+ *  vertex ratio, the transformed vertices per vertex used.
+ *  It is 1 when every vertex is transformed only once.
+ ***********************************************************/
+float MeshOptimizer::CalculateATVR(
+	const std::vector<GLuint>& indices,
+	size_t vertexCount,
+	int cacheSize)
+{
+	std::vector<bool> bUsed(vertexCount, false);
+	size_t usedCount = 0;
+	for (size_t i = 0; i < indices.size(); i++)
+	{
+		if (!bUsed[indices[i]])
+		{
+			bUsed[indices[i]] = true;
+			usedCount++;
+		}
+	}
+	if (usedCount == 0)
+	{
+		return(0.0f);
+	}
+
+	return((float)CountCacheMisses(indices, vertexCount, cacheSize) / (float)usedCount);
+}
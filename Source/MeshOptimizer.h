@@ -0,0 +1,90 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshoptimizer.h
+// ============
+// reorder mesh triangles and vertices for the GPU vertex cache
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShapeGeometry.h"
+
+#include <vector>
+
+/***********************************************************
+ *  MeshOptimizer
+ *
+ *  This class reorders the triangles and vertices of a mesh
+ *  so the GPU transforms fewer vertices and reads them from
+ *  memory in order:
+ *    1. the triangles are put in Tipsify order (Sander,
+ *       Nehab and Barczak 2007), which fans around vertices
+ *       that are still in a simulated cache of the passed
+ *       in size
+ *    2. the clusters of triangles between the jumps of that
+ *       order are sorted so the outward facing ones come
+ *       first, which cuts the overdraw within the mesh
+ *    3. the vertices are renumbered in the order the
+ *       triangles first use them
+ *
+ *  The result only depends on the input mesh, and no OpenGL
+ *  call is made, so the pass can run and be checked on the
+ *  CPU alone.  The ACMR (cache misses per triangle) and ATVR
+ *  (cache misses per vertex) are measured with a FIFO cache
+ *  before and after.
+ ***********************************************************/
+class MeshOptimizer
+{
+public:
+	// vertex cache size the triangles are ordered for
+	static const int DEFAULT_CACHE_SIZE = 16;
+	// raised whenever the reordering gives different results,
+	// so saved copies of optimized meshes are rebuilt
+	static const int ALGORITHM_VERSION = 1;
+
+	// cache statistics of a mesh before and after optimizing
+	struct OPTIMIZE_REPORT
+	{
+		float acmrBefore;
+		float acmrAfter;
+		float atvrBefore;
+		float atvrAfter;
+	};
+
+	// reorder the triangles and vertices of a mesh
+	static OPTIMIZE_REPORT Optimize(
+		ShapeGeometry::SHAPE_GEOMETRY& geometry,
+		int cacheSize = DEFAULT_CACHE_SIZE);
+
+	// put the triangles in Tipsify order, with their clusters
+	// sorted to reduce overdraw
+	static void OptimizeVertexCache(
+		ShapeGeometry::SHAPE_GEOMETRY& geometry,
+		int cacheSize);
+	// renumber the vertices in the order they are first used
+	static void OptimizeVertexFetch(ShapeGeometry::SHAPE_GEOMETRY& geometry);
+
+	// get the number of misses of a FIFO vertex cache per
+	// triangle and per vertex
+	static float CalculateACMR(
+		const std::vector<GLuint>& indices,
+		size_t vertexCount,
+		int cacheSize);
+	static float CalculateATVR(
+		const std::vector<GLuint>& indices,
+		size_t vertexCount,
+		int cacheSize);
+
+private:
+	// count the misses of a FIFO vertex cache
+	static size_t CountCacheMisses(
+		const std::vector<GLuint>& indices,
+		size_t vertexCount,
+		int cacheSize);
+	// sort the clusters of triangles, outward facing first
+	static void SortClusters(
+		ShapeGeometry::SHAPE_GEOMETRY& geometry,
+		const std::vector<size_t>& clusterStarts);
+};
@@ -0,0 +1,240 @@
+///////////////////////////////////////////////////////////////////////////////
+// offscreentarget.cpp
+// ============
+// manage an offscreen framebuffer for headless rendering and frame capture
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "OffscreenTarget.h"
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/types.h>
+#endif
+
+namespace
+{
+	/***********************************************************
+	 *  IsDirectory()
+	 *
+	 *  This function is used for checking that the passed in
+	 *  path names an existing folder.
+	 ***********************************************************/
+	bool IsDirectory(const std::string& path)
+	{
+		struct stat info;
+		if (stat(path.c_str(), &info) != 0)
+		{
+			return(false);
+		}
+		return((info.st_mode & S_IFDIR) != 0);
+	}
+
+	/***********************************************************
+	 *  MakeDirectory()
+	 *
+	 *  This function is used for creating one folder, whose
+	 *  parent folder already exists.
+	 ***********************************************************/
+	void MakeDirectory(const std::string& path)
+	{
+#ifdef _WIN32
+		_mkdir(path.c_str());
+#else
+		mkdir(path.c_str(), 0755);
+#endif
+	}
+}
+
+/***********************************************************
+ *  OffscreenTarget()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+OffscreenTarget::OffscreenTarget()
+{
+	m_framebufferID = 0;
+	m_colorBufferID = 0;
+	m_depthBufferID = 0;
+	m_width = 0;
+	m_height = 0;
+}
+
+/***********************************************************
+ *  ~OffscreenTarget()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+OffscreenTarget::~OffscreenTarget()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used to create the framebuffer object
+ *  with an RGBA color attachment and a depth attachment of
+ *  the passed in size.
+ ***********************************************************/
+bool OffscreenTarget::Create(int width, int height)
+{
+	Destroy();
+
+	m_width = width;
+	m_height = height;
+
+	glGenFramebuffers(1, &m_framebufferID);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebufferID);
+
+	// color attachment
+	glGenRenderbuffers(1, &m_colorBufferID);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_colorBufferID);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colorBufferID);
+
+	// depth attachment
+	glGenRenderbuffers(1, &m_depthBufferID);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_depthBufferID);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depthBufferID);
+
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	if (status != GL_FRAMEBUFFER_COMPLETE)
+	{
+		std::cout << "Offscreen framebuffer is incomplete, status:0x" << std::hex << status << std::dec << std::endl;
+		Destroy();
+		return false;
+	}
+
+	return true;
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used to free the framebuffer object and
+ *  its attachments.
+ ***********************************************************/
+void OffscreenTarget::Destroy()
+{
+	if (m_depthBufferID != 0)
+	{
+		glDeleteRenderbuffers(1, &m_depthBufferID);
+		m_depthBufferID = 0;
+	}
+	if (m_colorBufferID != 0)
+	{
+		glDeleteRenderbuffers(1, &m_colorBufferID);
+		m_colorBufferID = 0;
+	}
+	if (m_framebufferID != 0)
+	{
+		glDeleteFramebuffers(1, &m_framebufferID);
+		m_framebufferID = 0;
+	}
+}
+
+/***********************************************************
+ *  Bind()
+ *
+ *  This method is used to direct all following draw
+ *  commands into the offscreen framebuffer.
+ ***********************************************************/
+void OffscreenTarget::Bind()
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebufferID);
+	glViewport(0, 0, m_width, m_height);
+}
+
+/***********************************************************
+ *  Unbind()
+ *
+ *  This method is used to restore the default framebuffer.
+ ***********************************************************/
+void OffscreenTarget::Unbind()
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+/***********************************************************
+ *  SaveFramePPM()
+ *
+ *  This method is used to read back the rendered pixels of
+ *  the framebuffer and write them into a binary PPM (P6)
+ *  image file.  OpenGL rows start at the bottom of the
+ *  image, so they are flipped while writing.
+ ***********************************************************/
+bool OffscreenTarget::SaveFramePPM(const std::string& filename)
+{
+	if (m_framebufferID == 0)
+	{
+		return false;
+	}
+
+	std::vector<unsigned char> pixels(m_width * m_height * 3);
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebufferID);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, m_width, m_height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+
+	std::ofstream file(filename, std::ios::binary);
+	if (!file)
+	{
+		std::cout << "Could not open capture file:" << filename << std::endl;
+		return false;
+	}
+
+	file << "P6\n" << m_width << " " << m_height << "\n255\n";
+	for (int row = m_height - 1; row >= 0; row--)
+	{
+		file.write((const char*)&pixels[row * m_width * 3], m_width * 3);
+	}
+
+	std::cout << "Captured frame:" << filename << std::endl;
+
+	return true;
+}
+
+/***********************************************************
+ *  CreateCaptureDirectory()
+ *
+ *  This method is used to create the folder the captured
+ *  frames are saved in, one level at a time.  It is called
+ *  once before rendering, so a bad path is reported once
+ *  instead of for every captured frame.
+ ***********************************************************/
+bool OffscreenTarget::CreateCaptureDirectory(const std::string& path)
+{
+	for (size_t i = 1; i <= path.size(); i++)
+	{
+		if ((i == path.size()) || (path[i] == '/') || (path[i] == '\\'))
+		{
+			std::string folder = path.substr(0, i);
+			if (!IsDirectory(folder))
+			{
+				MakeDirectory(folder);
+			}
+		}
+	}
+
+	if (!IsDirectory(path))
+	{
+		std::cout << "ERROR: Could not create the capture folder:" << path << std::endl;
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,61 @@
+///////////////////////////////////////////////////////////////////////////////
+// offscreentarget.h
+// ============
+// manage an offscreen framebuffer for headless rendering and frame capture
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <string>
+
+/***********************************************************
+ *  OffscreenTarget
+ *
+ *  This class wraps an OpenGL framebuffer object with color
+ *  and depth attachments so the 3D scene can be rendered
+ *  without a visible display window, and so that rendered
+ *  frames can be read back and saved to image files.
+ ***********************************************************/
+class OffscreenTarget
+{
+public:
+	// constructor
+	OffscreenTarget();
+	// destructor
+	~OffscreenTarget();
+
+	// create the framebuffer and its attachments
+	bool Create(int width, int height);
+	// free the framebuffer and its attachments
+	void Destroy();
+
+	// direct all following draw commands into the framebuffer
+	void Bind();
+	// restore the default framebuffer of the window
+	void Unbind();
+
+	// read back the current contents and save as a binary PPM image
+	bool SaveFramePPM(const std::string& filename);
+	// create the folder the frames are saved in, with any
+	// missing parent folders
+	static bool CreateCaptureDirectory(const std::string& path);
+
+	int GetWidth() const { return(m_width); }
+	int GetHeight() const { return(m_height); }
+
+private:
+	// OpenGL framebuffer object
+	GLuint m_framebufferID;
+	// color attachment of the framebuffer
+	GLuint m_colorBufferID;
+	// depth attachment of the framebuffer
+	GLuint m_depthBufferID;
+	// size of the attachments in pixels
+	int m_width;
+	int m_height;
+};
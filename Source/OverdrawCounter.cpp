@@ -0,0 +1,175 @@
+///////////////////////////////////////////////////////////////////////////////
+// overdrawcounter.cpp
+// ============
+// count the fragments shaded at each pixel of the frame
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "OverdrawCounter.h"
+#include "ShaderBindings.h"
+
+// declaration of global variables
+namespace
+{
+	// the shaded fragments and covered pixels, in the order of
+	// their offsets in the shader
+	const int COUNTER_COUNT = 2;
+}
+
+/***********************************************************
+ *  OverdrawCounter()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+OverdrawCounter::OverdrawCounter()
+{
+	m_imageID = 0;
+	m_imageWidth = 0;
+	m_imageHeight = 0;
+	for (int slot = 0; slot < FRAME_COUNT; slot++)
+	{
+		m_counterBuffers[slot] = 0;
+		m_bCounterPending[slot] = false;
+	}
+	m_frameSlot = 0;
+	m_shadedFragments = 0;
+	m_coveredPixels = 0;
+}
+
+/***********************************************************
+ *  ~OverdrawCounter()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+OverdrawCounter::~OverdrawCounter()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for creating one atomic counter
+ *  buffer per frame in flight.  The image is created by the
+ *  first frame, once the viewport size is known.
+ ***********************************************************/
+bool OverdrawCounter::Create()
+{
+	glCreateBuffers(FRAME_COUNT, m_counterBuffers);
+	for (int slot = 0; slot < FRAME_COUNT; slot++)
+	{
+		glNamedBufferStorage(m_counterBuffers[slot], sizeof(GLuint) * COUNTER_COUNT, NULL, GL_DYNAMIC_STORAGE_BIT);
+	}
+
+	return(m_counterBuffers[0] != 0);
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for preparing the counters of the
+ *  frame.  The oldest buffer is read back before it is
+ *  cleared for reuse, and the image is created again when
+ *  the viewport has been resized.
+ ***********************************************************/
+void OverdrawCounter::BeginFrame()
+{
+	if (m_counterBuffers[0] == 0)
+	{
+		return;
+	}
+
+	GLint viewport[4] = { 0, 0, 0, 0 };
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	if ((viewport[2] != m_imageWidth) || (viewport[3] != m_imageHeight) || (m_imageID == 0))
+	{
+		if (m_imageID != 0)
+		{
+			glDeleteTextures(1, &m_imageID);
+		}
+		m_imageWidth = viewport[2];
+		m_imageHeight = viewport[3];
+		glCreateTextures(GL_TEXTURE_2D, 1, &m_imageID);
+		glTextureStorage2D(m_imageID, 1, GL_R32UI, m_imageWidth, m_imageHeight);
+	}
+
+	int slot = m_frameSlot;
+	if (m_bCounterPending[slot])
+	{
+		CollectCounters(slot);
+	}
+
+	const GLuint zero = 0;
+	glClearTexImage(m_imageID, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+	glClearNamedBufferData(m_counterBuffers[slot], GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+
+	glBindImageTexture(OVERDRAW_IMAGE_UNIT, m_imageID, 0, GL_FALSE, 0, GL_READ_WRITE, GL_R32UI);
+	glBindBufferBase(GL_ATOMIC_COUNTER_BUFFER, OVERDRAW_COUNTER_BINDING, m_counterBuffers[slot]);
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for ordering the shader writes of
+ *  the frame before the later readback and clears, and for
+ *  moving on to the buffer of the next frame.
+ ***********************************************************/
+void OverdrawCounter::EndFrame()
+{
+	if (m_counterBuffers[0] == 0)
+	{
+		return;
+	}
+
+	glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT | GL_TEXTURE_UPDATE_BARRIER_BIT);
+
+	m_bCounterPending[m_frameSlot] = true;
+	m_frameSlot = (m_frameSlot + 1) % FRAME_COUNT;
+}
+
+/***********************************************************
+ *  CollectCounters()
+ *
+ *  This method is used for reading the totals of an earlier
+ *  frame.  The frame was submitted FRAME_COUNT frames ago,
+ *  so the read seldom has to wait for it.
+ ***********************************************************/
+void OverdrawCounter::CollectCounters(int slot)
+{
+	GLuint counters[COUNTER_COUNT] = { 0, 0 };
+	glGetNamedBufferSubData(m_counterBuffers[slot], 0, sizeof(counters), counters);
+	m_bCounterPending[slot] = false;
+
+	m_shadedFragments = (long long)counters[0];
+	m_coveredPixels = (long long)counters[1];
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for freeing the image and the atomic
+ *  counter buffers.
+ ***********************************************************/
+void OverdrawCounter::Destroy()
+{
+	if (m_imageID != 0)
+	{
+		glDeleteTextures(1, &m_imageID);
+		m_imageID = 0;
+	}
+	m_imageWidth = 0;
+	m_imageHeight = 0;
+
+	if (m_counterBuffers[0] != 0)
+	{
+		glDeleteBuffers(FRAME_COUNT, m_counterBuffers);
+	}
+	for (int slot = 0; slot < FRAME_COUNT; slot++)
+	{
+		m_counterBuffers[slot] = 0;
+		m_bCounterPending[slot] = false;
+	}
+	m_frameSlot = 0;
+}
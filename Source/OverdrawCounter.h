@@ -0,0 +1,70 @@
+///////////////////////////////////////////////////////////////////////////////
+// overdrawcounter.h
+// ============
+// count the fragments shaded at each pixel of the frame
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+/***********************************************************
+ *  OverdrawCounter
+ *
+ *  This class holds the counters the fragment shader fills
+ *  in when it draws the overdraw view: an integer image with
+ *  the number of fragments shaded at each pixel, and two
+ *  atomic counters with the fragments shaded and the pixels
+ *  covered in the whole frame.  Their ratio is the average
+ *  number of times a covered pixel was shaded.
+ *
+ *  The atomic counters of each frame in flight have their
+ *  own buffer, read back a few frames later, so reading the
+ *  totals never waits for the GPU.
+ ***********************************************************/
+class OverdrawCounter
+{
+public:
+	// constructor
+	OverdrawCounter();
+	// destructor
+	~OverdrawCounter();
+
+	// number of frames the totals are read behind
+	static const int FRAME_COUNT = 3;
+
+	// create the atomic counter buffers
+	bool Create();
+	// clear the counters of this frame, sizing the image to the
+	// current viewport, and bind them for the shader
+	void BeginFrame();
+	// make the counter writes of this frame visible to the
+	// readback and to the next clear
+	void EndFrame();
+	// free the image and the buffers
+	void Destroy();
+
+	// get the totals of a recent frame
+	long long GetShadedFragments() const { return(m_shadedFragments); }
+	long long GetCoveredPixels() const { return(m_coveredPixels); }
+
+private:
+	// read the totals of the passed in frame slot
+	void CollectCounters(int slot);
+
+	// image holding the fragment count of each pixel
+	GLuint m_imageID;
+	int m_imageWidth;
+	int m_imageHeight;
+	// atomic counter buffer of each frame in flight, the frame
+	// slot of the next one and whether each holds a result
+	GLuint m_counterBuffers[FRAME_COUNT];
+	bool m_bCounterPending[FRAME_COUNT];
+	int m_frameSlot;
+	// totals of the last frame read back
+	long long m_shadedFragments;
+	long long m_coveredPixels;
+};
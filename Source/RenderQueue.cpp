@@ -0,0 +1,203 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderqueue.cpp
+// ============
+// gather the draws of a frame and sort them by render state
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RenderQueue.h"
+
+#include <algorithm>
+
+// declaration of global variables
+namespace
+{
+	// widths of the fields packed into the sort keys
+	const int MESH_BITS = 6;
+	const int TEXTURE_BITS = 12;
+	const int MATERIAL_BITS = 12;
+	const int DEPTH_BITS = 24;
+	// low bits left unused below the last field
+	const int SPARE_BITS = 9;
+
+	const uint64_t TRANSPARENT_BIT = uint64_t(1) << 63;
+
+	/***********************************************************
+	 *  PackField()
+	 *
+	 *  This function is used for clamping a value to the passed
+	 *  in number of bits.
+	 ***********************************************************/
+	uint64_t PackField(int value, int bits)
+	{
+		uint64_t maximum = (uint64_t(1) << bits) - 1;
+		if (value < 0)
+		{
+			return(0);
+		}
+		return(std::min((uint64_t)value, maximum));
+	}
+}
+
+/***********************************************************
+ *  RenderQueue()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+RenderQueue::RenderQueue()
+{
+	m_farPlane = 100.0f;
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for removing all the items of the
+ *  previous frame.  The memory is kept for the next frame.
+ ***********************************************************/
+void RenderQueue::Clear()
+{
+	m_items.clear();
+}
+
+/***********************************************************
+ *  MakeKey()
+ *
+ *  This method is used for building the 64-bit sort key of
+ *  a draw.  Opaque draws are grouped by mesh, texture and
+ *  material, then drawn near to far so the depth test can
+ *  reject hidden fragments.  Transparent draws come last,
+ *  far to near, so they blend over what is behind them.
+ ***********************************************************/
+uint64_t RenderQueue::MakeKey(
+	int mesh,
+	int textureArray,
+	int materialIndex,
+	bool bTransparent,
+	float viewDepth) const
+{
+	uint64_t maximumDepth = (uint64_t(1) << DEPTH_BITS) - 1;
+	float depthFraction = std::max(0.0f, std::min(viewDepth / m_farPlane, 1.0f));
+	uint64_t depth = uint64_t(depthFraction * float(maximumDepth));
+
+	uint64_t meshField = PackField(mesh, MESH_BITS);
+	uint64_t textureField = PackField(textureArray + 1, TEXTURE_BITS);
+	uint64_t materialField = PackField(materialIndex + 1, MATERIAL_BITS);
+
+	uint64_t key = 0;
+	if (bTransparent)
+	{
+		key = TRANSPARENT_BIT;
+		key |= (maximumDepth - depth) << (MESH_BITS + TEXTURE_BITS + MATERIAL_BITS + SPARE_BITS);
+		key |= meshField << (TEXTURE_BITS + MATERIAL_BITS + SPARE_BITS);
+		key |= textureField << (MATERIAL_BITS + SPARE_BITS);
+		key |= materialField << SPARE_BITS;
+	}
+	else
+	{
+		key |= meshField << (TEXTURE_BITS + MATERIAL_BITS + DEPTH_BITS + SPARE_BITS);
+		key |= textureField << (MATERIAL_BITS + DEPTH_BITS + SPARE_BITS);
+		key |= materialField << (DEPTH_BITS + SPARE_BITS);
+		key |= depth << SPARE_BITS;
+	}
+
+	return(key);
+}
+
+/***********************************************************
+ *  Submit()
+ *
+ *  This method is used for adding a draw to the queue.
+ ***********************************************************/
+void RenderQueue::Submit(
+	int objectIndex,
+	int mesh,
+	int textureArray,
+	int materialIndex,
+	bool bTransparent,
+	float viewDepth)
+{
+	RENDER_ITEM item;
+	item.key = MakeKey(mesh, textureArray, materialIndex, bTransparent, viewDepth);
+	item.objectIndex = objectIndex;
+	item.mesh = mesh;
+	item.textureArray = textureArray;
+	item.materialIndex = materialIndex;
+	item.bTransparent = bTransparent;
+
+	m_items.push_back(item);
+}
+
+/***********************************************************
+ *  CountStateChanges()
+ *
+ *  This method is used for counting how many times the mesh,
+ *  the texture and the material change from one item to the
+ *  next in the current order.  The first item counts as a
+ *  change of each.
+ ***********************************************************/
+void RenderQueue::CountStateChanges(
+	const std::vector<RENDER_ITEM>& items,
+	long long& meshChanges,
+	long long& textureChanges,
+	long long& materialChanges)
+{
+	meshChanges = 0;
+	textureChanges = 0;
+	materialChanges = 0;
+
+	for (size_t i = 0; i < items.size(); i++)
+	{
+		bool bFirst = (i == 0);
+		if (bFirst || (items[i].mesh != items[i - 1].mesh))
+		{
+			meshChanges++;
+		}
+		if (bFirst || (items[i].textureArray != items[i - 1].textureArray))
+		{
+			textureChanges++;
+		}
+		if (bFirst || (items[i].materialIndex != items[i - 1].materialIndex))
+		{
+			materialChanges++;
+		}
+	}
+}
+
+/***********************************************************
+ *  Sort()
+ *
+ *  This method is used for sorting the items by their keys.
+ *  Items with equal keys keep their submission order, so the
+ *  result is the same on every run.  The state changes are
+ *  counted before and after sorting, which shows how many
+ *  changes the sort saved.
+ ***********************************************************/
+void RenderQueue::Sort(RenderStats& stats)
+{
+	long long meshChanges = 0;
+	long long textureChanges = 0;
+	long long materialChanges = 0;
+
+	CountStateChanges(m_items, meshChanges, textureChanges, materialChanges);
+	stats.Set(RenderStats::MESH_CHANGES_UNSORTED, meshChanges);
+	stats.Set(RenderStats::TEXTURE_CHANGES_UNSORTED, textureChanges);
+	stats.Set(RenderStats::MATERIAL_CHANGES_UNSORTED, materialChanges);
+
+	std::sort(m_items.begin(), m_items.end(),
+		[](const RENDER_ITEM& a, const RENDER_ITEM& b)
+		{
+			if (a.key != b.key)
+			{
+				return(a.key < b.key);
+			}
+			return(a.objectIndex < b.objectIndex);
+		});
+
+	CountStateChanges(m_items, meshChanges, textureChanges, materialChanges);
+	stats.Set(RenderStats::MESH_CHANGES, meshChanges);
+	stats.Set(RenderStats::TEXTURE_CHANGES, textureChanges);
+	stats.Set(RenderStats::MATERIAL_CHANGES, materialChanges);
+}
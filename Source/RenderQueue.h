@@ -0,0 +1,95 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderqueue.h
+// ============
+// gather the draws of a frame and sort them by render state
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "RenderStats.h"
+
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  RenderQueue
+ *
+ *  This class collects one item per draw every frame, each
+ *  with a packed 64-bit sort key, then sorts the items so
+ *  that draws sharing the same mesh, texture and material
+ *  are submitted next to each other.
+ *
+ *  Opaque key, from the highest bit down:
+ *    1 bit   transparent flag (0)
+ *    6 bits  mesh
+ *    12 bits texture array + 1
+ *    12 bits material index + 1
+ *    24 bits view depth, near to far
+ *  Transparent key:
+ *    1 bit   transparent flag (1)
+ *    24 bits inverted view depth, far to near
+ *    6 bits  mesh
+ *    12 bits texture array + 1
+ *    12 bits material index + 1
+ ***********************************************************/
+class RenderQueue
+{
+public:
+	// constructor
+	RenderQueue();
+
+	struct RENDER_ITEM
+	{
+		uint64_t key;
+		int objectIndex;
+		int mesh;
+		int textureArray;
+		int materialIndex;
+		bool bTransparent;
+	};
+
+	// remove all the items of the previous frame
+	void Clear();
+	// add a draw to the queue
+	void Submit(
+		int objectIndex,
+		int mesh,
+		int textureArray,
+		int materialIndex,
+		bool bTransparent,
+		float viewDepth);
+	// sort the items by their keys and count the state changes
+	// before and after sorting into the passed in stats
+	void Sort(RenderStats& stats);
+
+	// get the sorted items
+	const std::vector<RENDER_ITEM>& GetItems() const { return(m_items); }
+
+	// set the depth range that is quantized into the keys
+	void SetDepthRange(float farPlane) { m_farPlane = farPlane; }
+
+	// build the sort key of a draw
+	uint64_t MakeKey(
+		int mesh,
+		int textureArray,
+		int materialIndex,
+		bool bTransparent,
+		float viewDepth) const;
+
+private:
+	// draws of the current frame
+	std::vector<RENDER_ITEM> m_items;
+	// distance of the far plane used for quantizing the depth
+	float m_farPlane;
+
+	// count the mesh, texture and material changes of the items
+	// in their current order
+	static void CountStateChanges(
+		const std::vector<RENDER_ITEM>& items,
+		long long& meshChanges,
+		long long& textureChanges,
+		long long& materialChanges);
+};
@@ -0,0 +1,79 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderstats.cpp
+// ============
+// per-frame counters reported by the renderer
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RenderStats.h"
+
+// declaration of global variables
+namespace
+{
+	// counter names, in the same order as COUNTER_ID
+	const char* g_CounterNames[RenderStats::COUNTER_COUNT] =
+	{
+		"draw_calls",
+		"triangles",
+		"mesh_bytes",
+		"mesh_changes",
+		"mesh_changes_unsorted",
+		"texture_changes",
+		"texture_changes_unsorted",
+		"material_changes",
+		"material_changes_unsorted",
+		"instanced_draws",
+		"instances",
+		"indirect_commands",
+		"visible_objects",
+		"culled_objects",
+		"visible_lights",
+		"cluster_light_indices",
+		"cluster_build_us",
+		"light_bytes_uploaded",
+		"shadow_casters",
+		"shadow_gpu_us",
+		"shadow_saved_us",
+		"depth_prepass_commands",
+		"shaded_fragments",
+		"covered_pixels",
+		"state_calls_issued",
+		"state_calls_elided"
+	};
+}
+
+/***********************************************************
+ *  RenderStats()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+RenderStats::RenderStats()
+{
+	Reset();
+}
+
+/***********************************************************
+ *  Reset()
+ *
+ *  This method is used for setting all the counters back
+ *  to zero at the start of a frame.
+ ***********************************************************/
+void RenderStats::Reset()
+{
+	for (int i = 0; i < COUNTER_COUNT; i++)
+	{
+		m_counters[i] = 0;
+	}
+}
+
+/***********************************************************
+ *  GetName()
+ *
+ *  This method returns the name of the passed in counter.
+ ***********************************************************/
+const char* RenderStats::GetName(COUNTER_ID counterID)
+{
+	return(g_CounterNames[counterID]);
+}
@@ -0,0 +1,72 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderstats.h
+// ============
+// per-frame counters reported by the renderer
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+/***********************************************************
+ *  RenderStats
+ *
+ *  This class holds the counters that the renderer fills in
+ *  while drawing one frame, such as the number of draw calls
+ *  and state changes.  The counters are reset at the start
+ *  of every frame and can be read by the frame benchmark.
+ ***********************************************************/
+class RenderStats
+{
+public:
+	// IDs of the per-frame counters
+	enum COUNTER_ID
+	{
+		DRAW_CALLS = 0,
+		TRIANGLES,
+		MESH_BYTES,
+		MESH_CHANGES,
+		MESH_CHANGES_UNSORTED,
+		TEXTURE_CHANGES,
+		TEXTURE_CHANGES_UNSORTED,
+		MATERIAL_CHANGES,
+		MATERIAL_CHANGES_UNSORTED,
+		INSTANCED_DRAWS,
+		INSTANCES,
+		INDIRECT_COMMANDS,
+		VISIBLE_OBJECTS,
+		CULLED_OBJECTS,
+		VISIBLE_LIGHTS,
+		CLUSTER_LIGHT_INDICES,
+		CLUSTER_BUILD_MICROSECONDS,
+		LIGHT_BYTES_UPLOADED,
+		SHADOW_CASTERS,
+		SHADOW_GPU_MICROSECONDS,
+		SHADOW_SAVED_MICROSECONDS,
+		DEPTH_PREPASS_COMMANDS,
+		SHADED_FRAGMENTS,
+		COVERED_PIXELS,
+		STATE_CALLS_ISSUED,
+		STATE_CALLS_ELIDED,
+		COUNTER_COUNT
+	};
+
+	// constructor
+	RenderStats();
+
+	// set all the counters back to zero
+	void Reset();
+	// add to or set the value of a counter
+	void Add(COUNTER_ID counterID, long long value) { m_counters[counterID] += value; }
+	void Set(COUNTER_ID counterID, long long value) { m_counters[counterID] = value; }
+	// get the value of a counter
+	long long Get(COUNTER_ID counterID) const { return(m_counters[counterID]); }
+
+	// get the name of a counter as written in reports
+	static const char* GetName(COUNTER_ID counterID);
+
+private:
+	// current values of the counters
+	long long m_counters[COUNTER_COUNT];
+};
@@ -8,6 +8,9 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "SceneManager.h"
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "ShaderBindings.h"
 
 #ifndef STB_IMAGE_IMPLEMENTATION
 #define STB_IMAGE_IMPLEMENTATION
@@ -15,15 +18,86 @@
 #endif
 
 #include <glm/gtx/transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
 
 // declaration of global variables
 namespace
 {
-	const char* g_ModelName = "model";
-	const char* g_ColorValueName = "objectColor";
-	const char* g_TextureValueName = "objectTexture";
-	const char* g_UseTextureName = "bUseTexture";
-	const char* g_UseLightingName = "bUseLighting";
+	// most decoded texture images uploaded in one frame
+	const int MAX_TEXTURE_UPLOADS_PER_FRAME = 2;
+
+	// smallest run of equal draws that is drawn instanced
+	const int MIN_INSTANCED_BATCH = 2;
+
+	// smallest bounding radius on screen, as a fraction of the
+	// viewport height, drawn at each detail level but the last
+	const float g_DetailScreenSizes[ShapeGeometry::DETAIL_LEVEL_COUNT - 1] = { 0.25f, 0.1f, 0.04f };
+	// how far past a level boundary the size must move before
+	// the level changes, so objects near it do not flicker
+	const float DETAIL_HYSTERESIS = 0.2f;
+
+	/***********************************************************
+	 *  CreateShape()
+	 *
+	 *  This function is used for building the geometry of one
+	 *  of the basic meshes at the passed in detail level.
+	 ***********************************************************/
+	ShapeGeometry::SHAPE_GEOMETRY CreateShape(int mesh, int detailLevel)
+	{
+		switch (mesh)
+		{
+		case SceneManager::MESH_PLANE:
+			return(ShapeGeometry::CreatePlane());
+		case SceneManager::MESH_BOX:
+			return(ShapeGeometry::CreateBox());
+		case SceneManager::MESH_CYLINDER:
+			return(ShapeGeometry::CreateCylinder(detailLevel));
+		case SceneManager::MESH_TORUS:
+			return(ShapeGeometry::CreateTorus(detailLevel));
+		case SceneManager::MESH_TAPERED_CYLINDER:
+			return(ShapeGeometry::CreateTaperedCylinder(detailLevel));
+		default:
+			return(ShapeGeometry::CreateSphere(detailLevel));
+		}
+	}
+
+	/***********************************************************
+	 *  GetFarPlane()
+	 *
+	 *  This function is used for getting the distance of the
+	 *  far plane of a perspective or orthographic projection
+	 *  matrix built by glm.
+	 ***********************************************************/
+	float GetFarPlane(const glm::mat4& projection)
+	{
+		// only a perspective projection divides by the depth
+		if (projection[2][3] != 0.0f)
+		{
+			return(projection[3][2] / (projection[2][2] + 1.0f));
+		}
+		return((projection[3][2] - 1.0f) / projection[2][2]);
+	}
+
+	// scene file loaded when no other file is set
+	const char* g_DefaultSceneFile = "Scenes/desk.scene";
+	// file the optimized shape meshes are saved to
+	const char* g_DefaultMeshCacheFile = "shapes.meshcache";
+
+	// mesh names used in the scene file, in the same order as MESH_TYPE
+	const char* g_MeshNames[SceneManager::MESH_TYPE_COUNT] =
+	{
+		"plane",
+		"box",
+		"cylinder",
+		"torus",
+		"tapered_cylinder",
+		"sphere"
+	};
 }
 
 /***********************************************************
@@ -31,10 +105,38 @@ namespace
  *
  *  The constructor for the class
  ***********************************************************/
-SceneManager::SceneManager(ShaderManager *pShaderManager)
+SceneManager::SceneManager(ShaderManager *pShaderManager, UniformCache* pUniformCache)
 {
 	m_pShaderManager = pShaderManager;
-	m_basicMeshes = new ShapeMeshes();
+	m_pUniformCache = pUniformCache;
+	m_stateCache = new StateCache();
+	m_meshArena = new MeshArena(m_stateCache);
+	m_textureManager = new TextureManager(m_stateCache);
+	m_instancedMeshes = new InstancedMeshes(m_meshArena);
+	m_bInstancing = false;
+	m_frustumCuller = new FrustumCuller();
+	m_materialBuffer = new MaterialBuffer();
+	m_renderQueue = new RenderQueue();
+	m_lightManager = new LightManager();
+	m_lightClusters = new LightClusters();
+	m_bClusteredLights = false;
+	m_shadowMaps = new ShadowMaps(m_instancedMeshes, m_stateCache);
+	m_shadowProgramID = 0;
+	m_bShadows = false;
+	m_bShadowCache = true;
+	m_shadowBoundsCenter = glm::vec3(0.0f);
+	m_shadowBoundsExtent = glm::vec3(0.0f);
+	m_bShadowBoundsDirty = true;
+	m_depthProgramID = 0;
+	m_bDepthPrepass = false;
+	m_bOverdraw = false;
+	m_overdrawCounter = new OverdrawCounter();
+	m_bIndirectDraws = true;
+	m_bCompactVertices = false;
+	m_sceneFilename = g_DefaultSceneFile;
+	m_meshCacheFilename = g_DefaultMeshCacheFile;
+	m_viewMatrix = glm::mat4(1.0f);
+	m_projectionMatrix = glm::mat4(1.0f);
 }
 
 /***********************************************************
@@ -45,164 +147,114 @@ SceneManager::SceneManager(ShaderManager *pShaderManager)
 SceneManager::~SceneManager()
 {
 	m_pShaderManager = NULL;
-	delete m_basicMeshes;
-	m_basicMeshes = NULL;
+	m_pUniformCache = NULL;
+	delete m_textureManager;
+	m_textureManager = NULL;
+	delete m_shadowMaps;
+	m_shadowMaps = NULL;
+	delete m_overdrawCounter;
+	m_overdrawCounter = NULL;
+	delete m_instancedMeshes;
+	m_instancedMeshes = NULL;
+	delete m_meshArena;
+	m_meshArena = NULL;
+	delete m_frustumCuller;
+	m_frustumCuller = NULL;
+	delete m_materialBuffer;
+	m_materialBuffer = NULL;
+	delete m_renderQueue;
+	m_renderQueue = NULL;
+	delete m_lightClusters;
+	m_lightClusters = NULL;
+	delete m_lightManager;
+	m_lightManager = NULL;
+	delete m_stateCache;
+	m_stateCache = NULL;
 }
 
 /***********************************************************
  *  CreateGLTexture()
  *
- *  This method is used for loading textures from image files,
- *  configuring the texture mapping parameters in OpenGL,
- *  generating the mipmaps, and loading the read texture into
- *  the next available texture slot in memory.
+ *  This method is used for adding a texture for the passed
+ *  in image file to the texture arrays.  The texture shows a
+ *  placeholder at first; the image is decoded on a worker
+ *  thread and copied into its array layer, along with its
+ *  mipmaps, when it is ready.  False is returned when the
+ *  texture could not be added.
  ***********************************************************/
 bool SceneManager::CreateGLTexture(const char* filename, std::string tag)
 {
-	int width = 0;
-	int height = 0;
-	int colorChannels = 0;
-	GLuint textureID = 0;
-
-	// indicate to always flip images vertically when loaded
-	stbi_set_flip_vertically_on_load(true);
-
-	// try to parse the image data from the specified image file
-	unsigned char* image = stbi_load(
-		filename,
-		&width,
-		&height,
-		&colorChannels,
-		0);
-
-	// if the image was successfully read from the image file
-	if (image)
-	{
-		std::cout << "Successfully loaded image:" << filename << ", width:" << width << ", height:" << height << ", channels:" << colorChannels << std::endl;
-
-		glGenTextures(1, &textureID);
-		glBindTexture(GL_TEXTURE_2D, textureID);
-
-		// set the texture wrapping parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		// set texture filtering parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		// if the loaded image is in RGB format
-		if (colorChannels == 3)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, image);
-		// if the loaded image is in RGBA format - it supports transparency
-		else if (colorChannels == 4)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-		else
-		{
-			std::cout << "Not implemented to handle image with " << colorChannels << " channels" << std::endl;
-			return false;
-		}
-
-		// generate the texture mipmaps for mapping textures to lower resolutions
-		glGenerateMipmap(GL_TEXTURE_2D);
-
-		// free the image data from local memory
-		stbi_image_free(image);
-		glBindTexture(GL_TEXTURE_2D, 0); // Unbind the texture
-
-		// register the loaded texture and associate it with the special tag string
-		m_textureIDs[m_loadedTextures].ID = textureID;
-		m_textureIDs[m_loadedTextures].tag = tag;
-		m_loadedTextures++;
-
-		return true;
+	if (m_textureManager->CreateTexture(filename, tag) < 0)
+	{
+		std::cout << "Could not add texture:" << filename << std::endl;
+		return false;
 	}
 
-	std::cout << "Could not load image:" << filename << std::endl;
-
-	// Error loading the image
-	return false;
+	return true;
 }
 
 /***********************************************************
  *  BindGLTextures()
  *
- *  This method is used for binding the loaded textures to
- *  OpenGL texture memory slots.  There are up to 16 slots.
+ *  This method is used for binding each texture array to
+ *  its own texture unit.  The arrays stay bound, and a draw
+ *  only selects a unit and a layer.
  ***********************************************************/
 void SceneManager::BindGLTextures()
 {
-	for (int i = 0; i < m_loadedTextures; i++)
-	{
-		// bind textures on corresponding texture units
-		glActiveTexture(GL_TEXTURE0 + i);
-		glBindTexture(GL_TEXTURE_2D, m_textureIDs[i].ID);
-	}
+	m_textureManager->BindArrays();
 }
 
 /***********************************************************
  *  DestroyGLTextures()
  *
  *  This method is used for freeing the memory in all the
- *  used texture memory slots.
+ *  texture arrays.
  ***********************************************************/
 void SceneManager::DestroyGLTextures()
 {
-	for (int i = 0; i < m_loadedTextures; i++)
-	{
-		glGenTextures(1, &m_textureIDs[i].ID);
-	}
+	m_textureManager->Destroy();
 }
 
 /***********************************************************
- *  FindTextureID()
+ *  FindTextureIndex()
  *
- *  This method is used for getting an ID for the previously
- *  loaded texture bitmap associated with the passed in tag.
+ *  This method is used for getting the index of the
+ *  previously loaded texture associated with the passed
+ *  in tag.
  ***********************************************************/
-int SceneManager::FindTextureID(std::string tag)
+int SceneManager::FindTextureIndex(const std::string& tag) const
 {
-	int textureID = -1;
-	int index = 0;
-	bool bFound = false;
-
-	while ((index < m_loadedTextures) && (bFound == false))
-	{
-		if (m_textureIDs[index].tag.compare(tag) == 0)
-		{
-			textureID = m_textureIDs[index].ID;
-			bFound = true;
-		}
-		else
-			index++;
-	}
-
-	return(textureID);
+	return(m_textureManager->FindTexture(tag));
 }
 
 /***********************************************************
- *  FindTextureSlot()
+ *  FindTextureIndex()
  *
- *  This method is used for getting a slot index for the previously
- *  loaded texture bitmap associated with the passed in tag.
+ *  This method is used for getting the index of the texture
+ *  of a tag hashed at compile time with TAG_ID.
  ***********************************************************/
-int SceneManager::FindTextureSlot(std::string tag)
+int SceneManager::FindTextureIndex(uint32_t hash, const char* tag) const
 {
-	int textureSlot = -1;
-	int index = 0;
-	bool bFound = false;
+	return(m_textureManager->FindTexture(hash, tag));
+}
 
-	while ((index < m_loadedTextures) && (bFound == false))
+/***********************************************************
+ *  AddMaterial()
+ *
+ *  This method is used for adding a material to the defined
+ *  materials list and registering its tag for the index.
+ *  No material is added for a tag that is already taken.
+ ***********************************************************/
+bool SceneManager::AddMaterial(const OBJECT_MATERIAL& material)
+{
+	if (!m_materialTags.Add(material.tag, (int)m_objectMaterials.size()))
 	{
-		if (m_textureIDs[index].tag.compare(tag) == 0)
-		{
-			textureSlot = index;
-			bFound = true;
-		}
-		else
-			index++;
+		return false;
 	}
+	m_objectMaterials.push_back(material);
 
-	return(textureSlot);
+	return true;
 }
 
 /***********************************************************
@@ -210,34 +262,74 @@ int SceneManager::FindTextureSlot(std::string tag)
  *
  *  This method is used for getting a material from the previously
  *  defined materials list that is associated with the passed in tag.
+ *  The material is left unchanged when the tag is not found.
  ***********************************************************/
-bool SceneManager::FindMaterial(std::string tag, OBJECT_MATERIAL& material)
+bool SceneManager::FindMaterial(const std::string& tag, OBJECT_MATERIAL& material) const
 {
-	if (m_objectMaterials.size() == 0)
+	int index = FindMaterialIndex(tag);
+	if (index < 0)
 	{
 		return(false);
 	}
 
-	int index = 0;
-	bool bFound = false;
-	while ((index < m_objectMaterials.size()) && (bFound == false))
+	material = m_objectMaterials[index];
+
+	return(true);
+}
+
+/***********************************************************
+ *  FindMaterialIndex()
+ *
+ *  This method is used for getting the index of a material
+ *  in the previously defined materials list that is
+ *  associated with the passed in tag, or -1 if not found.
+ ***********************************************************/
+int SceneManager::FindMaterialIndex(const std::string& tag) const
+{
+	return(m_materialTags.Find(tag));
+}
+
+/***********************************************************
+ *  FindMaterialIndex()
+ *
+ *  This method is used for getting the index of the material
+ *  of a tag hashed at compile time with TAG_ID.
+ ***********************************************************/
+int SceneManager::FindMaterialIndex(uint32_t hash, const char* tag) const
+{
+	return(m_materialTags.Find(hash, tag));
+}
+
+/***********************************************************
+ *  UploadMaterialBuffer()
+ *
+ *  This method is used for packing all the defined object
+ *  materials into the material uniform buffer, in the same
+ *  order as the materials list, so that a draw only needs
+ *  to pass the index of its material to the shader.
+ ***********************************************************/
+void SceneManager::UploadMaterialBuffer()
+{
+	// shaders without the material block keep using the
+	// individual material uniforms
+	if ((NULL == m_pUniformCache) ||
+		(m_materialBuffer->AttachProgram(m_pUniformCache->GetProgramID()) == false))
 	{
-		if (m_objectMaterials[index].tag.compare(tag) == 0)
-		{
-			bFound = true;
-			material.ambientColor = m_objectMaterials[index].ambientColor;
-			material.ambientStrength = m_objectMaterials[index].ambientStrength;
-			material.diffuseColor = m_objectMaterials[index].diffuseColor;
-			material.specularColor = m_objectMaterials[index].specularColor;
-			material.shininess = m_objectMaterials[index].shininess;
-		}
-		else
-		{
-			index++;
-		}
+		return;
 	}
 
-	return(true);
+	std::vector<MaterialBuffer::GPU_MATERIAL> materials(m_objectMaterials.size());
+	for (size_t i = 0; i < m_objectMaterials.size(); i++)
+	{
+		materials[i].ambientColor = m_objectMaterials[i].ambientColor;
+		materials[i].ambientStrength = m_objectMaterials[i].ambientStrength;
+		materials[i].diffuseColor = m_objectMaterials[i].diffuseColor;
+		materials[i].shininess = m_objectMaterials[i].shininess;
+		materials[i].specularColor = m_objectMaterials[i].specularColor;
+		materials[i].padding = 0.0f;
+	}
+
+	m_materialBuffer->Upload(materials);
 }
 
 /***********************************************************
@@ -252,6 +344,27 @@ void SceneManager::SetTransformations(
 	float YrotationDegrees,
 	float ZrotationDegrees,
 	glm::vec3 positionXYZ)
+{
+	SetModelMatrix(CalculateModelMatrix(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ));
+}
+
+/***********************************************************
+ *  CalculateModelMatrix()
+ *
+ *  This method is used for building the world matrix from
+ *  the passed in transformation values.
+ ***********************************************************/
+glm::mat4 SceneManager::CalculateModelMatrix(
+	glm::vec3 scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	glm::vec3 positionXYZ)
 {
 	// variables for this method
 	glm::mat4 modelView;
@@ -272,9 +385,20 @@ void SceneManager::SetTransformations(
 
 	modelView = translation * rotationX * rotationY * rotationZ * scale;
 
-	if (NULL != m_pShaderManager)
+	return(modelView);
+}
+
+/***********************************************************
+ *  SetModelMatrix()
+ *
+ *  This method is used for setting a prepared world matrix
+ *  into the shader.
+ ***********************************************************/
+void SceneManager::SetModelMatrix(const glm::mat4& modelMatrix)
+{
+	if (NULL != m_pUniformCache)
 	{
-		m_pShaderManager->setMat4Value(g_ModelName, modelView);
+		m_pUniformCache->SetMat4(UniformCache::UNIFORM_MODEL, modelMatrix);
 	}
 }
 
@@ -298,10 +422,10 @@ void SceneManager::SetShaderColor(
 	currentColor.b = blueColorValue;
 	currentColor.a = alphaValue;
 
-	if (NULL != m_pShaderManager)
+	if (NULL != m_pUniformCache)
 	{
-		m_pShaderManager->setIntValue(g_UseTextureName, false);
-		m_pShaderManager->setVec4Value(g_ColorValueName, currentColor);
+		m_pUniformCache->SetBool(UniformCache::UNIFORM_USE_TEXTURE, false);
+		m_pUniformCache->SetVec4(UniformCache::UNIFORM_OBJECT_COLOR, currentColor);
 	}
 }
 
@@ -312,16 +436,47 @@ void SceneManager::SetShaderColor(
  *  associated with the passed in ID into the shader.
  ***********************************************************/
 void SceneManager::SetShaderTexture(
-	std::string textureTag)
+	const std::string& textureTag)
 {
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setIntValue(g_UseTextureName, true);
+	int textureIndex = -1;
+	textureIndex = FindTextureIndex(textureTag);
+	SetShaderTexture(textureIndex);
+}
+
+/***********************************************************
+ *  SetShaderTexture()
+ *
+ *  This method is used for setting the texture of a tag
+ *  literal into the shader, without hashing it per call:
+ *    SetShaderTexture(TAG_ID("mug"));
+ ***********************************************************/
+void SceneManager::SetShaderTexture(
+	uint32_t tagHash,
+	const char* textureTag)
+{
+	SetShaderTexture(FindTextureIndex(tagHash, textureTag));
+}
 
-		int textureID = -1;
-		textureID = FindTextureSlot(textureTag);
-		m_pShaderManager->setSampler2DValue(g_TextureValueName, textureID);
+/***********************************************************
+ *  SetShaderTexture()
+ *
+ *  This method is used for setting the texture that was
+ *  resolved ahead of time into the shader, as the texture
+ *  unit of its array and its layer in that array.
+ ***********************************************************/
+void SceneManager::SetShaderTexture(
+	int textureIndex)
+{
+	if ((NULL == m_pUniformCache) ||
+		(textureIndex < 0) ||
+		(textureIndex >= m_textureManager->GetTextureCount()))
+	{
+		return;
 	}
+
+	m_pUniformCache->SetBool(UniformCache::UNIFORM_USE_TEXTURE, true);
+	m_pUniformCache->SetSampler(UniformCache::UNIFORM_OBJECT_TEXTURE, m_textureManager->GetArrayIndex(textureIndex));
+	m_pUniformCache->SetInt(UniformCache::UNIFORM_TEXTURE_LAYER, m_textureManager->GetLayer(textureIndex));
 }
 
 /***********************************************************
@@ -332,9 +487,9 @@ void SceneManager::SetShaderTexture(
  ***********************************************************/
 void SceneManager::SetTextureUVScale(float u, float v)
 {
-	if (NULL != m_pShaderManager)
+	if (NULL != m_pUniformCache)
 	{
-		m_pShaderManager->setVec2Value("UVscale", glm::vec2(u, v));
+		m_pUniformCache->SetVec2(UniformCache::UNIFORM_UV_SCALE, glm::vec2(u, v));
 	}
 }
 
@@ -345,611 +500,1710 @@ void SceneManager::SetTextureUVScale(float u, float v)
  *  into the shader.
  ***********************************************************/
 void SceneManager::SetShaderMaterial(
-	std::string materialTag)
+	const std::string& materialTag)
 {
-	if (m_objectMaterials.size() > 0)
+	int materialIndex = FindMaterialIndex(materialTag);
+	if (materialIndex >= 0)
 	{
-		OBJECT_MATERIAL material;
-		bool bReturn = false;
+		SetShaderMaterial(materialIndex);
+	}
+}
 
-		bReturn = FindMaterial(materialTag, material);
-		if (bReturn == true)
-		{
-			m_pShaderManager->setVec3Value("material.ambientColor", material.ambientColor);
-			m_pShaderManager->setFloatValue("material.ambientStrength", material.ambientStrength);
-			m_pShaderManager->setVec3Value("material.diffuseColor", material.diffuseColor);
-			m_pShaderManager->setVec3Value("material.specularColor", material.specularColor);
-			m_pShaderManager->setFloatValue("material.shininess", material.shininess);
-		}
+/***********************************************************
+ *  SetShaderMaterial()
+ *
+ *  This method is used for passing the material of a tag
+ *  literal into the shader, without hashing it per call:
+ *    SetShaderMaterial(TAG_ID("wood"));
+ ***********************************************************/
+void SceneManager::SetShaderMaterial(
+	uint32_t tagHash,
+	const char* materialTag)
+{
+	SetShaderMaterial(FindMaterialIndex(tagHash, materialTag));
+}
+
+/***********************************************************
+ *  SetShaderMaterial()
+ *
+ *  This method is used for passing the material at the
+ *  passed in index of the materials list into the shader.
+ ***********************************************************/
+void SceneManager::SetShaderMaterial(
+	int materialIndex)
+{
+	if ((NULL == m_pUniformCache) ||
+		(materialIndex < 0) ||
+		(materialIndex >= (int)m_objectMaterials.size()))
+	{
+		return;
+	}
+
+	// when the materials are in the uniform buffer, only the
+	// index of the material is passed to the shader
+	if (m_materialBuffer->IsReady())
+	{
+		m_pUniformCache->SetInt(UniformCache::UNIFORM_MATERIAL_INDEX, materialIndex);
+	}
+	else
+	{
+		const OBJECT_MATERIAL& material = m_objectMaterials[materialIndex];
+
+		m_pUniformCache->SetVec3(UniformCache::UNIFORM_MATERIAL_AMBIENT_COLOR, material.ambientColor);
+		m_pUniformCache->SetFloat(UniformCache::UNIFORM_MATERIAL_AMBIENT_STRENGTH, material.ambientStrength);
+		m_pUniformCache->SetVec3(UniformCache::UNIFORM_MATERIAL_DIFFUSE_COLOR, material.diffuseColor);
+		m_pUniformCache->SetVec3(UniformCache::UNIFORM_MATERIAL_SPECULAR_COLOR, material.specularColor);
+		m_pUniformCache->SetFloat(UniformCache::UNIFORM_MATERIAL_SHININESS, material.shininess);
 	}
 }
 
-/**************************************************************/
-/*** STUDENTS CAN MODIFY the code in the methods BELOW for  ***/
-/*** preparing and rendering their own 3D replicated scenes.***/
-/*** Please refer to the code in the OpenGL sample project  ***/
-/*** for assistance.                                        ***/
-/**************************************************************/
+/***********************************************************
+ *  SetSceneFile()
+ *
+ *  This method is used for setting the path of the scene
+ *  file that is loaded by PrepareScene().
+ ***********************************************************/
+void SceneManager::SetSceneFile(const std::string& filename)
+{
+	m_sceneFilename = filename;
+}
 
-/**************************************************************/
-/*** The code in the methods BELOW is for preparing and     ***/
-/*** rendering the 3D replicated scenes.                    ***/
-/**************************************************************/
+/***********************************************************
+ *  FinishTextureLoading()
+ *
+ *  This method is used for blocking until all the texture
+ *  images are decoded and uploaded, so that the next frame
+ *  is drawn with the final textures instead of placeholders.
+ ***********************************************************/
+void SceneManager::FinishTextureLoading()
+{
+	m_textureManager->WaitForAll();
+}
 
 /***********************************************************
- *  LoadSceneTextures()
+ *  LoadSceneFile()
  *
- *  This method is used for preparing the 3D scene by loading
- *  the shapes, textures in memory to support the 3D scene
- *  rendering
+ *  This method is used for reading the scene objects from
+ *  the passed in scene file.  Each object is a block of
+ *  keyword lines between "object <name>" and "end"; lines
+ *  starting with '#' are comments.  The texture and material
+ *  tags are resolved to a texture index and material index
+ *  here, so rendering never searches for them by name.  An
+ *  "array" line repeats the object on a regular grid, each
+ *  copy named with its index.  A "dynamic" line marks an
+ *  object that will move, so it stays out of the cached
+ *  shadow maps.  Point lights are blocks between
+ *  "light <name>" and "end", and can be repeated the same
+ *  way.  A "texture <tag> <path>" line outside of the blocks
+ *  adds a texture, and a block between "material <tag>" and
+ *  "end" adds a material, which the objects after them can
+ *  use.  A block with an unknown keyword or invalid values
+ *  is dropped, and false is returned when the file could
+ *  not be read or any of its lines was rejected.
  ***********************************************************/
-void SceneManager::LoadSceneTextures()
+bool SceneManager::LoadSceneFile(const std::string& filename)
 {
-	bool bReturn = false;
+	std::ifstream file(filename);
+	if (!file)
+	{
+		std::cout << "Could not open scene file:" << filename << std::endl;
+		return false;
+	}
 
-	bReturn = CreateGLTexture(
-		"../../Utilities/textures/stainless.jpg",
-		"stand");
+	std::string line;
+	int lineNumber = 0;
+	bool bInObject = false;
+	bool bInLight = false;
+	bool bInMaterial = false;
+	bool bValid = true;
+	// false once any line or block of the file was rejected
+	bool bFileValid = true;
+	int blockLine = 0;
+	SCENE_OBJECT object;
+	LightManager::GPU_LIGHT light;
+	OBJECT_MATERIAL material;
+	glm::ivec3 arrayCount(1, 1, 1);
+	glm::vec3 arraySpacing(0.0f, 0.0f, 0.0f);
+
+	while (std::getline(file, line))
+	{
+		lineNumber++;
 
-	bReturn = CreateGLTexture(
-		"../../Utilities/textures/cheese_wheel.jpg",
-		"mug");
+		std::istringstream values(line);
+		std::string keyword;
+		if (!(values >> keyword) || (keyword[0] == '#'))
+		{
+			continue;
+		}
 
-	bReturn = CreateGLTexture(
-		"../../Utilities/textures/drywall.jpg",
-		"screen");
+		// "material" inside an object block names its material
+		bool bMaterialBlock = (keyword == "material") && !bInObject;
+		if ((keyword == "object") || (keyword == "light") || bMaterialBlock)
+		{
+			if (bInObject || bInLight || bInMaterial)
+			{
+				std::cout << filename << "(" << blockLine << "): block is missing its 'end' and was dropped" << std::endl;
+				bFileValid = false;
+			}
+			blockLine = lineNumber;
+		}
 
-	bReturn = CreateGLTexture(
-		"../../Utilities/textures/tilesf2.jpg",
-		"handle");
+		if (keyword == "object")
+		{
+			// default values for the properties a block may leave out
+			object.name.clear();
+			values >> object.name;
+			object.mesh = MESH_BOX;
+			object.scaleXYZ = glm::vec3(1.0f, 1.0f, 1.0f);
+			object.rotationDegrees = glm::vec3(0.0f, 0.0f, 0.0f);
+			object.positionXYZ = glm::vec3(0.0f, 0.0f, 0.0f);
+			object.textureTag.clear();
+			object.materialTag.clear();
+			object.uvScale = glm::vec2(1.0f, 1.0f);
+			object.color = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+			object.textureIndex = -1;
+			object.materialIndex = -1;
+			object.modelMatrix = glm::mat4(1.0f);
+			object.bTransformDirty = true;
+			object.boundsRadius = 0.0f;
+			object.detailLevel = 0;
+			object.bDynamic = false;
+			arrayCount = glm::ivec3(1, 1, 1);
+			arraySpacing = glm::vec3(0.0f, 0.0f, 0.0f);
+			bInObject = true;
+			bInLight = false;
+			bInMaterial = false;
+			bValid = true;
+			continue;
+		}
 
-	bReturn = CreateGLTexture(
-		"../../Utilities/textures/stainless_end.jpg",
-		"base");
+		if (keyword == "light")
+		{
+			// a white light with no ambient part by default
+			light.position = glm::vec3(0.0f, 0.0f, 0.0f);
+			light.radius = 5.0f;
+			light.ambientColor = glm::vec3(0.0f, 0.0f, 0.0f);
+			light.focalStrength = 32.0f;
+			light.diffuseColor = glm::vec3(1.0f, 1.0f, 1.0f);
+			light.specularIntensity = 1.0f;
+			light.specularColor = glm::vec3(1.0f, 1.0f, 1.0f);
+			light.padding = 0.0f;
+			arrayCount = glm::ivec3(1, 1, 1);
+			arraySpacing = glm::vec3(0.0f, 0.0f, 0.0f);
+			bInObject = false;
+			bInLight = true;
+			bInMaterial = false;
+			bValid = true;
+			continue;
+		}
 
-	bReturn = CreateGLTexture(
-		"../../Utilities/textures/knife_handle.jpg",
-		"plane");
+		if (bMaterialBlock)
+		{
+			// a dull gray surface by default
+			material.tag.clear();
+			values >> material.tag;
+			material.ambientColor = glm::vec3(0.1f, 0.1f, 0.1f);
+			material.ambientStrength = 0.2f;
+			material.diffuseColor = glm::vec3(0.5f, 0.5f, 0.5f);
+			material.specularColor = glm::vec3(0.1f, 0.1f, 0.1f);
+			material.shininess = 1.0f;
+			bInObject = false;
+			bInLight = false;
+			bInMaterial = true;
+			bValid = !material.tag.empty();
+			if (!bValid)
+			{
+				std::cout << filename << "(" << lineNumber << "): material block is missing its tag" << std::endl;
+			}
+			continue;
+		}
 
-	// after the texture image data is loaded into memory, the
-	// loaded textures need to be bound to texture slots - there
-	// are a total of 16 available slots for scene textures
-	BindGLTextures();
-}
-void SceneManager::DefineObjectMaterials()
-{
-	OBJECT_MATERIAL mugMaterial;
-	mugMaterial.ambientColor = glm::vec3(0.1f, 0.1f, 0.1f);
-	mugMaterial.ambientStrength = 0.2f;
-	mugMaterial.diffuseColor = glm::vec3(0.5f, 0.5f, 0.5f);
-	mugMaterial.specularColor = glm::vec3(0.1f, 0.1f, 0.1f);
-	mugMaterial.shininess = 0.3;
-	mugMaterial.tag = "cheesy";
+		if (bInMaterial)
+		{
+			if (keyword == "ambient")
+			{
+				values >> material.ambientColor.r >> material.ambientColor.g >> material.ambientColor.b;
+			}
+			else if (keyword == "ambientstrength")
+			{
+				values >> material.ambientStrength;
+			}
+			else if (keyword == "diffuse")
+			{
+				values >> material.diffuseColor.r >> material.diffuseColor.g >> material.diffuseColor.b;
+			}
+			else if (keyword == "specular")
+			{
+				values >> material.specularColor.r >> material.specularColor.g >> material.specularColor.b;
+			}
+			else if (keyword == "shininess")
+			{
+				values >> material.shininess;
+			}
+			else if (keyword == "end")
+			{
+				if (!bValid || !AddMaterial(material))
+				{
+					std::cout << filename << "(" << lineNumber << "): material '" << material.tag << "' was dropped" << std::endl;
+					bFileValid = false;
+				}
+				bInMaterial = false;
+				continue;
+			}
+			else
+			{
+				std::cout << filename << "(" << lineNumber << "): unknown material keyword '" << keyword << "'" << std::endl;
+				bValid = false;
+				continue;
+			}
+
+			if (values.fail())
+			{
+				std::cout << filename << "(" << lineNumber << "): missing or invalid values for '" << keyword << "'" << std::endl;
+				bValid = false;
+			}
+			continue;
+		}
 
-	m_objectMaterials.push_back(mugMaterial);
+		if (bInLight)
+		{
+			if (keyword == "position")
+			{
+				values >> light.position.x >> light.position.y >> light.position.z;
+			}
+			else if (keyword == "color")
+			{
+				values >> light.diffuseColor.r >> light.diffuseColor.g >> light.diffuseColor.b;
+				light.specularColor = light.diffuseColor;
+			}
+			else if (keyword == "ambient")
+			{
+				values >> light.ambientColor.r >> light.ambientColor.g >> light.ambientColor.b;
+			}
+			else if (keyword == "radius")
+			{
+				values >> light.radius;
+				if (!values.fail() && (light.radius <= 0.0f))
+				{
+					std::cout << filename << "(" << lineNumber << "): light radius must be above 0" << std::endl;
+					bValid = false;
+				}
+			}
+			else if (keyword == "focal")
+			{
+				values >> light.focalStrength;
+			}
+			else if (keyword == "array")
+			{
+				values >> arrayCount.x >> arrayCount.y >> arrayCount.z
+					>> arraySpacing.x >> arraySpacing.y >> arraySpacing.z;
+				if (!values.fail() && ((arrayCount.x < 1) || (arrayCount.y < 1) || (arrayCount.z < 1)))
+				{
+					std::cout << filename << "(" << lineNumber << "): array counts must be at least 1" << std::endl;
+					bValid = false;
+				}
+			}
+			else if (keyword == "end")
+			{
+				if (bValid)
+				{
+					LightManager::GPU_LIGHT copy = light;
+					for (int z = 0; z < arrayCount.z; z++)
+					{
+						for (int y = 0; y < arrayCount.y; y++)
+						{
+							for (int x = 0; x < arrayCount.x; x++)
+							{
+								copy.position = light.position + arraySpacing * glm::vec3(float(x), float(y), float(z));
+								m_lightManager->AddLight(copy);
+							}
+						}
+					}
+				}
+				else
+				{
+					std::cout << filename << "(" << lineNumber << "): light block was dropped" << std::endl;
+					bFileValid = false;
+				}
+				bInLight = false;
+				continue;
+			}
+			else
+			{
+				std::cout << filename << "(" << lineNumber << "): unknown light keyword '" << keyword << "'" << std::endl;
+				bValid = false;
+				continue;
+			}
+
+			if (values.fail())
+			{
+				std::cout << filename << "(" << lineNumber << "): missing or invalid values for '" << keyword << "'" << std::endl;
+				bValid = false;
+			}
+			continue;
+		}
 
-	OBJECT_MATERIAL screenMaterial;
-	screenMaterial.ambientColor = glm::vec3(0.4f, 0.4f, 0.4f);
-	screenMaterial.ambientStrength = 0.3f;
-	screenMaterial.diffuseColor = glm::vec3(0.3f, 0.3f, 0.3f);
-	screenMaterial.specularColor = glm::vec3(0.6f, 0.6f, 0.6f);
-	screenMaterial.shininess = 85.0;
-	screenMaterial.tag = "glassy";
+		if (!bInObject && (keyword == "texture"))
+		{
+			// the image path is relative to the working directory,
+			// like the scene file path itself
+			std::string tag;
+			std::string path;
+			values >> tag >> path;
+			if (values.fail())
+			{
+				std::cout << filename << "(" << lineNumber << "): missing or invalid values for 'texture'" << std::endl;
+				bFileValid = false;
+			}
+			else if (!CreateGLTexture(path.c_str(), tag))
+			{
+				bFileValid = false;
+			}
+			continue;
+		}
 
-	m_objectMaterials.push_back(screenMaterial);
+		if (!bInObject)
+		{
+			std::cout << filename << "(" << lineNumber << "): '" << keyword << "' outside of an object, light or material block" << std::endl;
+			bFileValid = false;
+			continue;
+		}
 
-	OBJECT_MATERIAL standMaterial;
-	standMaterial.ambientColor = glm::vec3(0.2f, 0.2f, 0.2f);
-	standMaterial.ambientStrength = 0.3f;
-	standMaterial.diffuseColor = glm::vec3(0.2f, 0.2f, 0.2f);
-	standMaterial.specularColor = glm::vec3(0.5f, 0.5f, 0.5f);
-	standMaterial.shininess = 22.0;
-	standMaterial.tag = "metal";
+		if (keyword == "mesh")
+		{
+			std::string meshName;
+			values >> meshName;
+
+			int mesh = 0;
+			while ((mesh < MESH_TYPE_COUNT) && (meshName != g_MeshNames[mesh]))
+			{
+				mesh++;
+			}
+			if (mesh == MESH_TYPE_COUNT)
+			{
+				std::cout << filename << "(" << lineNumber << "): unknown mesh '" << meshName << "'" << std::endl;
+				bValid = false;
+			}
+			object.mesh = (MESH_TYPE)mesh;
+		}
+		else if (keyword == "scale")
+		{
+			values >> object.scaleXYZ.x >> object.scaleXYZ.y >> object.scaleXYZ.z;
+		}
+		else if (keyword == "rotation")
+		{
+			values >> object.rotationDegrees.x >> object.rotationDegrees.y >> object.rotationDegrees.z;
+		}
+		else if (keyword == "position")
+		{
+			values >> object.positionXYZ.x >> object.positionXYZ.y >> object.positionXYZ.z;
+		}
+		else if (keyword == "texture")
+		{
+			values >> object.textureTag;
+		}
+		else if (keyword == "color")
+		{
+			values >> object.color.r >> object.color.g >> object.color.b >> object.color.a;
+		}
+		else if (keyword == "material")
+		{
+			values >> object.materialTag;
+		}
+		else if (keyword == "uvscale")
+		{
+			values >> object.uvScale.x >> object.uvScale.y;
+		}
+		else if (keyword == "dynamic")
+		{
+			object.bDynamic = true;
+		}
+		else if (keyword == "array")
+		{
+			values >> arrayCount.x >> arrayCount.y >> arrayCount.z
+				>> arraySpacing.x >> arraySpacing.y >> arraySpacing.z;
+			if (!values.fail() && ((arrayCount.x < 1) || (arrayCount.y < 1) || (arrayCount.z < 1)))
+			{
+				std::cout << filename << "(" << lineNumber << "): array counts must be at least 1" << std::endl;
+				bValid = false;
+			}
+		}
+		else if (keyword == "end")
+		{
+			// resolve the tags to their texture and material index
+			if (!object.textureTag.empty())
+			{
+				object.textureIndex = FindTextureIndex(object.textureTag);
+				if (object.textureIndex < 0)
+				{
+					std::cout << filename << "(" << lineNumber << "): unknown texture '" << object.textureTag << "'" << std::endl;
+					bFileValid = false;
+				}
+			}
+			if (!object.materialTag.empty())
+			{
+				object.materialIndex = FindMaterialIndex(object.materialTag);
+				if (object.materialIndex < 0)
+				{
+					std::cout << filename << "(" << lineNumber << "): unknown material '" << object.materialTag << "'" << std::endl;
+					bFileValid = false;
+				}
+			}
+
+			if (bValid && (arrayCount == glm::ivec3(1, 1, 1)))
+			{
+				m_objectNames.Add(object.name, (int)m_sceneObjects.size());
+				if (object.bDynamic)
+				{
+					m_dynamicObjects.push_back((int)m_sceneObjects.size());
+				}
+				m_dirtyObjects.push_back((int)m_sceneObjects.size());
+				m_sceneObjects.push_back(object);
+			}
+			else if (bValid)
+			{
+				SCENE_OBJECT copy = object;
+				int copyIndex = 0;
+				for (int z = 0; z < arrayCount.z; z++)
+				{
+					for (int y = 0; y < arrayCount.y; y++)
+					{
+						for (int x = 0; x < arrayCount.x; x++)
+						{
+							copy.name = object.name + "_" + std::to_string(copyIndex++);
+							copy.positionXYZ = object.positionXYZ + arraySpacing * glm::vec3(float(x), float(y), float(z));
+							m_objectNames.Add(copy.name, (int)m_sceneObjects.size());
+							if (copy.bDynamic)
+							{
+								m_dynamicObjects.push_back((int)m_sceneObjects.size());
+							}
+							m_dirtyObjects.push_back((int)m_sceneObjects.size());
+							m_sceneObjects.push_back(copy);
+						}
+					}
+				}
+			}
+			else
+			{
+				std::cout << filename << "(" << lineNumber << "): object '" << object.name << "' was dropped" << std::endl;
+				bFileValid = false;
+			}
+			bInObject = false;
+			continue;
+		}
+		else
+		{
+			std::cout << filename << "(" << lineNumber << "): unknown keyword '" << keyword << "'" << std::endl;
+			bValid = false;
+			continue;
+		}
 
-	m_objectMaterials.push_back(standMaterial);
+		if (values.fail())
+		{
+			std::cout << filename << "(" << lineNumber << "): missing or invalid values for '" << keyword << "'" << std::endl;
+			bValid = false;
+		}
+	}
 
-	OBJECT_MATERIAL baseMaterial;
-	baseMaterial.ambientColor = glm::vec3(0.2f, 0.2f, 0.2f);
-	baseMaterial.ambientStrength = 0.3f;
-	baseMaterial.diffuseColor = glm::vec3(0.2f, 0.2f, 0.2f);
-	baseMaterial.specularColor = glm::vec3(0.5f, 0.5f, 0.5f);
-	baseMaterial.shininess = 22.0;
-	baseMaterial.tag = "shiny";
+	if (bInObject || bInLight || bInMaterial)
+	{
+		std::cout << filename << "(" << blockLine << "): block is missing its 'end' and was dropped" << std::endl;
+		bFileValid = false;
+	}
 
-	m_objectMaterials.push_back(baseMaterial);
+	std::cout << "Loaded scene file:" << filename << ", objects:" << m_sceneObjects.size()
+		<< ", point lights:" << m_lightManager->GetLightCount() - m_lightManager->GetGlobalLightCount() << std::endl;
 
-	OBJECT_MATERIAL woodMaterial;
-	woodMaterial.ambientColor = glm::vec3(0.1f, 0.1f, 0.1f);
-	woodMaterial.ambientStrength = 0.2f;
-	woodMaterial.diffuseColor = glm::vec3(0.3f, 0.3f, 0.3f);
-	woodMaterial.specularColor = glm::vec3(0.1f, 0.1f, 0.1f);
-	woodMaterial.shininess = 0.3;
-	woodMaterial.tag = "wood";
+	return(bFileValid);
+}
 
-	m_objectMaterials.push_back(woodMaterial); 
+/***********************************************************
+ *  FindSceneObject()
+ *
+ *  This method is used for getting the index of the loaded
+ *  scene object with the passed in name.
+ ***********************************************************/
+int SceneManager::FindSceneObject(const std::string& name)
+{
+	return(m_objectNames.Find(name));
 }
 
 /***********************************************************
- *  SetupSceneLights()
+ *  SetObjectTransform()
  *
- *  This method is called to add and configure the light
- *  sources for the 3D scene.  There are up to 4 light sources.
+ *  This method is used for changing the transform of a
+ *  loaded scene object.  The world matrix is not rebuilt
+ *  here; the object is only marked as changed, so several
+ *  changes in one frame cost a single rebuild.  The first
+ *  change also makes the object dynamic.
  ***********************************************************/
-void SceneManager::SetupSceneLights()
+void SceneManager::SetObjectTransform(
+	int objectIndex,
+	glm::vec3 scaleXYZ,
+	glm::vec3 rotationDegrees,
+	glm::vec3 positionXYZ)
 {
-	// this line of code is NEEDED for telling the shaders to render 
-	// the 3D scene with custom lighting - to use the default rendered 
-	// lighting then comment out the following line
-	if (NULL != m_pShaderManager)
+	if ((objectIndex < 0) || (objectIndex >= (int)m_sceneObjects.size()))
 	{
-		m_pShaderManager->setBoolValue(g_UseLightingName, true);
+		return;
+	}
 
-		// Point light setup
-		m_pShaderManager->setVec3Value("lightSources[0].position", glm::vec3(3.0f, 5.0f, 3.0f));
-		m_pShaderManager->setVec3Value("lightSources[0].ambientColor", glm::vec3(0.6f, 0.6f, 0.9f)); // Blue ambient light
-		m_pShaderManager->setVec3Value("lightSources[0].diffuseColor", glm::vec3(0.4f, 0.4f, 1.0f));
-		m_pShaderManager->setVec3Value("lightSources[0].specularColor", glm::vec3(1.0f, 1.0f, 1.0f));
-		m_pShaderManager->setFloatValue("lightSources[0].focalStrength", 32.0f);
-		m_pShaderManager->setFloatValue("lightSources[0].specularIntensity", 1.0f);
+	SCENE_OBJECT& object = m_sceneObjects[objectIndex];
+	object.scaleXYZ = scaleXYZ;
+	object.rotationDegrees = rotationDegrees;
+	object.positionXYZ = positionXYZ;
 
-		// Directional light setup
-		m_pShaderManager->setVec3Value("lightSources[1].position", glm::vec3(3.0f, 5.0f, -5.0f));
-		m_pShaderManager->setVec3Value("lightSources[1].ambientColor", glm::vec3(0.3f, 0.3f, 0.3f)); // White ambient light
-		m_pShaderManager->setVec3Value("lightSources[1].diffuseColor", glm::vec3(1.0f, 0.9f, 0.7f));
-		m_pShaderManager->setVec3Value("lightSources[1].specularColor", glm::vec3(1.0f, 1.0f, 1.0f));
-		m_pShaderManager->setFloatValue("lightSources[1].focalStrength", 16.0f);
-		m_pShaderManager->setFloatValue("lightSources[1].specularIntensity", 0.8f);
+	if (object.bTransformDirty == false)
+	{
+		object.bTransformDirty = true;
+		m_dirtyObjects.push_back(objectIndex);
+	}
+
+	// a moved object leaves the cached shadow maps, which are
+	// drawn again once without it
+	if (object.bDynamic == false)
+	{
+		object.bDynamic = true;
+		m_dynamicObjects.push_back(objectIndex);
+		m_shadowMaps->Invalidate();
+		m_bShadowBoundsDirty = true;
 	}
 }
 
 /***********************************************************
- *  PrepareScene()
+ *  SetLightPosition()
  *
- *  This method is used for preparing the 3D scene by loading
- *  the shapes, textures in memory to support the 3D scene 
- *  rendering
+ *  This method is used for moving one of the scene lights.
+ *  Only that light is sent to the light buffer with the
+ *  next frame.
  ***********************************************************/
-void SceneManager::PrepareScene()
+void SceneManager::SetLightPosition(int lightIndex, glm::vec3 positionXYZ)
 {
-	LoadSceneTextures();
-	SetupSceneLights();
-	DefineObjectMaterials();
-
-	// only one instance of a particular mesh needs to be
-	// loaded in memory no matter how many times it is drawn
-	// in the rendered 3D scene
-	m_basicMeshes->LoadPlaneMesh();
-	m_basicMeshes->LoadBoxMesh();
-	m_basicMeshes->LoadCylinderMesh();
-	m_basicMeshes->LoadTorusMesh();
-	m_basicMeshes->LoadTaperedCylinderMesh();
-	m_basicMeshes->LoadSphereMesh();
+	m_lightManager->SetLightPosition(lightIndex, positionXYZ);
 }
 
 /***********************************************************
- *  RenderScene()
+ *  UpdateObjectTransforms()
  *
- *  This method is used for rendering the 3D scene by 
- *  transforming and drawing the basic 3D shapes
+ *  This method is used for rebuilding the world matrices and
+ *  the world bounding boxes of the scene objects whose
+ *  transform has changed since the last frame.  Static
+ *  objects are never visited, so a static scene costs no
+ *  matrix math per frame.
  ***********************************************************/
-void SceneManager::RenderScene()
+void SceneManager::UpdateObjectTransforms()
 {
-	RenderPlane();
-	RenderMugBody();
-	RenderMugHandle();
-	RenderMonitorScreen();
-	RenderMonitorBase();
-	RenderMonitorStand();
-	RenderMouse();
-	RenderKeyboard();
-	RenderBook1();
-	RenderBook2();
-}
-
-void SceneManager::RenderPlane()
-{
-	// declare the variables for the transformations
-	glm::vec3 scaleXYZ;
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ;
-
-	/*** Set needed transformations before drawing the basic mesh.  ***/
-	/*** This same ordering of code should be used for transforming ***/
-	/*** and drawing all the basic 3D shapes.						***/
-	/******************************************************************/
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(50.0f, 1.0f, 50.0f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.0f, -1.0f, 0.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
+	m_frustumCuller->Resize(m_sceneObjects.size());
 
-	//SetShaderColor(0.6f, 0.6f, 0.6f, 1.0f);
-	SetShaderMaterial("wood");
-	SetShaderTexture("plane");
-	SetTextureUVScale(10.0f, 10.0f);
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
+	for (size_t i = 0; i < m_dirtyObjects.size(); i++)
+	{
+		int objectIndex = m_dirtyObjects[i];
+		SCENE_OBJECT& object = m_sceneObjects[objectIndex];
+
+		object.modelMatrix = CalculateModelMatrix(
+			object.scaleXYZ,
+			object.rotationDegrees.x,
+			object.rotationDegrees.y,
+			object.rotationDegrees.z,
+			object.positionXYZ);
+		object.bTransformDirty = false;
+
+		glm::vec3 worldCenter;
+		glm::vec3 worldExtent;
+		FrustumCuller::TransformBounds(
+			object.modelMatrix,
+			m_meshBoundsCenter[object.mesh],
+			m_meshBoundsExtent[object.mesh],
+			worldCenter,
+			worldExtent);
+		m_frustumCuller->SetBounds(objectIndex, worldCenter, worldExtent);
+		object.boundsRadius = glm::length(worldExtent);
+	}
+	m_dirtyObjects.clear();
 }
 
-
-	/****************************************************************/
-	/*** Render the upside-down tapered cylinder ***/
-	// Set scale for the tapered cylinder
-void SceneManager::RenderMugBody()
+/***********************************************************
+ *  DrawMesh()
+ *
+ *  This method is used for drawing the passed in mesh of the
+ *  arena with the values currently set into the shader.
+ ***********************************************************/
+void SceneManager::DrawMesh(int meshID)
 {
-	// declare the variables for the transformations
-	glm::vec3 scaleXYZ;
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ;
+	// the meshes share one vertex array, so only the first draw
+	// of a frame binds it
+	m_meshArena->DrawMesh(meshID);
 
-	/*** Set needed transformations before drawing the basic mesh.  ***/
-	/*** This same ordering of code should be used for transforming ***/
-	/*** and drawing all the basic 3D shapes.						***/
-	/******************************************************************/
-
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(1.0f, 1.5f, 1.0f); // Scale for height and radius
+	m_renderStats.Add(RenderStats::DRAW_CALLS, 1);
+	m_renderStats.Add(RenderStats::TRIANGLES, m_meshArena->GetMesh(meshID).indexCount / 3);
+}
 
-	// Set rotation to flip the cylinder upside down
-	XrotationDegrees = 180.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
+/***********************************************************
+ *  SelectDetailLevel()
+ *
+ *  This method is used for picking the detail level of an
+ *  object from the radius of its bounding box on screen,
+ *  under the current projection.  The level only changes
+ *  once the size is clearly past the boundary of the level
+ *  the object was last drawn at.
+ ***********************************************************/
+int SceneManager::SelectDetailLevel(const SCENE_OBJECT& object, float viewDepth) const
+{
+	// the w of the clip coordinates is the view depth for the
+	// perspective projection and 1 for the orthographic one
+	float clipW = m_projectionMatrix[2][3] * -viewDepth + m_projectionMatrix[3][3];
+	float screenSize = object.boundsRadius * m_projectionMatrix[1][1] / std::max(clipW, 0.01f);
 
-	// Set position for the cylinder
-	positionXYZ = glm::vec3(3.0f, 0.5f, 3.0f); // Slightly above the origin
+	int level = 0;
+	while ((level < ShapeGeometry::DETAIL_LEVEL_COUNT - 1) && (screenSize < g_DetailScreenSizes[level]))
+	{
+		level++;
+	}
 
-	// Apply transformations and set shader color
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//SetShaderColor(0.7f, 0.4f, 0.1f, 1.0f); // Set a brown color for the mug body
-	SetShaderTexture("mug");
-	SetShaderMaterial("glassy");
-	SetTextureUVScale(2.25f, 2.25f);
+	int current = object.detailLevel;
+	if ((level > current) && (screenSize >= g_DetailScreenSizes[current] * (1.0f - DETAIL_HYSTERESIS)))
+	{
+		return(current);
+	}
+	if ((level < current) && (screenSize < g_DetailScreenSizes[current - 1] * (1.0f + DETAIL_HYSTERESIS)))
+	{
+		return(current);
+	}
 
-	// Draw the tapered cylinder
-	m_basicMeshes->DrawTaperedCylinderMesh();
+	return(level);
 }
 
-void SceneManager::RenderMugHandle()
+/***********************************************************
+ *  LoadShapeGeometry()
+ *
+ *  This method is used for building the basic shapes, in
+ *  the same order as MESH_TYPE, copying them into the mesh
+ *  arena and storing the bounding box of each one for the
+ *  frustum culling.  The round shapes are added once per
+ *  detail level, the flat ones once for all the levels.
+ *  Each shape is put in vertex cache order before it is
+ *  added.  The optimized shapes are saved to the mesh cache
+ *  file, and later runs map that file and upload the shapes
+ *  straight from it, as long as its key still matches the
+ *  values the shapes are generated with.  Many copies of a
+ *  mesh are only drawn at once when the shader supports
+ *  instancing and the materials are in the material uniform
+ *  buffer, since the copies read their model matrix, color,
+ *  UV scale and material index from the instance buffer.
+ ***********************************************************/
+void SceneManager::LoadShapeGeometry()
 {
-	// declare the variables for the transformations
-	glm::vec3 scaleXYZ;
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ;
+	m_bInstancing = (NULL != m_pUniformCache) &&
+		(m_pUniformCache->GetLocation(UniformCache::UNIFORM_USE_INSTANCING) >= 0) &&
+		m_materialBuffer->IsReady();
+	if (!m_bInstancing)
+	{
+		std::cout << "INFO: Instanced drawing is not supported by the shader" << std::endl;
+	}
 
-	/*** Set needed transformations before drawing the basic mesh.  ***/
-	/*** This same ordering of code should be used for transforming ***/
-	/*** and drawing all the basic 3D shapes.						***/
-	/******************************************************************/
+	std::chrono::steady_clock::time_point loadStart = std::chrono::steady_clock::now();
 
-	/*** Render the torus for the handle ***/
-	// Set scale for the torus
-	scaleXYZ = glm::vec3(0.5f, 0.4f, 0.5f); // Uniform scaling for the handle
+	// the round shapes have a mesh at every level, the flat
+	// ones only at level 0, listed level by level
+	std::vector<int> shapeMeshes;
+	std::vector<int> shapeLevels;
+	for (int level = 0; level < ShapeGeometry::DETAIL_LEVEL_COUNT; level++)
+	{
+		for (int mesh = 0; mesh < MESH_TYPE_COUNT; mesh++)
+		{
+			bool bRound = (mesh != MESH_PLANE) && (mesh != MESH_BOX);
+			if ((level == 0) || bRound)
+			{
+				shapeMeshes.push_back(mesh);
+				shapeLevels.push_back(level);
+			}
+		}
+	}
 
-	// Set rotation to orient the torus as a handle
-	XrotationDegrees = 0.0f; // Rotate to align with the mug body
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
+	// the cached shapes are only used when they were made by
+	// the same generator and optimizer settings
+	std::ostringstream key;
+	key << ShapeGeometry::GetGeneratorKey()
+		<< " optimizer:" << MeshOptimizer::ALGORITHM_VERSION << "," << MeshOptimizer::DEFAULT_CACHE_SIZE
+		<< " meshes:" << MESH_TYPE_COUNT << "," << shapeMeshes.size();
 
-	// Set position for the torus (beside the tapered cylinder)
-	positionXYZ = glm::vec3(4.0f, -0.1f, 3.25f);
+	MeshCache cache;
+	bool bCached = !m_meshCacheFilename.empty() &&
+		cache.Open(m_meshCacheFilename, key.str()) &&
+		(cache.GetMeshCount() == (int)shapeMeshes.size());
 
-	// Apply transformations and set shader color
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//SetShaderColor(0.5f, 0.8f, 1.0f, 1.0f); // applying texture to the handle of the mug
-	SetShaderTexture("handle");
-	SetShaderMaterial("glassy");
-	SetTextureUVScale(1.0f, 1.0f);
-
-	// Draw the torus
-	m_basicMeshes->DrawTorusMesh();
-}
-void SceneManager::RenderMonitorScreen()
-{
-	// declare the variables for the transformations
-	glm::vec3 scaleXYZ;
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ;
-
-	/*** Set needed transformations before drawing the basic mesh.  ***/
-	/*** This same ordering of code should be used for transforming ***/
-	/*** and drawing all the basic 3D shapes.						***/
-	/******************************************************************/
-
-	/*** Render the computer monitor screen ***/
-	// Set scale for the BoxMesh
-	scaleXYZ = glm::vec3(9.0f, 4.0f, 0.2f); // Uniform scaling 
-
-	// Set rotation to orient the BoxMesh as the monitor screen
-	XrotationDegrees = 0.0f; // Rotate to align
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// Set position for the BoxMesh at the top of the scene
-	positionXYZ = glm::vec3(0.0f, 3.0f, 0.0f);
-
-	// Apply transformations and set shader color
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//SetShaderColor(0.5f, 0.8f, 1.0f, 1.0f);
-	SetShaderTexture("screen");
-	SetShaderMaterial("glassy");
-	SetTextureUVScale(1.0f, 1.0f);
-
-	// Draw the BoxMesh
-	m_basicMeshes->DrawBoxMesh();
-}
-void SceneManager::RenderMonitorStand()
-{
-	// declare the variables for the transformations
-	glm::vec3 scaleXYZ;
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ;
-
-	/*** Set needed transformations before drawing the basic mesh.  ***/
-	/*** This same ordering of code should be used for transforming ***/
-	/*** and drawing all the basic 3D shapes.						***/
-	/******************************************************************/
-	/*** Render the monitor stand ***/
-	// Set scale for the BoxMesh
-	scaleXYZ = glm::vec3(1.0f, 0.5f, 1.5f); // Uniform scaling 
-
-	// Set rotation to orient the BoxMesh as the monitor stand
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// Set position for the BoxMesh at the top of the scene
-	positionXYZ = glm::vec3(0.0f, 0.75f, 0.0f);
-
-	// Apply transformations and set shader color
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//SetShaderColor(0.5f, 0.8f, 1.0f, 1.0f);
-	SetShaderTexture("stand");
-	SetShaderMaterial("metal");
-	SetTextureUVScale(4.0f, 4.0f);
-
-	// Draw the BoxMesh
-	m_basicMeshes->DrawBoxMesh();
-}
-void SceneManager::RenderMonitorBase()
-{
-	// declare the variables for the transformations
-	glm::vec3 scaleXYZ;
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ;
-
-	/*** Set needed transformations before drawing the basic mesh.  ***/
-	/*** This same ordering of code should be used for transforming ***/
-	/*** and drawing all the basic 3D shapes.						***/
-	/******************************************************************/
-	/*** Render the computer monitor base ***/
-	// Set scale for the TaperedCylinderMesh
-	scaleXYZ = glm::vec3(1.25f, 0.2f, 2.0f); // Uniform scaling 
-
-	// Set rotation to orient the TaperedCylinderMesh as the base
-	XrotationDegrees = 0.0f; // Rotate to align
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// Set position for the TaperedCylinderMesh
-	positionXYZ = glm::vec3(0.0f, 0.5f, 0.0f);
-
-	// Apply transformations and set shader color
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	//SetShaderColor(0.7f, 0.4f, 0.1f, 1.0f);
-	SetShaderTexture("base");
-	SetShaderMaterial("metal");
-	SetTextureUVScale(5.0f, 5.0f);
-
-	// Draw the TaperedCylinderMesh
-	m_basicMeshes->DrawTaperedCylinderMesh();
-}
-void SceneManager::RenderBook1()
-{
-	// declare the variables for the transformations
-	glm::vec3 scaleXYZ;
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ;
-
-	/*** Set needed transformations before drawing the basic mesh.  ***/
-	/*** This same ordering of code should be used for transforming ***/
-	/*** and drawing all the basic 3D shapes.						***/
-	/******************************************************************/
-	/*** Render the Book 1 ***/
-	// Set scale for the BoxMesh
-	scaleXYZ = glm::vec3(2.0f, 0.5f, 3.0f); // Uniform scaling 
-
-	// Set rotation to orient the BoxMesh as a book
-	XrotationDegrees = 0.0f; // Rotate to align
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// Set position for the BoxMesh
-	positionXYZ = glm::vec3(-6.0f, 0.5f, 1.0f);
-
-	// Apply transformations and set shader color
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	SetShaderColor(0.5f, 0.8f, 1.0f, 1.0f);
-	//SetShaderTexture("handle");
-	//SetShaderMaterial("");
-
-	// Draw the BoxMesh
-	m_basicMeshes->DrawBoxMesh();
-}
-void SceneManager::RenderBook2()
-{
-	// declare the variables for the transformations
-	glm::vec3 scaleXYZ;
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ;
-
-	/*** Set needed transformations before drawing the basic mesh.  ***/
-	/*** This same ordering of code should be used for transforming ***/
-	/*** and drawing all the basic 3D shapes.						***/
-	/******************************************************************/
-
-	/*** Render the Book 2 ***/
-	// Set scale for the BoxMesh
-	scaleXYZ = glm::vec3(2.0f, 0.5f, 3.0f); // Uniform scaling 
-
-	// Set rotation to orient the BoxMesh as a book
-	XrotationDegrees = 0.0f; // Rotate to align
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// Set position for the BoxMesh
-	positionXYZ = glm::vec3(-6.0f, 1.0f, 1.0f);
-
-	// Apply transformations and set shader color
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	SetShaderColor(0.7f, 0.4f, 0.1f, 1.0f);
-	//SetShaderTexture("");
-	//SetShaderMaterial("");
-	//SetTextureUVScale("");
-
-	// Draw the BoxMesh
-	m_basicMeshes->DrawBoxMesh();
-}
-void SceneManager::RenderKeyboard()
-{ 	
-// declare the variables for the transformations
-	glm::vec3 scaleXYZ;
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ;
-
-	/*** Set needed transformations before drawing the basic mesh.  ***/
-	/*** This same ordering of code should be used for transforming ***/
-	/*** and drawing all the basic 3D shapes.						***/
-	/******************************************************************/
-
-	/*** Render the KeyBoard ***/
-	// Set scale for the BoxMesh
-	scaleXYZ = glm::vec3(7.0f, 0.2f, 1.0f); // Uniform scaling 
-
-	// Set rotation to orient the BoxMesh as the keyboard
-	XrotationDegrees = 0.0f; // Rotate to align
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// Set position for the BoxMesh
-	positionXYZ = glm::vec3(0.0f, 0.2f, 2.0f);
-
-	// Apply transformations and set shader color
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	SetShaderColor(0.7f, 0.4f, 0.1f, 1.0f);
-	//SetShaderTexture("");
-	//SetShaderMaterial("");
-
-	// Draw the BoxMesh
-	m_basicMeshes->DrawBoxMesh();
-}
-void SceneManager::RenderMouse()
-{
-	// declare the variables for the transformations
-	glm::vec3 scaleXYZ;
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ;
-
-	/*** Set needed transformations before drawing the basic mesh.  ***/
-	/*** This same ordering of code should be used for transforming ***/
-	/*** and drawing all the basic 3D shapes.						***/
-	/******************************************************************/
-	/*** Render the Mouse ***/
-	// Set scale for the SphereMesh
-	scaleXYZ = glm::vec3(0.5f, 0.3f, 0.8f); // Uniform scaling 
-
-	// Set rotation to orient the SphereMesh as the Mouse
-	XrotationDegrees = 0.0f; // Rotate to align
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// Set position for the SphereMesh
-	positionXYZ = glm::vec3(-3.0f, -0.5f, 2.5f);
-
-	// Apply transformations and set shader color
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-	SetShaderColor(0.7f, 0.4f, 0.1f, 1.0f);
-	//SetShaderTexture("");
-	//SetShaderMaterial("");
+	std::vector<ShapeGeometry::SHAPE_GEOMETRY> shapes;
+	if (!bCached)
+	{
+		cache.Close();
+		shapes.resize(shapeMeshes.size());
+		for (size_t i = 0; i < shapeMeshes.size(); i++)
+		{
+			// the generated index order is reordered for the
+			// vertex cache once, before it is saved
+			shapes[i] = CreateShape(shapeMeshes[i], shapeLevels[i]);
+			MeshOptimizer::OPTIMIZE_REPORT report = MeshOptimizer::Optimize(shapes[i]);
+			std::cout << "Optimized mesh:" << g_MeshNames[shapeMeshes[i]] << " level " << shapeLevels[i]
+				<< ", ACMR " << report.acmrBefore << " -> " << report.acmrAfter
+				<< ", ATVR " << report.atvrBefore << " -> " << report.atvrAfter << std::endl;
+		}
+
+		if (!m_meshCacheFilename.empty() &&
+			!MeshCache::Write(m_meshCacheFilename, key.str(), shapes))
+		{
+			std::cout << "Could not write mesh cache file:" << m_meshCacheFilename << std::endl;
+		}
+	}
+
+	// the vertices and indices of every shape, read from the
+	// mapped cache file or from the generated shapes
+	std::vector<MeshCache::CACHED_MESH> meshData(shapeMeshes.size());
+	for (size_t i = 0; i < shapeMeshes.size(); i++)
+	{
+		if (bCached)
+		{
+			meshData[i] = cache.GetMesh((int)i);
+		}
+		else
+		{
+			meshData[i].vertices = shapes[i].vertices.data();
+			meshData[i].vertexCount = shapes[i].vertices.size();
+			meshData[i].indices = shapes[i].indices.data();
+			meshData[i].indexCount = shapes[i].indices.size();
+		}
+	}
+
+	// the levels share their extents, so the bounds of the
+	// finest one, listed first, are used for the culling
+	glm::vec3 boxMinimum(0.0f, 0.0f, 0.0f);
+	glm::vec3 boxMaximum(0.0f, 0.0f, 0.0f);
+	for (int mesh = 0; mesh < MESH_TYPE_COUNT; mesh++)
+	{
+		ShapeGeometry::CalculateBounds(meshData[mesh].vertices, meshData[mesh].vertexCount,
+			m_meshBoundsCenter[mesh], m_meshBoundsExtent[mesh]);
+		boxMinimum = glm::min(boxMinimum, m_meshBoundsCenter[mesh] - m_meshBoundsExtent[mesh]);
+		boxMaximum = glm::max(boxMaximum, m_meshBoundsCenter[mesh] + m_meshBoundsExtent[mesh]);
+	}
+
+	// the multi-draws read the whole arena with one index type,
+	// so the compact layout is only used when every mesh fits
+	// its 16 bit indices
+	bool bCompactFits = true;
+	for (size_t i = 0; i < meshData.size(); i++)
+	{
+		bCompactFits = bCompactFits && (meshData[i].vertexCount <= MeshArena::MAX_COMPACT_MESH_VERTICES);
+	}
+
+	// the compact positions are quantized within the box
+	// holding all the shapes
+	if (m_bCompactVertices && !bCompactFits)
+	{
+		std::cout << "INFO: A mesh has too many vertices for 16 bit indices, the full vertex layout is used" << std::endl;
+	}
+	else if (m_bCompactVertices && (NULL != m_pUniformCache) &&
+		(m_pUniformCache->GetLocation(UniformCache::UNIFORM_COMPACT_VERTICES) >= 0))
+	{
+		m_meshArena->SetVertexFormat(
+			MeshArena::VERTEX_COMPACT,
+			(boxMinimum + boxMaximum) * 0.5f,
+			(boxMaximum - boxMinimum) * 0.5f);
+	}
+	else if (m_bCompactVertices)
+	{
+		std::cout << "INFO: Compact vertices are not supported by the shader" << std::endl;
+	}
+
+	for (size_t i = 0; i < shapeMeshes.size(); i++)
+	{
+		int meshID = m_meshArena->AddMesh(
+			meshData[i].vertices, meshData[i].vertexCount,
+			meshData[i].indices, meshData[i].indexCount);
+		if (meshID < 0)
+		{
+			// the objects drawn with a missing mesh are skipped
+			std::cout << "Could not add mesh:" << g_MeshNames[shapeMeshes[i]] << " level " << shapeLevels[i] << std::endl;
+		}
+		m_meshIDs[shapeMeshes[i]][shapeLevels[i]] = meshID;
+	}
+	// the flat shapes use their only mesh at every level
+	for (int level = 1; level < ShapeGeometry::DETAIL_LEVEL_COUNT; level++)
+	{
+		m_meshIDs[MESH_PLANE][level] = m_meshIDs[MESH_PLANE][0];
+		m_meshIDs[MESH_BOX][level] = m_meshIDs[MESH_BOX][0];
+	}
+
+	double loadTime = std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - loadStart).count();
+	std::cout << (bCached ? "Loaded" : "Generated") << " " << shapeMeshes.size()
+		<< " shape meshes in " << loadTime << " ms" << std::endl;
+	std::cout << "Mesh arena holds " << m_meshArena->GetMeshCount() << " meshes in "
+		<< m_meshArena->GetUsedBytes() << " bytes" << std::endl;
+}
+
+/***********************************************************
+ *  AddInstance()
+ *
+ *  This method is used for appending the model matrix,
+ *  color, UV scale, material and texture layer of a scene
+ *  object to the per-instance values of the frame.
+ ***********************************************************/
+void SceneManager::AddInstance(const SCENE_OBJECT& object)
+{
+	InstancedMeshes::INSTANCE_DATA instance;
+	instance.modelMatrix = object.modelMatrix;
+	instance.color = object.color;
+	instance.uvScale = object.uvScale;
+	instance.materialIndex = std::max(object.materialIndex, 0);
+	instance.textureLayer = (object.textureIndex >= 0) ? m_textureManager->GetLayer(object.textureIndex) : 0;
+	m_instances.push_back(instance);
+}
+
+/***********************************************************
+ *  BuildDrawBatches()
+ *
+ *  This method is used for splitting the sorted draws into
+ *  runs that share the same mesh and texture array.  Each
+ *  copy in a run can use a different layer.  Runs that are
+ *  long enough get their per-instance values gathered and
+ *  uploaded together, to be drawn with one call per run.
+ *  Transparent draws stay single, in back to front order.
+ ***********************************************************/
+void SceneManager::BuildDrawBatches()
+{
+	m_instances.clear();
+	m_drawBatches.clear();
+
+	bool bInstancing = m_bInstancing;
+	const std::vector<RenderQueue::RENDER_ITEM>& items = m_renderQueue->GetItems();
+
+	size_t first = 0;
+	while (first < items.size())
+	{
+		const RenderQueue::RENDER_ITEM& item = items[first];
+
+		size_t end = first + 1;
+		while ((end < items.size()) &&
+			(item.bTransparent == false) &&
+			(items[end].bTransparent == false) &&
+			(items[end].mesh == item.mesh) &&
+			(items[end].textureArray == item.textureArray))
+		{
+			end++;
+		}
+
+		DRAW_BATCH batch;
+		batch.firstItem = (int)first;
+		batch.itemCount = (int)(end - first);
+		batch.firstInstance = -1;
+
+		if (bInstancing && (batch.itemCount >= MIN_INSTANCED_BATCH))
+		{
+			batch.firstInstance = (int)m_instances.size();
+			for (size_t i = first; i < end; i++)
+			{
+				AddInstance(m_sceneObjects[items[i].objectIndex]);
+			}
+		}
+
+		m_drawBatches.push_back(batch);
+		first = end;
+	}
+
+	m_instancedMeshes->UploadInstances(m_instances);
+}
+
+/***********************************************************
+ *  BuildIndirectDraws()
+ *
+ *  This method is used for turning all the sorted draws into
+ *  indirect draw commands.  The only value that cannot come
+ *  from the instance buffer is the texture array, so the
+ *  commands are gathered into one multi-draw per texture
+ *  array, with the color objects last so the transparent
+ *  ones still draw after everything else, back to front,
+ *  in a multi-draw of their own.
+ *  Neighbouring opaque draws of the same mesh share one
+ *  command, and every command reads its copies from the
+ *  instance buffer through its base instance.
+ ***********************************************************/
+void SceneManager::BuildIndirectDraws()
+{
+	m_instances.clear();
+	m_drawCommands.clear();
+	m_indirectDraws.clear();
+
+	const std::vector<RenderQueue::RENDER_ITEM>& items = m_renderQueue->GetItems();
+	int arrayCount = m_textureManager->GetArrayCount();
+
+	for (int group = 0; group <= arrayCount; group++)
+	{
+		int textureArray = (group < arrayCount) ? group : -1;
+
+		INDIRECT_DRAW draw;
+		draw.firstCommand = (int)m_drawCommands.size();
+		draw.commandCount = 0;
+		draw.instanceCount = 0;
+		draw.triangleCount = 0;
+		draw.textureArray = textureArray;
+		draw.bTransparent = false;
+
+		int commandMesh = -1;
+		for (size_t i = 0; i < items.size(); i++)
+		{
+			const RenderQueue::RENDER_ITEM& item = items[i];
+			if (item.textureArray != textureArray)
+			{
+				continue;
+			}
+
+			// the transparent draws are sorted after the opaque
+			// ones and get a multi-draw of their own
+			if (item.bTransparent && !draw.bTransparent)
+			{
+				if (draw.commandCount > 0)
+				{
+					m_indirectDraws.push_back(draw);
+				}
+				draw.firstCommand = (int)m_drawCommands.size();
+				draw.commandCount = 0;
+				draw.instanceCount = 0;
+				draw.triangleCount = 0;
+				draw.bTransparent = true;
+			}
+
+			// the items are sorted by mesh first, so the copies of
+			// a mesh are next to each other within the group
+			if ((commandMesh == item.mesh) && !item.bTransparent)
+			{
+				m_drawCommands.back().instanceCount++;
+			}
+			else
+			{
+				InstancedMeshes::DRAW_COMMAND command;
+				m_instancedMeshes->MakeCommand(item.mesh, (int)m_instances.size(), 1, command);
+				m_drawCommands.push_back(command);
+				draw.commandCount++;
+				commandMesh = item.bTransparent ? -1 : item.mesh;
+			}
+
+			AddInstance(m_sceneObjects[item.objectIndex]);
+			draw.instanceCount++;
+			draw.triangleCount += m_meshArena->GetMesh(item.mesh).indexCount / 3;
+		}
+
+		if (draw.commandCount > 0)
+		{
+			m_indirectDraws.push_back(draw);
+		}
+	}
+
+	m_instancedMeshes->UploadInstances(m_instances);
+	m_instancedMeshes->UploadCommands(m_drawCommands);
+}
+
+/***********************************************************
+ *  RenderIndirectDraws()
+ *
+ *  This method is used for submitting the whole scene with
+ *  one multi-draw indirect call per texture array.  The
+ *  number of calls does not grow with the number of scene
+ *  objects, only with the number of texture arrays.  After
+ *  a depth pre-pass, the opaque draws only shade the
+ *  fragments whose depth equals the stored one.
+ ***********************************************************/
+void SceneManager::RenderIndirectDraws()
+{
+	m_pUniformCache->SetBool(UniformCache::UNIFORM_USE_INSTANCING, true);
+
+	for (size_t d = 0; d < m_indirectDraws.size(); d++)
+	{
+		const INDIRECT_DRAW& draw = m_indirectDraws[d];
+
+		// the see-through draws are not in the depth buffer, so
+		// they are tested and written as usual
+		if (m_bDepthPrepass && draw.bTransparent)
+		{
+			glDepthFunc(GL_LESS);
+			glDepthMask(GL_TRUE);
+		}
+
+		m_pUniformCache->SetBool(UniformCache::UNIFORM_USE_TEXTURE, draw.textureArray >= 0);
+		if (draw.textureArray >= 0)
+		{
+			m_pUniformCache->SetSampler(UniformCache::UNIFORM_OBJECT_TEXTURE, draw.textureArray);
+		}
+
+		m_instancedMeshes->DrawCommands(draw.firstCommand, draw.commandCount);
+
+		m_renderStats.Add(RenderStats::DRAW_CALLS, 1);
+		m_renderStats.Add(RenderStats::INDIRECT_COMMANDS, draw.commandCount);
+		m_renderStats.Add(RenderStats::INSTANCES, draw.instanceCount);
+		m_renderStats.Add(RenderStats::TRIANGLES, draw.triangleCount);
+	}
+
+	m_pUniformCache->SetBool(UniformCache::UNIFORM_USE_INSTANCING, false);
+}
+
+/***********************************************************
+ *  RenderInstancedBatch()
+ *
+ *  This method is used for drawing all the copies of a batch
+ *  with a single instanced draw call.  Only the texture array
+ *  is set into the shader, the other values of each copy,
+ *  including its texture layer, come from the instance buffer.
+ ***********************************************************/
+void SceneManager::RenderInstancedBatch(const DRAW_BATCH& batch)
+{
+	const std::vector<RenderQueue::RENDER_ITEM>& items = m_renderQueue->GetItems();
+	const RenderQueue::RENDER_ITEM& item = items[batch.firstItem];
+
+	m_pUniformCache->SetBool(UniformCache::UNIFORM_USE_TEXTURE, item.textureArray >= 0);
+	if (item.textureArray >= 0)
+	{
+		m_pUniformCache->SetSampler(UniformCache::UNIFORM_OBJECT_TEXTURE, item.textureArray);
+	}
+
+	m_pUniformCache->SetBool(UniformCache::UNIFORM_USE_INSTANCING, true);
+	m_instancedMeshes->DrawInstances(item.mesh, batch.firstInstance, batch.itemCount);
+	m_pUniformCache->SetBool(UniformCache::UNIFORM_USE_INSTANCING, false);
+
+	m_renderStats.Add(RenderStats::DRAW_CALLS, 1);
+	m_renderStats.Add(RenderStats::INSTANCED_DRAWS, 1);
+	m_renderStats.Add(RenderStats::INSTANCES, batch.itemCount);
+	m_renderStats.Add(RenderStats::TRIANGLES, (long long)m_meshArena->GetMesh(item.mesh).indexCount / 3 * batch.itemCount);
+}
+
+/***********************************************************
+ *  RenderDrawBatches()
+ *
+ *  This method is used for drawing the sorted draws batch by
+ *  batch, with one instanced call for each long enough run
+ *  of copies and one call for each other object.  It is used
+ *  when the scene is not submitted with indirect commands.
+ ***********************************************************/
+void SceneManager::RenderDrawBatches()
+{
+	BuildDrawBatches();
+
+	const std::vector<RenderQueue::RENDER_ITEM>& items = m_renderQueue->GetItems();
+	const SCENE_OBJECT* pPrevious = NULL;
+	for (size_t b = 0; b < m_drawBatches.size(); b++)
+	{
+		const DRAW_BATCH& batch = m_drawBatches[b];
+
+		if (batch.firstInstance >= 0)
+		{
+			RenderInstancedBatch(batch);
+			// the batch changed the texture state in the shader
+			pPrevious = NULL;
+			continue;
+		}
 
-	// Draw the SphereMesh
-	m_basicMeshes->DrawSphereMesh();
+		for (int i = batch.firstItem; i < batch.firstItem + batch.itemCount; i++)
+		{
+			const SCENE_OBJECT& object = m_sceneObjects[items[i].objectIndex];
+			RenderSceneObject(object, pPrevious);
+			pPrevious = &object;
+		}
+	}
 }
 
+/***********************************************************
+ *  RenderSceneObject()
+ *
+ *  This method is used for setting the transformations, the
+ *  texture or color, the material and the UV scale of the
+ *  passed in scene object into the shader, then drawing it.
+ *  Values equal to those of the previously drawn object are
+ *  still set in the shader and are not sent again.
+ ***********************************************************/
+void SceneManager::RenderSceneObject(
+	const SCENE_OBJECT& object,
+	const SCENE_OBJECT* pPrevious)
+{
+	SetModelMatrix(object.modelMatrix);
+
+	bool bSameTexture = (NULL != pPrevious) &&
+		(pPrevious->textureIndex == object.textureIndex) &&
+		((object.textureIndex >= 0) || (pPrevious->color == object.color));
+	if (!bSameTexture)
+	{
+		if (object.textureIndex >= 0)
+		{
+			SetShaderTexture(object.textureIndex);
+		}
+		else
+		{
+			SetShaderColor(object.color.r, object.color.g, object.color.b, object.color.a);
+		}
+	}
+
+	if ((NULL == pPrevious) || (pPrevious->materialIndex != object.materialIndex))
+	{
+		SetShaderMaterial(object.materialIndex);
+	}
+
+	if ((NULL == pPrevious) || (pPrevious->uvScale != object.uvScale))
+	{
+		SetTextureUVScale(object.uvScale.x, object.uvScale.y);
+	}
+
+	DrawMesh(m_meshIDs[object.mesh][object.detailLevel]);
+}
+
+/***********************************************************
+ *  SetViewTransforms()
+ *
+ *  This method is used for setting the view and projection
+ *  matrices of the current frame, which are used for sorting
+ *  the scene objects by their distance from the camera.
+ ***********************************************************/
+void SceneManager::SetViewTransforms(
+	const glm::mat4& view,
+	const glm::mat4& projection)
+{
+	m_viewMatrix = view;
+	m_projectionMatrix = projection;
+}
+
+/**************************************************************/
+/*** STUDENTS CAN MODIFY the code in the methods BELOW for  ***/
+/*** preparing and rendering their own 3D replicated scenes.***/
+/*** Please refer to the code in the OpenGL sample project  ***/
+/*** for assistance.                                        ***/
+/**************************************************************/
+
+/**************************************************************/
+/*** The code in the methods BELOW is for preparing and     ***/
+/*** rendering the 3D replicated scenes.                    ***/
+/**************************************************************/
+
+/***********************************************************
+ *  SetupSceneLights()
+ *
+ *  This method is called to add and configure the light
+ *  sources for the 3D scene.  The lights are kept in the
+ *  light buffer, so they are uploaded once and cost nothing
+ *  per frame until one of them changes.  These two lights
+ *  have no radius and reach the whole scene.
+ ***********************************************************/
+void SceneManager::SetupSceneLights()
+{
+	// this line of code is NEEDED for telling the shaders to render 
+	// the 3D scene with custom lighting - to use the default rendered 
+	// lighting then comment out the following line
+	if (NULL != m_pUniformCache)
+	{
+		m_pUniformCache->SetBool(UniformCache::UNIFORM_USE_LIGHTING, true);
+	}
+
+	LightManager::GPU_LIGHT light;
+	light.radius = 0.0f;
+	light.padding = 0.0f;
+
+	// Point light setup
+	light.position = glm::vec3(3.0f, 5.0f, 3.0f);
+	light.ambientColor = glm::vec3(0.6f, 0.6f, 0.9f); // Blue ambient light
+	light.diffuseColor = glm::vec3(0.4f, 0.4f, 1.0f);
+	light.specularColor = glm::vec3(1.0f, 1.0f, 1.0f);
+	light.focalStrength = 32.0f;
+	light.specularIntensity = 1.0f;
+	m_lightManager->AddLight(light);
+
+	// Directional light setup - the shader takes its position
+	// as the direction toward the light
+	light.position = glm::vec3(3.0f, 5.0f, -5.0f);
+	light.ambientColor = glm::vec3(0.3f, 0.3f, 0.3f); // White ambient light
+	light.diffuseColor = glm::vec3(1.0f, 0.9f, 0.7f);
+	light.specularColor = glm::vec3(1.0f, 1.0f, 1.0f);
+	light.focalStrength = 16.0f;
+	light.specularIntensity = 0.8f;
+	m_lightManager->AddLight(light);
+}
+
+/***********************************************************
+ *  AttachLightBuffer()
+ *
+ *  This method is used for connecting the light buffer to
+ *  the shader program.  The point lights of the scene file
+ *  are only drawn when the shader also reads the cluster
+ *  light lists.
+ ***********************************************************/
+void SceneManager::AttachLightBuffer()
+{
+	if ((NULL == m_pUniformCache) ||
+		(m_lightManager->AttachProgram(m_pUniformCache->GetProgramID()) == false))
+	{
+		std::cout << "INFO: The shader does not declare the LightBlock, the scene lights are not drawn" << std::endl;
+		return;
+	}
+
+	bool bPointLights = (m_lightManager->GetLightCount() > m_lightManager->GetGlobalLightCount());
+	m_bClusteredLights = bPointLights &&
+		(m_pUniformCache->GetLocation(UniformCache::UNIFORM_CLUSTERED_LIGHTS) >= 0);
+	if (bPointLights && !m_bClusteredLights)
+	{
+		std::cout << "INFO: Clustered point lights are not supported by the shader" << std::endl;
+	}
+
+	m_pUniformCache->SetBool(UniformCache::UNIFORM_CLUSTERED_LIGHTS, m_bClusteredLights);
+}
+
+/***********************************************************
+ *  SetupShadowMaps()
+ *
+ *  This method is used for creating the shadow maps of the
+ *  two global lights, when the shader samples them and the
+ *  shadow program was loaded.  The casters are drawn with
+ *  the instanced commands, so instancing is needed too.
+ ***********************************************************/
+void SceneManager::SetupShadowMaps()
+{
+	if (NULL == m_pUniformCache)
+	{
+		return;
+	}
+
+	// the samplers always name their own units, as a 2D and a
+	// cube sampler left on the same unit cannot be drawn with
+	m_pUniformCache->SetSampler(UniformCache::UNIFORM_SHADOW_MAP, SHADOW_MAP_TEXTURE_UNIT);
+	m_pUniformCache->SetSampler(UniformCache::UNIFORM_SHADOW_CUBE_MAP, SHADOW_CUBE_TEXTURE_UNIT);
+
+	m_bShadows = (m_shadowProgramID != 0) &&
+		m_bInstancing &&
+		(m_pUniformCache->GetLocation(UniformCache::UNIFORM_SHADOWS) >= 0) &&
+		(m_lightManager->GetGlobalLightCount() > SHADOW_MAP_LIGHT) &&
+		m_shadowMaps->Create(m_shadowProgramID);
+	if (!m_bShadows)
+	{
+		std::cout << "INFO: Shadow maps are not supported by the shader" << std::endl;
+	}
+	else
+	{
+		m_shadowMaps->SetCaching(m_bShadowCache);
+		m_shadowMaps->SetPositionDecoding(m_meshArena->GetPositionScale(), m_meshArena->GetPositionOffset());
+	}
+
+	m_pUniformCache->SetBool(UniformCache::UNIFORM_SHADOWS, m_bShadows);
+}
+
+/***********************************************************
+ *  UpdateShadowBounds()
+ *
+ *  This method is used for fitting the world box around the
+ *  static objects that cast shadows.  The dynamic objects
+ *  are left out, so moving them never changes the light
+ *  projections and never makes the cached maps stale.
+ ***********************************************************/
+void SceneManager::UpdateShadowBounds()
+{
+	glm::vec3 boundsMinimum(1e30f);
+	glm::vec3 boundsMaximum(-1e30f);
+	for (size_t i = 0; i < m_sceneObjects.size(); i++)
+	{
+		const SCENE_OBJECT& object = m_sceneObjects[i];
+		if (object.bDynamic)
+		{
+			continue;
+		}
+
+		glm::vec3 worldCenter;
+		glm::vec3 worldExtent;
+		FrustumCuller::TransformBounds(
+			object.modelMatrix,
+			m_meshBoundsCenter[object.mesh],
+			m_meshBoundsExtent[object.mesh],
+			worldCenter,
+			worldExtent);
+		boundsMinimum = glm::min(boundsMinimum, worldCenter - worldExtent);
+		boundsMaximum = glm::max(boundsMaximum, worldCenter + worldExtent);
+	}
+
+	if (boundsMinimum.x > boundsMaximum.x)
+	{
+		boundsMinimum = glm::vec3(-1.0f);
+		boundsMaximum = glm::vec3(1.0f);
+	}
+
+	m_shadowBoundsCenter = (boundsMinimum + boundsMaximum) * 0.5f;
+	m_shadowBoundsExtent = (boundsMaximum - boundsMinimum) * 0.5f;
+	m_bShadowBoundsDirty = false;
+}
+
+/***********************************************************
+ *  AddShadowCasters()
+ *
+ *  This method is used for appending the commands that draw
+ *  the static or the dynamic shadow casters.  The casters
+ *  are sorted by mesh, so each mesh takes one command for
+ *  all its copies.  See-through color objects cast no
+ *  shadow, and every caster uses the full detail meshes.
+ ***********************************************************/
+int SceneManager::AddShadowCasters(bool bDynamic)
+{
+	m_shadowCasterKeys.clear();
+	for (size_t i = 0; i < m_sceneObjects.size(); i++)
+	{
+		const SCENE_OBJECT& object = m_sceneObjects[i];
+		bool bTransparent = (object.textureIndex < 0) && (object.color.a < 1.0f);
+		if ((object.bDynamic != bDynamic) || bTransparent || (m_meshIDs[object.mesh][0] < 0))
+		{
+			continue;
+		}
+
+		unsigned long long meshID = (unsigned long long)m_meshIDs[object.mesh][0];
+		m_shadowCasterKeys.push_back((meshID << 32) | (unsigned long long)i);
+	}
+	std::sort(m_shadowCasterKeys.begin(), m_shadowCasterKeys.end());
+
+	int commandCount = 0;
+	int commandMesh = -1;
+	for (size_t k = 0; k < m_shadowCasterKeys.size(); k++)
+	{
+		int meshID = (int)(m_shadowCasterKeys[k] >> 32);
+		int objectIndex = (int)(m_shadowCasterKeys[k] & 0xFFFFFFFFull);
+
+		if (meshID == commandMesh)
+		{
+			m_shadowCommands.back().instanceCount++;
+		}
+		else
+		{
+			InstancedMeshes::DRAW_COMMAND command;
+			m_instancedMeshes->MakeCommand(meshID, (int)m_shadowInstances.size(), 1, command);
+			m_shadowCommands.push_back(command);
+			commandMesh = meshID;
+			commandCount++;
+		}
+
+		// the depth only program reads just the model matrix
+		InstancedMeshes::INSTANCE_DATA instance;
+		instance.modelMatrix = m_sceneObjects[objectIndex].modelMatrix;
+		instance.color = glm::vec4(1.0f);
+		instance.uvScale = glm::vec2(1.0f);
+		instance.materialIndex = 0;
+		instance.textureLayer = 0;
+		m_shadowInstances.push_back(instance);
+	}
+
+	return(commandCount);
+}
+
+/***********************************************************
+ *  RenderShadowMaps()
+ *
+ *  This method is used for bringing the shadow maps up to
+ *  date and binding them for the scene.  The static casters
+ *  are only gathered and uploaded when the cached maps are
+ *  stale, so a scene without moving objects sends nothing
+ *  and draws nothing for its shadows once they are cached.
+ ***********************************************************/
+void SceneManager::RenderShadowMaps()
+{
+	if (m_bShadowBoundsDirty)
+	{
+		UpdateShadowBounds();
+	}
+
+	m_shadowMaps->SetLights(
+		m_lightManager->GetLight(SHADOW_CUBE_LIGHT).position,
+		m_lightManager->GetLight(SHADOW_MAP_LIGHT).position,
+		m_shadowBoundsCenter,
+		m_shadowBoundsExtent);
+
+	m_shadowInstances.clear();
+	m_shadowCommands.clear();
+	int staticCount = 0;
+	if (m_shadowMaps->NeedsStaticCasters())
+	{
+		staticCount = AddShadowCasters(false);
+	}
+	int dynamicCount = AddShadowCasters(true);
+
+	if (!m_shadowCommands.empty())
+	{
+		m_instancedMeshes->UploadInstances(m_shadowInstances);
+		m_instancedMeshes->UploadCommands(m_shadowCommands);
+	}
+	m_shadowMaps->Render(staticCount, dynamicCount);
+	m_stateCache->UseProgram(m_pUniformCache->GetProgramID());
+
+	m_stateCache->BindTexture(SHADOW_MAP_TEXTURE_UNIT, m_shadowMaps->GetShadowMap());
+	m_stateCache->BindTexture(SHADOW_CUBE_TEXTURE_UNIT, m_shadowMaps->GetShadowCubeMap());
+	m_pUniformCache->SetMat4(UniformCache::UNIFORM_SHADOW_MATRIX, m_shadowMaps->GetShadowMatrix());
+	m_pUniformCache->SetFloat(UniformCache::UNIFORM_SHADOW_CUBE_FAR, m_shadowMaps->GetCubeFar());
+
+	m_renderStats.Set(RenderStats::SHADOW_CASTERS, (long long)m_shadowInstances.size());
+	m_renderStats.Set(RenderStats::SHADOW_GPU_MICROSECONDS, m_shadowMaps->GetFrameMicroseconds());
+	m_renderStats.Set(RenderStats::SHADOW_SAVED_MICROSECONDS, m_shadowMaps->GetSavedMicroseconds());
+}
+
+/***********************************************************
+ *  SetupDepthPrepass()
+ *
+ *  This method is used for checking that the depth pre-pass
+ *  and the overdraw view can be drawn.  The pre-pass draws
+ *  the indirect commands, so it needs the instanced
+ *  multi-draw submission; the overdraw view needs the
+ *  shader to count its fragments.
+ ***********************************************************/
+void SceneManager::SetupDepthPrepass()
+{
+	if (NULL == m_pUniformCache)
+	{
+		m_bOverdraw = false;
+		return;
+	}
+
+	m_bDepthPrepass = (m_depthProgramID != 0) && m_bIndirectDraws && m_bInstancing;
+	if ((m_depthProgramID != 0) && !m_bDepthPrepass)
+	{
+		std::cout << "INFO: The depth pre-pass needs the multi-draw indirect submission" << std::endl;
+	}
+	if (m_bDepthPrepass)
+	{
+		GLint scaleLocation = glGetUniformLocation(m_depthProgramID, "positionScale");
+		GLint offsetLocation = glGetUniformLocation(m_depthProgramID, "positionOffset");
+		glProgramUniform3fv(m_depthProgramID, scaleLocation, 1, glm::value_ptr(m_meshArena->GetPositionScale()));
+		glProgramUniform3fv(m_depthProgramID, offsetLocation, 1, glm::value_ptr(m_meshArena->GetPositionOffset()));
+	}
+
+	if (m_bOverdraw)
+	{
+		m_bOverdraw = (m_pUniformCache->GetLocation(UniformCache::UNIFORM_OVERDRAW) >= 0) &&
+			m_overdrawCounter->Create();
+		if (!m_bOverdraw)
+		{
+			std::cout << "INFO: The overdraw view is not supported by the shader" << std::endl;
+		}
+	}
+	m_pUniformCache->SetBool(UniformCache::UNIFORM_OVERDRAW, m_bOverdraw);
+}
+
+/***********************************************************
+ *  RenderDepthPrepass()
+ *
+ *  This method is used for drawing the depth of the opaque
+ *  indirect commands with the depth only program, leaving
+ *  the colors untouched.  The scene pass then tests for an
+ *  equal depth without writing it, so only the nearest
+ *  fragment of each pixel runs the lighting shader.
+ ***********************************************************/
+void SceneManager::RenderDepthPrepass()
+{
+	// the opaque draws come first, so their commands are the
+	// start of the command buffer
+	int opaqueCommandCount = (int)m_drawCommands.size();
+	for (size_t d = 0; d < m_indirectDraws.size(); d++)
+	{
+		if (m_indirectDraws[d].bTransparent)
+		{
+			opaqueCommandCount = m_indirectDraws[d].firstCommand;
+			break;
+		}
+	}
+
+	// with nothing opaque to draw the scene pass keeps its
+	// normal depth test
+	m_renderStats.Set(RenderStats::DEPTH_PREPASS_COMMANDS, opaqueCommandCount);
+	if (opaqueCommandCount == 0)
+	{
+		return;
+	}
+
+	m_stateCache->UseProgram(m_depthProgramID);
+	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+	m_instancedMeshes->DrawCommands(0, opaqueCommandCount);
+	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+	m_stateCache->UseProgram(m_pUniformCache->GetProgramID());
+
+	glDepthFunc(GL_EQUAL);
+	glDepthMask(GL_FALSE);
+
+	m_renderStats.Add(RenderStats::DRAW_CALLS, 1);
+}
+
+/***********************************************************
+ *  PrepareScene()
+ *
+ *  This method is used for preparing the 3D scene by loading
+ *  the shapes, textures in memory to support the 3D scene 
+ *  rendering.  False is returned when the scene file could
+ *  not be loaded without errors.
+ ***********************************************************/
+bool SceneManager::PrepareScene()
+{
+	SetupSceneLights();
+
+	// only one instance of a particular mesh needs to be
+	// loaded in memory no matter how many times it is drawn
+	// in the rendered 3D scene
+	LoadShapeGeometry();
+
+	// the scene file declares the textures and materials along
+	// with the objects that use them
+	bool bSceneLoaded = LoadSceneFile(m_sceneFilename);
+	if (!bSceneLoaded)
+	{
+		std::cout << "ERROR: The scene file " << m_sceneFilename << " has errors, see above" << std::endl;
+	}
+	UploadMaterialBuffer();
+	// the textures of the scene file are packed into texture
+	// arrays as they finish decoding - each array is bound to
+	// its own unit
+	BindGLTextures();
+	AttachLightBuffer();
+	SetupShadowMaps();
+	SetupDepthPrepass();
+
+	return(bSceneLoaded);
+}
+
+/***********************************************************
+ *  RenderScene()
+ *
+ *  This method is used for rendering the 3D scene by 
+ *  transforming and drawing the basic 3D shapes
+ ***********************************************************/
+void SceneManager::RenderScene()
+{
+	m_renderStats.Reset();
+
+	if (NULL != m_pUniformCache)
+	{
+		m_stateCache->UseProgram(m_pUniformCache->GetProgramID());
+
+		// the layout of the mesh vertices, sent once as the
+		// values never change
+		m_pUniformCache->SetBool(UniformCache::UNIFORM_COMPACT_VERTICES,
+			m_meshArena->GetVertexFormat() == MeshArena::VERTEX_COMPACT);
+		m_pUniformCache->SetVec3(UniformCache::UNIFORM_POSITION_SCALE, m_meshArena->GetPositionScale());
+		m_pUniformCache->SetVec3(UniformCache::UNIFORM_POSITION_OFFSET, m_meshArena->GetPositionOffset());
+	}
+	m_renderStats.Set(RenderStats::MESH_BYTES, (long long)m_meshArena->GetUsedBytes());
+
+	// swap in the texture images that finished decoding
+	m_textureManager->UploadCompleted(MAX_TEXTURE_UPLOADS_PER_FRAME);
+
+	UpdateObjectTransforms();
+
+	// skip the objects whose bounding box is outside the view
+	m_frustumCuller->SetFrustum(m_projectionMatrix * m_viewMatrix);
+	int visibleCount = m_frustumCuller->Cull();
+	m_renderStats.Set(RenderStats::VISIBLE_OBJECTS, visibleCount);
+	m_renderStats.Set(RenderStats::CULLED_OBJECTS, (long long)m_sceneObjects.size() - visibleCount);
+
+	// send the lights changed since the last frame
+	m_renderStats.Set(RenderStats::LIGHT_BYTES_UPLOADED, (long long)m_lightManager->Upload());
+
+	// draw the shadow casters into the maps before the scene
+	// reads them
+	if (m_bShadows)
+	{
+		RenderShadowMaps();
+	}
+
+	// list the point lights reaching each cluster of the view,
+	// timing the CPU work as part of the frame cost
+	if (m_bClusteredLights)
+	{
+		std::chrono::steady_clock::time_point buildStart = std::chrono::steady_clock::now();
+		int visibleLights = m_lightClusters->Build(*m_lightManager, m_viewMatrix, m_projectionMatrix);
+		long long buildTime = std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now() - buildStart).count();
+
+		m_renderStats.Set(RenderStats::VISIBLE_LIGHTS, visibleLights);
+		m_renderStats.Set(RenderStats::CLUSTER_LIGHT_INDICES, (long long)m_lightClusters->GetIndexCount());
+		m_renderStats.Set(RenderStats::CLUSTER_BUILD_MICROSECONDS, buildTime);
+	}
+
+	// gather one queue item per visible object with its sort key,
+	// quantizing the depth over the range of the camera
+	m_renderQueue->SetDepthRange(GetFarPlane(m_projectionMatrix));
+	m_renderQueue->Clear();
+	for (size_t i = 0; i < m_sceneObjects.size(); i++)
+	{
+		if (!m_frustumCuller->IsVisible(i))
+		{
+			continue;
+		}
+
+		SCENE_OBJECT& object = m_sceneObjects[i];
+
+		// distance of the object origin in front of the camera
+		float viewDepth = -(m_viewMatrix * object.modelMatrix[3]).z;
+		object.detailLevel = SelectDetailLevel(object, viewDepth);
+		int meshID = m_meshIDs[object.mesh][object.detailLevel];
+		if (meshID < 0)
+		{
+			continue;
+		}
+		// only color objects can be see-through
+		bool bTransparent = (object.textureIndex < 0) && (object.color.a < 1.0f);
+		// draws are grouped by texture array, since the layer
+		// can change within an instanced draw
+		int textureArray = (object.textureIndex >= 0) ? m_textureManager->GetArrayIndex(object.textureIndex) : -1;
+
+		m_renderQueue->Submit(
+			(int)i,
+			meshID,
+			textureArray,
+			object.materialIndex,
+			bTransparent,
+			viewDepth);
+	}
+
+	// group the draws by mesh, texture and material
+	m_renderQueue->Sort(m_renderStats);
+
+	// the overdraw view counts the fragments of the scene draws,
+	// each one replacing the color below it
+	if (m_bOverdraw)
+	{
+		m_overdrawCounter->BeginFrame();
+		glDisable(GL_BLEND);
+	}
+
+	// when every mesh is in the shared buffers, the whole scene
+	// is submitted with a few multi-draw indirect calls
+	if (m_bIndirectDraws && m_bInstancing)
+	{
+		BuildIndirectDraws();
+		if (m_bDepthPrepass)
+		{
+			RenderDepthPrepass();
+		}
+		RenderIndirectDraws();
+		if (m_bDepthPrepass)
+		{
+			glDepthFunc(GL_LESS);
+			glDepthMask(GL_TRUE);
+		}
+	}
+	else
+	{
+		RenderDrawBatches();
+	}
+
+	if (m_bOverdraw)
+	{
+		m_overdrawCounter->EndFrame();
+		glEnable(GL_BLEND);
+		m_renderStats.Set(RenderStats::SHADED_FRAGMENTS, m_overdrawCounter->GetShadedFragments());
+		m_renderStats.Set(RenderStats::COVERED_PIXELS, m_overdrawCounter->GetCoveredPixels());
+	}
+
+	// the counts run from the end of the previous frame, so
+	// they include the view values set before this call
+	long long issuedCount = m_stateCache->GetIssuedCount();
+	long long elidedCount = m_stateCache->GetElidedCount();
+	m_stateCache->ResetCounts();
+	if (NULL != m_pUniformCache)
+	{
+		issuedCount += m_pUniformCache->GetIssuedCount();
+		elidedCount += m_pUniformCache->GetElidedCount();
+		m_pUniformCache->ResetCounts();
+	}
+	m_renderStats.Set(RenderStats::STATE_CALLS_ISSUED, issuedCount);
+	m_renderStats.Set(RenderStats::STATE_CALLS_ELIDED, elidedCount);
+}
@@ -10,7 +10,20 @@
 #pragma once
 
 #include "ShaderManager.h"
-#include "ShapeMeshes.h"
+#include "UniformCache.h"
+#include "MeshArena.h"
+#include "InstancedMeshes.h"
+#include "FrustumCuller.h"
+#include "TextureManager.h"
+#include "TagRegistry.h"
+#include "StateCache.h"
+#include "MaterialBuffer.h"
+#include "RenderQueue.h"
+#include "RenderStats.h"
+#include "LightManager.h"
+#include "LightClusters.h"
+#include "ShadowMaps.h"
+#include "OverdrawCounter.h"
 
 #include <string>
 #include <vector>
@@ -25,16 +38,10 @@ class SceneManager
 {
 public:
 	// constructor
-	SceneManager(ShaderManager *pShaderManager);
+	SceneManager(ShaderManager *pShaderManager, UniformCache* pUniformCache);
 	// destructor
 	~SceneManager();
 
-	struct TEXTURE_INFO
-	{
-		std::string tag;
-		uint32_t ID;
-	};
-
 	struct OBJECT_MATERIAL
 	{
 		float ambientStrength;
@@ -45,29 +52,202 @@ public:
 		std::string tag;
 	};
 
+	// basic shape meshes that scene objects can be drawn with
+	enum MESH_TYPE
+	{
+		MESH_PLANE = 0,
+		MESH_BOX,
+		MESH_CYLINDER,
+		MESH_TORUS,
+		MESH_TAPERED_CYLINDER,
+		MESH_SPHERE,
+		MESH_TYPE_COUNT
+	};
+
+	// one object of the scene file, drawn with one basic mesh
+	struct SCENE_OBJECT
+	{
+		std::string name;
+		MESH_TYPE mesh;
+		glm::vec3 scaleXYZ;
+		glm::vec3 rotationDegrees;
+		glm::vec3 positionXYZ;
+		std::string textureTag;
+		std::string materialTag;
+		glm::vec2 uvScale;
+		glm::vec4 color;
+		// texture index and material index resolved from the
+		// tags when the scene is loaded, -1 if not used
+		int textureIndex;
+		int materialIndex;
+		// world matrix built from the scale, rotation and position,
+		// only rebuilt when the transform has been changed
+		glm::mat4 modelMatrix;
+		bool bTransformDirty;
+		// radius around the world bounding box, used for the
+		// detail level of the round meshes
+		float boundsRadius;
+		// detail level the object was last drawn at
+		int detailLevel;
+		// true once the object has been moved, so it is drawn
+		// into the shadow maps each frame instead of cached
+		bool bDynamic;
+	};
+
+	// a run of sorted draws that share the same mesh and texture
+	struct DRAW_BATCH
+	{
+		int firstItem;
+		int itemCount;
+		// first of the uploaded instances of the run, or -1 when
+		// the draws of the run are issued one at a time
+		int firstInstance;
+	};
+
+	// a run of indirect draw commands that share a texture
+	// array, submitted with one multi-draw call
+	struct INDIRECT_DRAW
+	{
+		int firstCommand;
+		int commandCount;
+		int instanceCount;
+		long long triangleCount;
+		// texture array of the draws, -1 for color objects
+		int textureArray;
+		// true for the see-through draws, which are left out of
+		// the depth pre-pass
+		bool bTransparent;
+	};
+
 private:
 	// pointer to shader manager object
 	ShaderManager* m_pShaderManager;
-	// pointer to basic shapes object
-	ShapeMeshes* m_basicMeshes;
-	// total number of loaded textures
-	int m_loadedTextures;
-	// loaded textures info
-	TEXTURE_INFO m_textureIDs[16];
+	// pointer to the resolved shader uniform locations
+	UniformCache* m_pUniformCache;
+	// pointer to the cache of the bound program, vertex array
+	// and textures
+	StateCache* m_stateCache;
+	// pointer to the shared buffers holding the basic shapes
+	MeshArena* m_meshArena;
+	// pointer to the instanced drawing of the basic shapes
+	InstancedMeshes* m_instancedMeshes;
+	// true when the shader and the material buffer support
+	// instanced drawing
+	bool m_bInstancing;
+	// per-instance values and draw batches of the current frame
+	std::vector<InstancedMeshes::INSTANCE_DATA> m_instances;
+	std::vector<DRAW_BATCH> m_drawBatches;
+	// indirect draw commands and multi-draws of the current frame
+	std::vector<InstancedMeshes::DRAW_COMMAND> m_drawCommands;
+	std::vector<INDIRECT_DRAW> m_indirectDraws;
+	// true to submit the scene with multi-draw indirect calls
+	bool m_bIndirectDraws;
+	// true to store the meshes in the compact vertex layout
+	bool m_bCompactVertices;
+	// arena mesh ID of each basic mesh at each detail level
+	int m_meshIDs[MESH_TYPE_COUNT][ShapeGeometry::DETAIL_LEVEL_COUNT];
+	// local bounding box of each basic mesh
+	glm::vec3 m_meshBoundsCenter[MESH_TYPE_COUNT];
+	glm::vec3 m_meshBoundsExtent[MESH_TYPE_COUNT];
+	// pointer to the world bounding boxes of the scene objects
+	FrustumCuller* m_frustumCuller;
+	// pointer to the texture arrays holding the loaded textures
+	TextureManager* m_textureManager;
 	// defined object materials
 	std::vector<OBJECT_MATERIAL> m_objectMaterials;
+	// material index of each material tag
+	TagRegistry m_materialTags;
+	// pointer to the uniform buffer holding all the materials
+	MaterialBuffer* m_materialBuffer;
+	// objects loaded from the scene file, in drawing order
+	std::vector<SCENE_OBJECT> m_sceneObjects;
+	// scene object index of each object name
+	TagRegistry m_objectNames;
+	// path of the scene file to load
+	std::string m_sceneFilename;
+	// path of the saved shape meshes, empty to always
+	// generate them
+	std::string m_meshCacheFilename;
+	// indices of the scene objects whose transform has changed
+	std::vector<int> m_dirtyObjects;
+	// pointer to the queue that sorts the draws of each frame
+	RenderQueue* m_renderQueue;
+	// pointer to the lights of the scene and their buffer
+	LightManager* m_lightManager;
+	// pointer to the per-cluster lists of the point lights
+	LightClusters* m_lightClusters;
+	// true when the shader lights each fragment with the
+	// point lights of its cluster
+	bool m_bClusteredLights;
+	// pointer to the cached shadow maps of the two global lights
+	ShadowMaps* m_shadowMaps;
+	// depth only program the shadow maps are drawn with
+	GLuint m_shadowProgramID;
+	// true when the shader samples the shadow maps
+	bool m_bShadows;
+	// false to draw every object into the shadow maps each frame
+	bool m_bShadowCache;
+	// indices of the scene objects that have been moved
+	std::vector<int> m_dynamicObjects;
+	// shadow casters sorted by mesh, with their instances and
+	// commands, the static casters first
+	std::vector<unsigned long long> m_shadowCasterKeys;
+	std::vector<InstancedMeshes::INSTANCE_DATA> m_shadowInstances;
+	std::vector<InstancedMeshes::DRAW_COMMAND> m_shadowCommands;
+	// world box around the static shadow casters
+	glm::vec3 m_shadowBoundsCenter;
+	glm::vec3 m_shadowBoundsExtent;
+	bool m_bShadowBoundsDirty;
+	// depth only program of the depth pre-pass, 0 to draw the
+	// scene without one
+	GLuint m_depthProgramID;
+	// true when the opaque draws are drawn depth only first, so
+	// the scene pass shades each pixel once
+	bool m_bDepthPrepass;
+	// true to draw the number of fragments shaded at each pixel
+	bool m_bOverdraw;
+	// pointer to the per-pixel and per-frame overdraw counters
+	OverdrawCounter* m_overdrawCounter;
+	// counters of the last rendered frame
+	RenderStats m_renderStats;
+	// view and projection matrices of the current frame
+	glm::mat4 m_viewMatrix;
+	glm::mat4 m_projectionMatrix;
 
 	// load texture images and convert to OpenGL texture data
 	bool CreateGLTexture(const char* filename, std::string tag);
-	// bind loaded OpenGL textures to slots in memory
+	// bind the texture arrays to their texture units
 	void BindGLTextures();
 	// free the loaded OpenGL textures
 	void DestroyGLTextures();
-	// find a loaded texture by tag
-	int FindTextureID(std::string tag);
-	int FindTextureSlot(std::string tag);
+	// find a loaded texture by tag, -1 if not found
+	int FindTextureIndex(const std::string& tag) const;
+	int FindTextureIndex(uint32_t hash, const char* tag) const;
+	// add a material and register its tag, false if the tag
+	// is already taken
+	bool AddMaterial(const OBJECT_MATERIAL& material);
 	// find a defined material by tag
-	bool FindMaterial(std::string tag, OBJECT_MATERIAL& material);
+	bool FindMaterial(const std::string& tag, OBJECT_MATERIAL& material) const;
+	int FindMaterialIndex(const std::string& tag) const;
+	int FindMaterialIndex(uint32_t hash, const char* tag) const;
+	// pack the defined materials into the material uniform buffer
+	void UploadMaterialBuffer();
+	// connect the light buffer to the shader and turn on the
+	// clustered lighting when the scene has point lights
+	void AttachLightBuffer();
+	// create the shadow maps when the shader samples them
+	void SetupShadowMaps();
+	// fit the box around the static shadow casters
+	void UpdateShadowBounds();
+	// add the commands drawing the static or the dynamic
+	// shadow casters, returning the number of commands
+	int AddShadowCasters(bool bDynamic);
+	// bring the shadow maps up to date and bind them
+	void RenderShadowMaps();
+	// check the depth pre-pass and overdraw view are supported
+	void SetupDepthPrepass();
+	// draw the depth of the opaque indirect commands
+	void RenderDepthPrepass();
 
 	// set the transformation values 
 	// into the transform buffer
@@ -78,6 +258,21 @@ private:
 		float ZrotationDegrees,
 		glm::vec3 positionXYZ);
 
+	// build the world matrix from the transformation values
+	static glm::mat4 CalculateModelMatrix(
+		glm::vec3 scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		glm::vec3 positionXYZ);
+
+	// set a prepared world matrix into the transform buffer
+	void SetModelMatrix(const glm::mat4& modelMatrix);
+
+	// rebuild the world matrices and bounding boxes of the
+	// changed scene objects
+	void UpdateObjectTransforms();
+
 	// set the color values into the shader
 	void SetShaderColor(
 		float redColorValue,
@@ -85,43 +280,112 @@ private:
 		float blueColorValue,
 		float alphaValue);
 
-	// set the texture data into the shader
+	// set the texture data into the shader, by tag, by a tag
+	// hashed with TAG_ID or by texture index
+	void SetShaderTexture(
+		const std::string& textureTag);
 	void SetShaderTexture(
-		std::string textureTag);
+		uint32_t tagHash,
+		const char* textureTag);
+	void SetShaderTexture(
+		int textureIndex);
 
 	// set the UV scale for the texture mapping
 	void SetTextureUVScale(
 		float u, float v);
 
-	// set the object material into the shader
+	// set the object material into the shader, by tag, by a
+	// tag hashed with TAG_ID or by material index
+	void SetShaderMaterial(
+		const std::string& materialTag);
 	void SetShaderMaterial(
-		std::string materialTag);
+		uint32_t tagHash,
+		const char* materialTag);
+	void SetShaderMaterial(
+		int materialIndex);
+
+	// read the scene objects from the scene file
+	bool LoadSceneFile(const std::string& filename);
+	// draw one of the basic meshes
+	void DrawMesh(int meshID);
+	// pick the detail level of an object from its size on screen
+	int SelectDetailLevel(const SCENE_OBJECT& object, float viewDepth) const;
+	// build the basic shapes into the mesh arena and store
+	// their bounds
+	void LoadShapeGeometry();
+	// add the per-instance values of a scene object to the frame
+	void AddInstance(const SCENE_OBJECT& object);
+	// group the sorted draws into batches and upload the instances
+	void BuildDrawBatches();
+	// build the indirect commands of all the sorted draws and
+	// upload them with the instances
+	void BuildIndirectDraws();
+	// submit the whole scene with the indirect commands
+	void RenderIndirectDraws();
+	// draw all the copies of a batch with one draw call
+	void RenderInstancedBatch(const DRAW_BATCH& batch);
+	// draw the sorted draws in batches, or one object at a time
+	void RenderDrawBatches();
+	// set the shader values for a scene object and draw it,
+	// skipping the values that the previous object already set
+	void RenderSceneObject(
+		const SCENE_OBJECT& object,
+		const SCENE_OBJECT* pPrevious);
 
 public:
 
+	// set the scene file loaded by PrepareScene
+	void SetSceneFile(const std::string& filename);
+	// wait until every texture image has been uploaded
+	void FinishTextureLoading();
+	// choose between the multi-draw indirect submission and
+	// the batched draws, when the shader supports both
+	void SetIndirectDraws(bool bIndirectDraws) { m_bIndirectDraws = bIndirectDraws; }
+	// choose the compact vertex layout for the meshes, before
+	// PrepareScene is called
+	void SetCompactVertices(bool bCompactVertices) { m_bCompactVertices = bCompactVertices; }
+	// set the file the shape meshes are saved to and loaded
+	// from, or an empty name to always generate them
+	void SetMeshCacheFile(const std::string& filename) { m_meshCacheFilename = filename; }
+	// set the depth only program of the shadow maps, before
+	// PrepareScene is called
+	void SetShadowProgram(GLuint programID) { m_shadowProgramID = programID; }
+	// choose between caching the shadows of the static objects
+	// and drawing every object into the shadow maps each frame
+	void SetShadowCache(bool bShadowCache) { m_bShadowCache = bShadowCache; }
+	// set the depth only program of the depth pre-pass, or 0
+	// for none, before PrepareScene is called
+	void SetDepthPrepassProgram(GLuint programID) { m_depthProgramID = programID; }
+	// draw the number of fragments shaded at each pixel instead
+	// of the lit scene, before PrepareScene is called
+	void SetOverdrawView(bool bOverdraw) { m_bOverdraw = bOverdraw; }
+
+	// set the view and projection matrices of the current frame
+	void SetViewTransforms(
+		const glm::mat4& view,
+		const glm::mat4& projection);
+	// get the counters of the last rendered frame
+	const RenderStats& GetRenderStats() const { return(m_renderStats); }
+
+	// find a loaded scene object by name, -1 if not found
+	int FindSceneObject(const std::string& name);
+	// change the transform of a loaded scene object
+	void SetObjectTransform(
+		int objectIndex,
+		glm::vec3 scaleXYZ,
+		glm::vec3 rotationDegrees,
+		glm::vec3 positionXYZ);
+	// get the number of scene lights, the two lights of
+	// SetupSceneLights followed by the scene file lights
+	int GetLightCount() const { return(m_lightManager->GetLightCount()); }
+	// move a scene light, uploaded with the next frame
+	void SetLightPosition(int lightIndex, glm::vec3 positionXYZ);
+
 	// The following methods are for the students to 
 	// customize for their own 3D scene
-	void PrepareScene();
+	bool PrepareScene();
 
 	void RenderScene();
-	// load all of the needed textures before rendering
-	void LoadSceneTextures();
-	// define all the object materials before rendering
-	void DefineObjectMaterials();
 	// add and define the light sources before rendering
 	void SetupSceneLights();
-
-	// methods for rendering the various objects in the 3D scene
-	void RenderPlane();
-	void RenderMugBody();
-	void RenderMugHandle();
-	void RenderMonitorHandle();
-	void RenderMonitorScreen();
-	void RenderMonitorBase();
-	void RenderMonitorStand();
-	void RenderMouse();
-	void RenderKeyboard();
-	void RenderBook1();
-	void RenderBook2();
-	
 };
\ No newline at end of file
@@ -0,0 +1,42 @@
+///////////////////////////////////////////////////////////////////////////////
+// shaderbindings.h
+// ============
+// fixed binding points and array sizes shared with the GLSL shaders
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// the values below must match the layout qualifiers and the
+// defines in the GLSL files of the Shaders folder
+
+// uniform buffer binding point of the CameraBlock
+const int CAMERA_BLOCK_BINDING = 0;
+
+// uniform buffer binding point of the MaterialBlock
+const int MATERIAL_BLOCK_BINDING = 1;
+
+// shader storage buffer binding points of the LightBlock, the
+// ClusterBlock and the ClusterIndexBlock
+const int LIGHT_BUFFER_BINDING = 2;
+const int CLUSTER_BUFFER_BINDING = 3;
+const int CLUSTER_INDEX_BUFFER_BINDING = 4;
+
+// number of materials that fit in the MaterialBlock
+const int MAX_SCENE_MATERIALS = 64;
+
+// texture units of the shadow maps, above the units used by the
+// scene texture arrays
+const int SHADOW_MAP_TEXTURE_UNIT = 30;
+const int SHADOW_CUBE_TEXTURE_UNIT = 31;
+
+// scene lights drawn with a shadow cube map and a 2D shadow map
+const int SHADOW_CUBE_LIGHT = 0;
+const int SHADOW_MAP_LIGHT = 1;
+
+// atomic counter binding point of the overdraw counters and image
+// unit of the per-pixel fragment counts
+const int OVERDRAW_COUNTER_BINDING = 0;
+const int OVERDRAW_IMAGE_UNIT = 0;
@@ -0,0 +1,522 @@
+///////////////////////////////////////////////////////////////////////////////
+// shadowmaps.cpp
+// ============
+// cache the shadow maps of the static scene and add the moving objects
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ShadowMaps.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// nearest distance drawn into the cube map
+	const float CUBE_NEAR_DEPTH = 0.05f;
+	// room left around the casters in the light projections
+	const float BOUNDS_MARGIN = 0.5f;
+
+	// direction and up vector of each cube map face, in the
+	// order of the GL_TEXTURE_CUBE_MAP_POSITIVE_X faces
+	const glm::vec3 g_CubeDirections[6] =
+	{
+		glm::vec3(1.0f, 0.0f, 0.0f),
+		glm::vec3(-1.0f, 0.0f, 0.0f),
+		glm::vec3(0.0f, 1.0f, 0.0f),
+		glm::vec3(0.0f, -1.0f, 0.0f),
+		glm::vec3(0.0f, 0.0f, 1.0f),
+		glm::vec3(0.0f, 0.0f, -1.0f)
+	};
+	const glm::vec3 g_CubeUps[6] =
+	{
+		glm::vec3(0.0f, -1.0f, 0.0f),
+		glm::vec3(0.0f, -1.0f, 0.0f),
+		glm::vec3(0.0f, 0.0f, 1.0f),
+		glm::vec3(0.0f, 0.0f, -1.0f),
+		glm::vec3(0.0f, -1.0f, 0.0f),
+		glm::vec3(0.0f, -1.0f, 0.0f)
+	};
+}
+
+/***********************************************************
+ *  ShadowMaps()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ShadowMaps::ShadowMaps(InstancedMeshes* pInstancedMeshes, StateCache* pStateCache)
+{
+	m_pInstancedMeshes = pInstancedMeshes;
+	m_pStateCache = pStateCache;
+	m_programID = 0;
+	m_viewProjectionLocation = -1;
+	m_lightPositionFarLocation = -1;
+	m_positionScaleLocation = -1;
+	m_positionOffsetLocation = -1;
+	m_framebufferID = 0;
+	m_staticMap = 0;
+	m_staticCubeMap = 0;
+	m_frameMap = 0;
+	m_frameCubeMap = 0;
+	m_bFrameMaps = false;
+	m_bStaticDirty = true;
+	m_bCaching = true;
+	m_pointLightPosition = glm::vec3(0.0f);
+	m_directionalLightDirection = glm::vec3(0.0f);
+	m_boundsCenter = glm::vec3(0.0f);
+	m_boundsExtent = glm::vec3(0.0f);
+	m_bLightsSet = false;
+	m_shadowMatrix = glm::mat4(1.0f);
+	for (int face = 0; face < 6; face++)
+	{
+		m_cubeMatrices[face] = glm::mat4(1.0f);
+	}
+	m_cubeFar = 1.0f;
+	for (int slot = 0; slot < FRAME_COUNT; slot++)
+	{
+		for (int query = 0; query < QUERY_COUNT; query++)
+		{
+			m_frameQueries[slot][query] = 0;
+		}
+		m_bStaticPending[slot] = false;
+		m_bFramePending[slot] = false;
+	}
+	m_frameSlot = 0;
+	m_bStaticReported = false;
+	m_staticMicroseconds = 0;
+	m_frameMicroseconds = 0;
+	m_savedMicroseconds = 0;
+}
+
+/***********************************************************
+ *  ~ShadowMaps()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ShadowMaps::~ShadowMaps()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  CreateDepthTexture()
+ *
+ *  This method is used for creating a depth texture that
+ *  the shader samples with a depth comparison, so each
+ *  lookup returns how much of its 2x2 texels are lit.
+ ***********************************************************/
+GLuint ShadowMaps::CreateDepthTexture(GLenum target, int size)
+{
+	GLuint textureID = 0;
+	glCreateTextures(target, 1, &textureID);
+	glTextureStorage2D(textureID, 1, GL_DEPTH_COMPONENT32F, size, size);
+	glTextureParameteri(textureID, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTextureParameteri(textureID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTextureParameteri(textureID, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+	glTextureParameteri(textureID, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+
+	if (target == GL_TEXTURE_2D)
+	{
+		// everything outside the directional map is lit
+		const float border[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+		glTextureParameteri(textureID, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+		glTextureParameteri(textureID, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+		glTextureParameterfv(textureID, GL_TEXTURE_BORDER_COLOR, border);
+	}
+	else
+	{
+		glTextureParameteri(textureID, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(textureID, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(textureID, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+	}
+
+	return(textureID);
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for creating the cached maps, their
+ *  copies, the framebuffer they are drawn through and the
+ *  timer queries.  The passed in program only writes depth.
+ ***********************************************************/
+bool ShadowMaps::Create(GLuint programID)
+{
+	if (programID == 0)
+	{
+		return false;
+	}
+
+	m_programID = programID;
+	m_viewProjectionLocation = glGetUniformLocation(programID, "lightViewProjection");
+	m_lightPositionFarLocation = glGetUniformLocation(programID, "lightPositionFar");
+	m_positionScaleLocation = glGetUniformLocation(programID, "positionScale");
+	m_positionOffsetLocation = glGetUniformLocation(programID, "positionOffset");
+
+	m_staticMap = CreateDepthTexture(GL_TEXTURE_2D, SHADOW_MAP_SIZE);
+	m_frameMap = CreateDepthTexture(GL_TEXTURE_2D, SHADOW_MAP_SIZE);
+	m_staticCubeMap = CreateDepthTexture(GL_TEXTURE_CUBE_MAP, SHADOW_CUBE_SIZE);
+	m_frameCubeMap = CreateDepthTexture(GL_TEXTURE_CUBE_MAP, SHADOW_CUBE_SIZE);
+
+	// the maps are drawn without any color attachment
+	glCreateFramebuffers(1, &m_framebufferID);
+	glNamedFramebufferDrawBuffer(m_framebufferID, GL_NONE);
+	glNamedFramebufferReadBuffer(m_framebufferID, GL_NONE);
+	glNamedFramebufferTexture(m_framebufferID, GL_DEPTH_ATTACHMENT, m_staticMap, 0);
+	GLenum status = glCheckNamedFramebufferStatus(m_framebufferID, GL_DRAW_FRAMEBUFFER);
+	if (status != GL_FRAMEBUFFER_COMPLETE)
+	{
+		std::cout << "Shadow map framebuffer is incomplete, status: 0x" << std::hex << status << std::dec << std::endl;
+		Destroy();
+		return false;
+	}
+
+	for (int slot = 0; slot < FRAME_COUNT; slot++)
+	{
+		glGenQueries(QUERY_COUNT, m_frameQueries[slot]);
+	}
+
+	m_bStaticDirty = true;
+
+	return true;
+}
+
+/***********************************************************
+ *  SetPositionDecoding()
+ *
+ *  This method is used for setting the box the vertex
+ *  positions of the mesh arena are quantized in, the same
+ *  values the scene vertex shader decodes them with.
+ ***********************************************************/
+void ShadowMaps::SetPositionDecoding(const glm::vec3& scale, const glm::vec3& offset)
+{
+	if (m_programID == 0)
+	{
+		return;
+	}
+
+	glProgramUniform3fv(m_programID, m_positionScaleLocation, 1, glm::value_ptr(scale));
+	glProgramUniform3fv(m_programID, m_positionOffsetLocation, 1, glm::value_ptr(offset));
+	m_bStaticDirty = true;
+}
+
+/***********************************************************
+ *  SetLights()
+ *
+ *  This method is used for fitting the light projections to
+ *  the passed in lights and the box around the shadow
+ *  casters.  The directional map looks along the light
+ *  direction at the center of the box, from just outside
+ *  it, with an orthographic projection just holding the
+ *  box.  The cube map reaches the farthest corner of the
+ *  box.  The cached maps only become stale when one of the
+ *  values changes.
+ ***********************************************************/
+void ShadowMaps::SetLights(
+	const glm::vec3& pointLightPosition,
+	const glm::vec3& directionalLightDirection,
+	const glm::vec3& boundsCenter,
+	const glm::vec3& boundsExtent)
+{
+	if ((pointLightPosition == m_pointLightPosition) &&
+		(directionalLightDirection == m_directionalLightDirection) &&
+		(boundsCenter == m_boundsCenter) &&
+		(boundsExtent == m_boundsExtent) &&
+		m_bLightsSet)
+	{
+		return;
+	}
+
+	m_pointLightPosition = pointLightPosition;
+	m_directionalLightDirection = directionalLightDirection;
+	m_boundsCenter = boundsCenter;
+	m_boundsExtent = boundsExtent;
+	m_bLightsSet = true;
+	m_bStaticDirty = true;
+
+	// the up vector must not be parallel to the light direction
+	glm::vec3 toLight = glm::normalize(directionalLightDirection);
+	glm::vec3 up = (std::abs(toLight.y) > 0.99f) ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+	glm::vec3 eye = boundsCenter + toLight * (glm::length(boundsExtent) + BOUNDS_MARGIN);
+	glm::mat4 lightView = glm::lookAt(eye, boundsCenter, up);
+
+	glm::vec3 lightMinimum(1e30f);
+	glm::vec3 lightMaximum(-1e30f);
+	float farthestCorner = 0.0f;
+	for (int corner = 0; corner < 8; corner++)
+	{
+		glm::vec3 sign(
+			((corner & 1) != 0) ? 1.0f : -1.0f,
+			((corner & 2) != 0) ? 1.0f : -1.0f,
+			((corner & 4) != 0) ? 1.0f : -1.0f);
+		glm::vec3 worldCorner = boundsCenter + boundsExtent * sign;
+		glm::vec3 lightCorner = glm::vec3(lightView * glm::vec4(worldCorner, 1.0f));
+		lightMinimum = glm::min(lightMinimum, lightCorner);
+		lightMaximum = glm::max(lightMaximum, lightCorner);
+		farthestCorner = std::max(farthestCorner, glm::length(worldCorner - pointLightPosition));
+	}
+
+	// the view looks down -Z, so the nearest depth is -maximum.z
+	glm::mat4 lightProjection = glm::ortho(
+		lightMinimum.x - BOUNDS_MARGIN, lightMaximum.x + BOUNDS_MARGIN,
+		lightMinimum.y - BOUNDS_MARGIN, lightMaximum.y + BOUNDS_MARGIN,
+		-lightMaximum.z - BOUNDS_MARGIN, -lightMinimum.z + BOUNDS_MARGIN);
+	m_shadowMatrix = lightProjection * lightView;
+
+	m_cubeFar = farthestCorner + BOUNDS_MARGIN + 1.0f;
+	glm::mat4 cubeProjection = glm::perspective(glm::radians(90.0f), 1.0f, CUBE_NEAR_DEPTH, m_cubeFar);
+	for (int face = 0; face < 6; face++)
+	{
+		m_cubeMatrices[face] = cubeProjection * glm::lookAt(
+			pointLightPosition,
+			pointLightPosition + g_CubeDirections[face],
+			g_CubeUps[face]);
+	}
+}
+
+/***********************************************************
+ *  RenderPass()
+ *
+ *  This method is used for drawing a range of the uploaded
+ *  commands into the 2D map, or into one face of the cube
+ *  map when a face index is passed.  The cube map stores
+ *  the distance to the light divided by its far distance,
+ *  the 2D map the depth of the orthographic projection.
+ ***********************************************************/
+void ShadowMaps::RenderPass(
+	GLuint texture,
+	int face,
+	const glm::mat4& viewProjection,
+	const glm::vec4& lightPositionFar,
+	int firstCommand,
+	int commandCount,
+	bool bClear)
+{
+	if (face < 0)
+	{
+		glNamedFramebufferTexture(m_framebufferID, GL_DEPTH_ATTACHMENT, texture, 0);
+	}
+	else
+	{
+		glNamedFramebufferTextureLayer(m_framebufferID, GL_DEPTH_ATTACHMENT, texture, 0, face);
+	}
+
+	if (bClear)
+	{
+		const float clearDepth = 1.0f;
+		glClearNamedFramebufferfv(m_framebufferID, GL_DEPTH, 0, &clearDepth);
+	}
+
+	glProgramUniformMatrix4fv(m_programID, m_viewProjectionLocation, 1, GL_FALSE, glm::value_ptr(viewProjection));
+	glProgramUniform4fv(m_programID, m_lightPositionFarLocation, 1, glm::value_ptr(lightPositionFar));
+
+	m_pInstancedMeshes->DrawCommands(firstCommand, commandCount);
+}
+
+/***********************************************************
+ *  RenderMaps()
+ *
+ *  This method is used for drawing a range of the uploaded
+ *  commands into the passed in 2D map and all six faces of
+ *  the passed in cube map.
+ ***********************************************************/
+void ShadowMaps::RenderMaps(GLuint map, GLuint cubeMap, int firstCommand, int commandCount, bool bClear)
+{
+	// a zero w keeps the depth of the projection
+	glViewport(0, 0, SHADOW_MAP_SIZE, SHADOW_MAP_SIZE);
+	RenderPass(map, -1, m_shadowMatrix, glm::vec4(0.0f), firstCommand, commandCount, bClear);
+
+	glViewport(0, 0, SHADOW_CUBE_SIZE, SHADOW_CUBE_SIZE);
+	glm::vec4 lightPositionFar(m_pointLightPosition, m_cubeFar);
+	for (int face = 0; face < 6; face++)
+	{
+		RenderPass(cubeMap, face, m_cubeMatrices[face], lightPositionFar, firstCommand, commandCount, bClear);
+	}
+}
+
+/***********************************************************
+ *  Render()
+ *
+ *  This method is used for bringing the maps up to date for
+ *  the frame.  With caching, the static commands are drawn
+ *  into the cached maps only when they are stale, and the
+ *  dynamic commands are drawn over a GPU copy of them.
+ *  Without caching, all the commands are drawn into the
+ *  frame maps every frame.  The framebuffer, viewport and
+ *  program in use are restored afterwards.
+ ***********************************************************/
+void ShadowMaps::Render(int staticCommandCount, int dynamicCommandCount)
+{
+	if (!IsReady())
+	{
+		return;
+	}
+
+	bool bStaticWork = m_bCaching && m_bStaticDirty;
+	bool bFrameWork = !m_bCaching || (dynamicCommandCount > 0);
+	m_bFrameMaps = bFrameWork;
+	if (!bStaticWork && !bFrameWork)
+	{
+		// the cached maps are read as they are
+		m_frameMicroseconds = 0;
+		m_savedMicroseconds = m_staticMicroseconds;
+		return;
+	}
+
+	// the slot is reused FRAME_COUNT frames later, when its
+	// timestamps are long done
+	int slot = m_frameSlot;
+	CollectQueries(slot);
+
+	GLint previousFramebuffer = 0;
+	GLint previousViewport[4] = { 0, 0, 0, 0 };
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousFramebuffer);
+	glGetIntegerv(GL_VIEWPORT, previousViewport);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_framebufferID);
+	m_pStateCache->UseProgram(m_programID);
+
+	if (bStaticWork)
+	{
+		// the time of the static draws is the cost every frame
+		// would pay without the cache
+		glQueryCounter(m_frameQueries[slot][QUERY_STATIC_START], GL_TIMESTAMP);
+		RenderMaps(m_staticMap, m_staticCubeMap, 0, staticCommandCount, true);
+		glQueryCounter(m_frameQueries[slot][QUERY_STATIC_END], GL_TIMESTAMP);
+		m_bStaticPending[slot] = true;
+		m_bStaticDirty = false;
+	}
+
+	if (bFrameWork)
+	{
+		glQueryCounter(m_frameQueries[slot][QUERY_FRAME_START], GL_TIMESTAMP);
+		if (m_bCaching)
+		{
+			glCopyImageSubData(
+				m_staticMap, GL_TEXTURE_2D, 0, 0, 0, 0,
+				m_frameMap, GL_TEXTURE_2D, 0, 0, 0, 0,
+				SHADOW_MAP_SIZE, SHADOW_MAP_SIZE, 1);
+			glCopyImageSubData(
+				m_staticCubeMap, GL_TEXTURE_CUBE_MAP, 0, 0, 0, 0,
+				m_frameCubeMap, GL_TEXTURE_CUBE_MAP, 0, 0, 0, 0,
+				SHADOW_CUBE_SIZE, SHADOW_CUBE_SIZE, 6);
+		}
+		glQueryCounter(m_frameQueries[slot][QUERY_COPY_END], GL_TIMESTAMP);
+
+		if (m_bCaching)
+		{
+			RenderMaps(m_frameMap, m_frameCubeMap, staticCommandCount, dynamicCommandCount, false);
+		}
+		else
+		{
+			RenderMaps(m_frameMap, m_frameCubeMap, 0, staticCommandCount + dynamicCommandCount, true);
+		}
+		glQueryCounter(m_frameQueries[slot][QUERY_FRAME_END], GL_TIMESTAMP);
+		m_bFramePending[slot] = true;
+	}
+	else
+	{
+		m_frameMicroseconds = 0;
+		m_savedMicroseconds = m_staticMicroseconds;
+	}
+	m_frameSlot = (slot + 1) % FRAME_COUNT;
+
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, (GLuint)previousFramebuffer);
+	glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+}
+
+/***********************************************************
+ *  CollectQueries()
+ *
+ *  This method is used for reading the timestamps placed in
+ *  the passed in slot FRAME_COUNT frames earlier.  Drawing
+ *  the static objects again would have cost the time they
+ *  took when cached, while the cache costs the copy, so
+ *  their difference is saved.
+ ***********************************************************/
+void ShadowMaps::CollectQueries(int slot)
+{
+	GLuint64 timestamps[QUERY_COUNT] = { 0, 0, 0, 0, 0 };
+
+	if (m_bStaticPending[slot])
+	{
+		glGetQueryObjectui64v(m_frameQueries[slot][QUERY_STATIC_START], GL_QUERY_RESULT, &timestamps[QUERY_STATIC_START]);
+		glGetQueryObjectui64v(m_frameQueries[slot][QUERY_STATIC_END], GL_QUERY_RESULT, &timestamps[QUERY_STATIC_END]);
+		m_bStaticPending[slot] = false;
+		m_staticMicroseconds = (long long)(timestamps[QUERY_STATIC_END] - timestamps[QUERY_STATIC_START]) / 1000;
+
+		// the cache is rebuilt whenever a light moves, so only
+		// the first build is printed
+		if (!m_bStaticReported)
+		{
+			std::cout << "Rendered the static shadow maps in " << m_staticMicroseconds / 1000.0
+				<< " ms on the GPU" << std::endl;
+			m_bStaticReported = true;
+		}
+	}
+
+	if (m_bFramePending[slot])
+	{
+		for (int query = QUERY_FRAME_START; query <= QUERY_FRAME_END; query++)
+		{
+			glGetQueryObjectui64v(m_frameQueries[slot][query], GL_QUERY_RESULT, &timestamps[query]);
+		}
+		m_bFramePending[slot] = false;
+
+		long long copyMicroseconds = (long long)(timestamps[QUERY_COPY_END] - timestamps[QUERY_FRAME_START]) / 1000;
+		m_frameMicroseconds = (long long)(timestamps[QUERY_FRAME_END] - timestamps[QUERY_FRAME_START]) / 1000;
+		m_savedMicroseconds = m_bCaching ? std::max(0LL, m_staticMicroseconds - copyMicroseconds) : 0;
+	}
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for freeing the maps, the framebuffer
+ *  and the timer queries.  The program belongs to the
+ *  shader manager that loaded it.
+ ***********************************************************/
+void ShadowMaps::Destroy()
+{
+	GLuint textures[4] = { m_staticMap, m_staticCubeMap, m_frameMap, m_frameCubeMap };
+	for (int i = 0; i < 4; i++)
+	{
+		if (textures[i] != 0)
+		{
+			glDeleteTextures(1, &textures[i]);
+		}
+	}
+	m_staticMap = 0;
+	m_staticCubeMap = 0;
+	m_frameMap = 0;
+	m_frameCubeMap = 0;
+
+	if (m_framebufferID != 0)
+	{
+		glDeleteFramebuffers(1, &m_framebufferID);
+		m_framebufferID = 0;
+	}
+
+	for (int slot = 0; slot < FRAME_COUNT; slot++)
+	{
+		if (m_frameQueries[slot][0] != 0)
+		{
+			glDeleteQueries(QUERY_COUNT, m_frameQueries[slot]);
+		}
+		for (int query = 0; query < QUERY_COUNT; query++)
+		{
+			m_frameQueries[slot][query] = 0;
+		}
+		m_bStaticPending[slot] = false;
+		m_bFramePending[slot] = false;
+	}
+
+	m_programID = 0;
+	m_bFrameMaps = false;
+	m_bStaticDirty = true;
+}
@@ -0,0 +1,180 @@
+///////////////////////////////////////////////////////////////////////////////
+// shadowmaps.h
+// ============
+// cache the shadow maps of the static scene and add the moving objects
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "InstancedMeshes.h"
+#include "StateCache.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+/***********************************************************
+ *  ShadowMaps
+ *
+ *  This class draws the depth of the scene as seen from the
+ *  two lights of SetupSceneLights: a 2D map for the
+ *  directional light and a cube map holding the distance to
+ *  the point light.  The directional light is lit in the
+ *  fragment shader as a true directional light, its position
+ *  taken as the direction toward it, so its map uses an
+ *  orthographic projection along that direction, fitted
+ *  around the shadow casters.
+ *
+ *  The static objects are drawn once into a pair of cached
+ *  maps, and only again when a light or the set of static
+ *  objects changes.  When the scene has dynamic objects,
+ *  each frame copies the cached maps into a second pair on
+ *  the GPU and draws only the dynamic objects over them.
+ *  Without dynamic objects the cached maps are read as they
+ *  are, and a frame costs no shadow work at all.
+ *
+ *  The draws read the model matrices of the instances and
+ *  the commands uploaded to InstancedMeshes: the static
+ *  objects first, then the dynamic ones.  All the GPU times
+ *  are read FRAME_COUNT frames late, so rebuilding the
+ *  cached maps, e.g. while a light moves, never waits on
+ *  the GPU.
+ ***********************************************************/
+class ShadowMaps
+{
+public:
+	// constructor
+	ShadowMaps(InstancedMeshes* pInstancedMeshes, StateCache* pStateCache);
+	// destructor
+	~ShadowMaps();
+
+	// size of the directional map and of each cube map face
+	static const int SHADOW_MAP_SIZE = 2048;
+	static const int SHADOW_CUBE_SIZE = 1024;
+	// number of frames the timer results are read behind
+	static const int FRAME_COUNT = 3;
+
+	// create the maps for the passed in depth only program
+	bool Create(GLuint programID);
+	// set the box the mesh arena positions are quantized in
+	void SetPositionDecoding(const glm::vec3& scale, const glm::vec3& offset);
+	// set the point light position, the direction toward the
+	// directional light and the box around the shadow casters,
+	// marking the cached maps stale when they change
+	void SetLights(
+		const glm::vec3& pointLightPosition,
+		const glm::vec3& directionalLightDirection,
+		const glm::vec3& boundsCenter,
+		const glm::vec3& boundsExtent);
+	// mark the cached maps stale after a static object changed
+	void Invalidate() { m_bStaticDirty = true; }
+	// choose between caching the static objects and drawing
+	// every object into the maps each frame
+	void SetCaching(bool bCaching) { m_bCaching = bCaching; }
+	// draw the uploaded commands into the maps - the static
+	// commands are only passed when NeedsStaticCasters is true
+	void Render(int staticCommandCount, int dynamicCommandCount);
+	// free the maps, framebuffer and timer queries
+	void Destroy();
+
+	// true when the static objects must be uploaded and drawn
+	bool NeedsStaticCasters() const { return(m_bStaticDirty || !m_bCaching); }
+	// true when the maps were created
+	bool IsReady() const { return(m_framebufferID != 0); }
+
+	// get the maps to sample and the values to sample them with
+	GLuint GetShadowMap() const { return(m_bFrameMaps ? m_frameMap : m_staticMap); }
+	GLuint GetShadowCubeMap() const { return(m_bFrameMaps ? m_frameCubeMap : m_staticCubeMap); }
+	const glm::mat4& GetShadowMatrix() const { return(m_shadowMatrix); }
+	float GetCubeFar() const { return(m_cubeFar); }
+
+	// get the GPU time of the shadow work of a recent frame,
+	// and the estimated time saved by the cached maps, in
+	// microseconds
+	long long GetFrameMicroseconds() const { return(m_frameMicroseconds); }
+	long long GetSavedMicroseconds() const { return(m_savedMicroseconds); }
+
+private:
+	// create a depth texture for the 2D or the cube map
+	static GLuint CreateDepthTexture(GLenum target, int size);
+	// draw a range of the commands into the 2D map and the
+	// six cube map faces
+	void RenderMaps(GLuint map, GLuint cubeMap, int firstCommand, int commandCount, bool bClear);
+	// draw a range of the commands into one map or face
+	void RenderPass(
+		GLuint texture,
+		int face,
+		const glm::mat4& viewProjection,
+		const glm::vec4& lightPositionFar,
+		int firstCommand,
+		int commandCount,
+		bool bClear);
+	// read the timer results of the passed in frame slot
+	void CollectQueries(int slot);
+
+	// pointer to the instanced drawing of the basic shapes
+	InstancedMeshes* m_pInstancedMeshes;
+	// pointer to the cache of the bound program
+	StateCache* m_pStateCache;
+
+	// depth only program and its uniform locations
+	GLuint m_programID;
+	GLint m_viewProjectionLocation;
+	GLint m_lightPositionFarLocation;
+	GLint m_positionScaleLocation;
+	GLint m_positionOffsetLocation;
+
+	// framebuffer the maps are attached to while drawn
+	GLuint m_framebufferID;
+	// maps holding the static objects only
+	GLuint m_staticMap;
+	GLuint m_staticCubeMap;
+	// copies of the static maps with the dynamic objects added
+	GLuint m_frameMap;
+	GLuint m_frameCubeMap;
+	// true when the copies are the maps to sample
+	bool m_bFrameMaps;
+
+	// true when the static maps must be drawn again
+	bool m_bStaticDirty;
+	// false to draw every object into the maps each frame
+	bool m_bCaching;
+
+	// light values the maps were drawn for
+	glm::vec3 m_pointLightPosition;
+	glm::vec3 m_directionalLightDirection;
+	glm::vec3 m_boundsCenter;
+	glm::vec3 m_boundsExtent;
+	// true once the light projections have been fitted
+	bool m_bLightsSet;
+	// world to light clip space of the directional map
+	glm::mat4 m_shadowMatrix;
+	// world to clip space of each cube map face
+	glm::mat4 m_cubeMatrices[6];
+	// distance stored as depth 1 in the cube map
+	float m_cubeFar;
+
+	// timestamps of each frame in flight, the work they were
+	// placed around and the frame slot of the next frame
+	enum QUERY_ID
+	{
+		QUERY_STATIC_START = 0,
+		QUERY_STATIC_END,
+		QUERY_FRAME_START,
+		QUERY_COPY_END,
+		QUERY_FRAME_END,
+		QUERY_COUNT
+	};
+	GLuint m_frameQueries[FRAME_COUNT][QUERY_COUNT];
+	bool m_bStaticPending[FRAME_COUNT];
+	bool m_bFramePending[FRAME_COUNT];
+	int m_frameSlot;
+	// true once the time of the first static build was printed
+	bool m_bStaticReported;
+	// GPU times in microseconds
+	long long m_staticMicroseconds;
+	long long m_frameMicroseconds;
+	long long m_savedMicroseconds;
+};
@@ -0,0 +1,429 @@
+///////////////////////////////////////////////////////////////////////////////
+// shapegeometry.cpp
+// ============
+// generate the vertex and index data of the basic shape meshes
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ShapeGeometry.h"
+
+#include <glm/gtc/constants.hpp>
+
+#include <cmath>
+#include <sstream>
+
+// declaration of global variables
+namespace
+{
+	// number of segments around the round shapes, per detail level
+	const int g_RoundSegments[ShapeGeometry::DETAIL_LEVEL_COUNT] = { 36, 18, 12, 8 };
+	// number of rings from pole to pole of the sphere
+	const int g_SphereStacks[ShapeGeometry::DETAIL_LEVEL_COUNT] = { 18, 9, 6, 4 };
+	// number of segments around the tube of the torus
+	const int g_TorusTubeSegments[ShapeGeometry::DETAIL_LEVEL_COUNT] = { 18, 9, 6, 4 };
+
+	// raised whenever the shapes are built differently
+	const int GENERATOR_VERSION = 1;
+
+	const float TORUS_RING_RADIUS = 1.0f;
+	const float TORUS_TUBE_RADIUS = 0.1f;
+
+	/***********************************************************
+	 *  ClampDetailLevel()
+	 *
+	 *  This function is used for keeping a requested detail
+	 *  level within the levels that can be built.
+	 ***********************************************************/
+	int ClampDetailLevel(int detailLevel)
+	{
+		if (detailLevel < 0)
+		{
+			return(0);
+		}
+		if (detailLevel >= ShapeGeometry::DETAIL_LEVEL_COUNT)
+		{
+			return(ShapeGeometry::DETAIL_LEVEL_COUNT - 1);
+		}
+		return(detailLevel);
+	}
+
+	/***********************************************************
+	 *  AddVertex()
+	 *
+	 *  This function is used for appending a vertex to the
+	 *  passed in geometry and returning its index.
+	 ***********************************************************/
+	GLuint AddVertex(
+		ShapeGeometry::SHAPE_GEOMETRY& geometry,
+		glm::vec3 position,
+		glm::vec3 normal,
+		glm::vec2 textureCoordinate)
+	{
+		ShapeGeometry::SHAPE_VERTEX vertex;
+		vertex.position = position;
+		vertex.normal = normal;
+		vertex.textureCoordinate = textureCoordinate;
+		geometry.vertices.push_back(vertex);
+
+		return((GLuint)geometry.vertices.size() - 1);
+	}
+
+	/***********************************************************
+	 *  AddQuad()
+	 *
+	 *  This function is used for appending the two triangles
+	 *  of a quad, given its corners in counter-clockwise order.
+	 ***********************************************************/
+	void AddQuad(
+		ShapeGeometry::SHAPE_GEOMETRY& geometry,
+		GLuint a, GLuint b, GLuint c, GLuint d)
+	{
+		geometry.indices.insert(geometry.indices.end(), { a, b, c, a, c, d });
+	}
+
+	/***********************************************************
+	 *  AddGrid()
+	 *
+	 *  This function is used for appending the triangles that
+	 *  connect a grid of (rows + 1) x (columns + 1) vertices,
+	 *  which were added row by row starting at firstVertex.
+	 ***********************************************************/
+	void AddGrid(
+		ShapeGeometry::SHAPE_GEOMETRY& geometry,
+		GLuint firstVertex,
+		int rows,
+		int columns)
+	{
+		GLuint rowLength = (GLuint)columns + 1;
+		for (int row = 0; row < rows; row++)
+		{
+			for (int column = 0; column < columns; column++)
+			{
+				GLuint a = firstVertex + row * rowLength + column;
+				GLuint b = a + rowLength;
+				AddQuad(geometry, a, a + 1, b + 1, b);
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  CreatePlane()
+ *
+ *  This method is used for building a flat 2 x 2 square in
+ *  the XZ plane, facing up.
+ ***********************************************************/
+ShapeGeometry::SHAPE_GEOMETRY ShapeGeometry::CreatePlane()
+{
+	SHAPE_GEOMETRY geometry;
+	glm::vec3 up(0.0f, 1.0f, 0.0f);
+
+	GLuint a = AddVertex(geometry, glm::vec3(-1.0f, 0.0f, 1.0f), up, glm::vec2(0.0f, 0.0f));
+	GLuint b = AddVertex(geometry, glm::vec3(1.0f, 0.0f, 1.0f), up, glm::vec2(1.0f, 0.0f));
+	GLuint c = AddVertex(geometry, glm::vec3(1.0f, 0.0f, -1.0f), up, glm::vec2(1.0f, 1.0f));
+	GLuint d = AddVertex(geometry, glm::vec3(-1.0f, 0.0f, -1.0f), up, glm::vec2(0.0f, 1.0f));
+	AddQuad(geometry, a, b, c, d);
+
+	return(geometry);
+}
+
+/***********************************************************
+ *  CreateBox()
+ *
+ *  This method is used for building a unit cube centered on
+ *  the origin.  Each face has its own four vertices so the
+ *  normals and texture coordinates are not shared.
+ ***********************************************************/
+ShapeGeometry::SHAPE_GEOMETRY ShapeGeometry::CreateBox()
+{
+	SHAPE_GEOMETRY geometry;
+
+	// normal, then the two axes spanning each face
+	const glm::vec3 faces[6][3] =
+	{
+		{ glm::vec3(0.0f, 0.0f, 1.0f),  glm::vec3(1.0f, 0.0f, 0.0f),  glm::vec3(0.0f, 1.0f, 0.0f) },
+		{ glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f) },
+		{ glm::vec3(1.0f, 0.0f, 0.0f),  glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f) },
+		{ glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f),  glm::vec3(0.0f, 1.0f, 0.0f) },
+		{ glm::vec3(0.0f, 1.0f, 0.0f),  glm::vec3(1.0f, 0.0f, 0.0f),  glm::vec3(0.0f, 0.0f, -1.0f) },
+		{ glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f),  glm::vec3(0.0f, 0.0f, 1.0f) }
+	};
+
+	for (int face = 0; face < 6; face++)
+	{
+		glm::vec3 normal = faces[face][0];
+		glm::vec3 right = faces[face][1] * 0.5f;
+		glm::vec3 up = faces[face][2] * 0.5f;
+		glm::vec3 center = normal * 0.5f;
+
+		GLuint a = AddVertex(geometry, center - right - up, normal, glm::vec2(0.0f, 0.0f));
+		GLuint b = AddVertex(geometry, center + right - up, normal, glm::vec2(1.0f, 0.0f));
+		GLuint c = AddVertex(geometry, center + right + up, normal, glm::vec2(1.0f, 1.0f));
+		GLuint d = AddVertex(geometry, center - right + up, normal, glm::vec2(0.0f, 1.0f));
+		AddQuad(geometry, a, b, c, d);
+	}
+
+	return(geometry);
+}
+
+/***********************************************************
+ *  CreateCylinder()
+ *
+ *  This method is used for building a closed cylinder of
+ *  radius 1 standing on the XZ plane, one unit tall.
+ ***********************************************************/
+ShapeGeometry::SHAPE_GEOMETRY ShapeGeometry::CreateCylinder(int detailLevel)
+{
+	SHAPE_GEOMETRY geometry;
+	AddCylinder(geometry, 1.0f, 1.0f, g_RoundSegments[ClampDetailLevel(detailLevel)]);
+
+	return(geometry);
+}
+
+/***********************************************************
+ *  CreateTaperedCylinder()
+ *
+ *  This method is used for building a closed cylinder that
+ *  narrows from radius 1 at the bottom to 0.5 at the top.
+ ***********************************************************/
+ShapeGeometry::SHAPE_GEOMETRY ShapeGeometry::CreateTaperedCylinder(int detailLevel)
+{
+	SHAPE_GEOMETRY geometry;
+	AddCylinder(geometry, 1.0f, 0.5f, g_RoundSegments[ClampDetailLevel(detailLevel)]);
+
+	return(geometry);
+}
+
+/***********************************************************
+ *  CreateSphere()
+ *
+ *  This method is used for building a sphere of radius 1
+ *  centered on the origin, from rings of latitude.
+ ***********************************************************/
+ShapeGeometry::SHAPE_GEOMETRY ShapeGeometry::CreateSphere(int detailLevel)
+{
+	SHAPE_GEOMETRY geometry;
+	GLuint firstVertex = 0;
+	int stacks = g_SphereStacks[ClampDetailLevel(detailLevel)];
+	int segments = g_RoundSegments[ClampDetailLevel(detailLevel)];
+
+	for (int stack = 0; stack <= stacks; stack++)
+	{
+		float v = float(stack) / float(stacks);
+		float latitude = glm::pi<float>() * (v - 0.5f);
+
+		for (int segment = 0; segment <= segments; segment++)
+		{
+			float u = float(segment) / float(segments);
+			float longitude = glm::two_pi<float>() * u;
+
+			glm::vec3 normal(
+				cos(latitude) * cos(longitude),
+				sin(latitude),
+				-cos(latitude) * sin(longitude));
+			AddVertex(geometry, normal, normal, glm::vec2(u, v));
+		}
+	}
+	AddGrid(geometry, firstVertex, stacks, segments);
+
+	return(geometry);
+}
+
+/***********************************************************
+ *  CreateTorus()
+ *
+ *  This method is used for building a torus whose ring lies
+ *  in the XY plane around the origin.
+ ***********************************************************/
+ShapeGeometry::SHAPE_GEOMETRY ShapeGeometry::CreateTorus(int detailLevel)
+{
+	SHAPE_GEOMETRY geometry;
+	GLuint firstVertex = 0;
+	int segments = g_RoundSegments[ClampDetailLevel(detailLevel)];
+	int tubeSegments = g_TorusTubeSegments[ClampDetailLevel(detailLevel)];
+
+	for (int segment = 0; segment <= segments; segment++)
+	{
+		float u = float(segment) / float(segments);
+		float ringAngle = glm::two_pi<float>() * u;
+		glm::vec3 ringDirection(cos(ringAngle), sin(ringAngle), 0.0f);
+
+		for (int tube = 0; tube <= tubeSegments; tube++)
+		{
+			float v = float(tube) / float(tubeSegments);
+			float tubeAngle = glm::two_pi<float>() * v;
+
+			glm::vec3 normal = ringDirection * cos(tubeAngle) - glm::vec3(0.0f, 0.0f, sin(tubeAngle));
+			glm::vec3 position = ringDirection * TORUS_RING_RADIUS + normal * TORUS_TUBE_RADIUS;
+			AddVertex(geometry, position, normal, glm::vec2(u, v));
+		}
+	}
+	AddGrid(geometry, firstVertex, segments, tubeSegments);
+
+	return(geometry);
+}
+
+/***********************************************************
+ *  CalculateBounds()
+ *
+ *  This method is used for finding the smallest axis-aligned
+ *  box that encloses all the vertices of the passed in shape.
+ ***********************************************************/
+void ShapeGeometry::CalculateBounds(
+	const SHAPE_GEOMETRY& geometry,
+	glm::vec3& center,
+	glm::vec3& extent)
+{
+	CalculateBounds(geometry.vertices.data(), geometry.vertices.size(), center, extent);
+}
+
+/***********************************************************
+ *  CalculateBounds()
+ *
+ *  This method is used for finding the smallest axis-aligned
+ *  box that encloses the passed in vertices.
+ ***********************************************************/
+void ShapeGeometry::CalculateBounds(
+	const SHAPE_VERTEX* vertices,
+	size_t vertexCount,
+	glm::vec3& center,
+	glm::vec3& extent)
+{
+	if (vertexCount == 0)
+	{
+		center = glm::vec3(0.0f, 0.0f, 0.0f);
+		extent = glm::vec3(0.0f, 0.0f, 0.0f);
+		return;
+	}
+
+	glm::vec3 minimum = vertices[0].position;
+	glm::vec3 maximum = vertices[0].position;
+	for (size_t i = 1; i < vertexCount; i++)
+	{
+		minimum = glm::min(minimum, vertices[i].position);
+		maximum = glm::max(maximum, vertices[i].position);
+	}
+
+	center = (minimum + maximum) * 0.5f;
+	extent = (maximum - minimum) * 0.5f;
+}
+
+/***********************************************************
+ *  GetGeneratorKey()
+ *
+ *  This method is used for listing the tessellation tables
+ *  and the sizes the shapes are built with.  Any change to
+ *  these values changes the key, so geometry saved by an
+ *  older build is not mistaken for the current shapes.
+ *  GENERATOR_VERSION must be raised when the code building
+ *  the shapes changes in a way the values do not show.
+ ***********************************************************/
+std::string ShapeGeometry::GetGeneratorKey()
+{
+	std::ostringstream key;
+	key << "shapes:" << GENERATOR_VERSION
+		<< " levels:" << DETAIL_LEVEL_COUNT
+		<< " vertex:" << sizeof(SHAPE_VERTEX);
+
+	key << " round:";
+	for (int level = 0; level < DETAIL_LEVEL_COUNT; level++)
+	{
+		key << g_RoundSegments[level] << ",";
+	}
+	key << " stacks:";
+	for (int level = 0; level < DETAIL_LEVEL_COUNT; level++)
+	{
+		key << g_SphereStacks[level] << ",";
+	}
+	key << " tube:";
+	for (int level = 0; level < DETAIL_LEVEL_COUNT; level++)
+	{
+		key << g_TorusTubeSegments[level] << ",";
+	}
+	key << " torus:" << TORUS_RING_RADIUS << "," << TORUS_TUBE_RADIUS;
+
+	return(key.str());
+}
+
+/***********************************************************
+ *  AddCylinder()
+ *
+ *  This method is used for adding the side and both caps of
+ *  a cylinder, one unit tall, with the passed in radius at
+ *  the bottom and at the top.
+ ***********************************************************/
+void ShapeGeometry::AddCylinder(
+	SHAPE_GEOMETRY& geometry,
+	float bottomRadius,
+	float topRadius,
+	int segments)
+{
+	GLuint firstVertex = (GLuint)geometry.vertices.size();
+
+	// the side normals lean outward when the top is narrower
+	float slope = bottomRadius - topRadius;
+
+	for (int row = 0; row <= 1; row++)
+	{
+		float radius = (row == 0) ? bottomRadius : topRadius;
+
+		for (int segment = 0; segment <= segments; segment++)
+		{
+			float u = float(segment) / float(segments);
+			float angle = glm::two_pi<float>() * u;
+			glm::vec3 direction(cos(angle), 0.0f, -sin(angle));
+
+			glm::vec3 normal = glm::normalize(direction + glm::vec3(0.0f, slope, 0.0f));
+			AddVertex(geometry, direction * radius + glm::vec3(0.0f, float(row), 0.0f), normal, glm::vec2(u, float(row)));
+		}
+	}
+	AddGrid(geometry, firstVertex, 1, segments);
+
+	AddDisk(geometry, bottomRadius, 0.0f, false, segments);
+	AddDisk(geometry, topRadius, 1.0f, true, segments);
+}
+
+/***********************************************************
+ *  AddDisk()
+ *
+ *  This method is used for adding a flat round cap at the
+ *  passed in height, as a fan around its center.
+ ***********************************************************/
+void ShapeGeometry::AddDisk(
+	SHAPE_GEOMETRY& geometry,
+	float radius,
+	float height,
+	bool bFacingUp,
+	int segments)
+{
+	glm::vec3 normal(0.0f, bFacingUp ? 1.0f : -1.0f, 0.0f);
+
+	GLuint center = AddVertex(geometry, glm::vec3(0.0f, height, 0.0f), normal, glm::vec2(0.5f, 0.5f));
+	for (int segment = 0; segment <= segments; segment++)
+	{
+		float angle = glm::two_pi<float>() * float(segment) / float(segments);
+		glm::vec2 direction(cos(angle), -sin(angle));
+
+		AddVertex(geometry,
+			glm::vec3(direction.x * radius, height, direction.y * radius),
+			normal,
+			glm::vec2(0.5f, 0.5f) + direction * 0.5f);
+	}
+
+	for (int segment = 0; segment < segments; segment++)
+	{
+		GLuint a = center + 1 + segment;
+		GLuint b = a + 1;
+		// keep the triangles counter-clockwise seen from outside
+		if (bFacingUp)
+		{
+			geometry.indices.insert(geometry.indices.end(), { center, a, b });
+		}
+		else
+		{
+			geometry.indices.insert(geometry.indices.end(), { center, b, a });
+		}
+	}
+}
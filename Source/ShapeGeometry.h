@@ -0,0 +1,97 @@
+///////////////////////////////////////////////////////////////////////////////
+// shapegeometry.h
+// ============
+// generate the vertex and index data of the basic shape meshes
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  ShapeGeometry
+ *
+ *  This class builds the basic shapes as indexed triangle
+ *  lists in main memory, with the same extents as the
+ *  meshes of ShapeMeshes:
+ *    plane             2 x 2 in XZ, centered, facing +Y
+ *    box               1 x 1 x 1, centered
+ *    cylinder          radius 1, from Y 0 to Y 1
+ *    tapered cylinder  radius 1 at Y 0, 0.5 at Y 1
+ *    sphere            radius 1, centered
+ *    torus             ring radius 1 in XY, tube radius 0.1
+ *  The renderer copies this data into its MeshArena, which
+ *  all the draw paths read from.
+ *
+ *  The round shapes can be built at several detail levels,
+ *  level 0 being the finest, with fewer segments at each
+ *  level.  The extents are the same at every level.
+ ***********************************************************/
+class ShapeGeometry
+{
+public:
+	// one vertex in the layout used by ShapeMeshes, so the
+	// same shader attribute locations apply
+	struct SHAPE_VERTEX
+	{
+		glm::vec3 position;
+		glm::vec3 normal;
+		glm::vec2 textureCoordinate;
+	};
+
+	struct SHAPE_GEOMETRY
+	{
+		std::vector<SHAPE_VERTEX> vertices;
+		std::vector<GLuint> indices;
+	};
+
+	// number of detail levels of the round shapes
+	static const int DETAIL_LEVEL_COUNT = 4;
+
+	// build the geometry of each of the basic shapes
+	static SHAPE_GEOMETRY CreatePlane();
+	static SHAPE_GEOMETRY CreateBox();
+	static SHAPE_GEOMETRY CreateCylinder(int detailLevel = 0);
+	static SHAPE_GEOMETRY CreateTaperedCylinder(int detailLevel = 0);
+	static SHAPE_GEOMETRY CreateSphere(int detailLevel = 0);
+	static SHAPE_GEOMETRY CreateTorus(int detailLevel = 0);
+
+	// get the box enclosing all the vertices, as a center
+	// and a half extent along each axis
+	static void CalculateBounds(
+		const SHAPE_GEOMETRY& geometry,
+		glm::vec3& center,
+		glm::vec3& extent);
+	static void CalculateBounds(
+		const SHAPE_VERTEX* vertices,
+		size_t vertexCount,
+		glm::vec3& center,
+		glm::vec3& extent);
+
+	// get a text listing every value the generated shapes
+	// depend on, so saved copies can be told apart
+	static std::string GetGeneratorKey();
+
+private:
+	// add the side and the caps of a cylinder with the passed
+	// in bottom and top radius
+	static void AddCylinder(
+		SHAPE_GEOMETRY& geometry,
+		float bottomRadius,
+		float topRadius,
+		int segments);
+	// add a flat disk facing up or down at the passed in height
+	static void AddDisk(
+		SHAPE_GEOMETRY& geometry,
+		float radius,
+		float height,
+		bool bFacingUp,
+		int segments);
+};
@@ -0,0 +1,129 @@
+///////////////////////////////////////////////////////////////////////////////
+// statecache.cpp
+// ============
+// skip OpenGL binding calls that would not change the current state
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "StateCache.h"
+
+// declaration of global variables
+namespace
+{
+	// stands for a binding that is not known, so the next
+	// bind is always passed to OpenGL
+	const GLuint UNKNOWN_BINDING = 0xffffffff;
+}
+
+/***********************************************************
+ *  StateCache()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+StateCache::StateCache()
+{
+	Invalidate();
+	ResetCounts();
+}
+
+/***********************************************************
+ *  UseProgram()
+ *
+ *  This method is used for making the passed in shader
+ *  program current.
+ ***********************************************************/
+void StateCache::UseProgram(GLuint programID)
+{
+	if (m_programID == programID)
+	{
+		m_elidedCount++;
+		return;
+	}
+
+	glUseProgram(programID);
+	m_programID = programID;
+	m_issuedCount++;
+}
+
+/***********************************************************
+ *  BindVertexArray()
+ *
+ *  This method is used for binding the passed in vertex
+ *  array.
+ ***********************************************************/
+void StateCache::BindVertexArray(GLuint vertexArrayID)
+{
+	if (m_vertexArrayID == vertexArrayID)
+	{
+		m_elidedCount++;
+		return;
+	}
+
+	glBindVertexArray(vertexArrayID);
+	m_vertexArrayID = vertexArrayID;
+	m_issuedCount++;
+}
+
+/***********************************************************
+ *  BindTexture()
+ *
+ *  This method is used for binding a texture to the passed
+ *  in texture unit.  The unit is selected directly, so the
+ *  active texture unit is left unchanged.
+ ***********************************************************/
+void StateCache::BindTexture(int textureUnit, GLuint textureID)
+{
+	if ((textureUnit >= 0) && (textureUnit < MAX_TEXTURE_UNITS))
+	{
+		if (m_textureIDs[textureUnit] == textureID)
+		{
+			m_elidedCount++;
+			return;
+		}
+		m_textureIDs[textureUnit] = textureID;
+	}
+
+	glBindTextureUnit((GLuint)textureUnit, textureID);
+	m_issuedCount++;
+}
+
+/***********************************************************
+ *  InvalidateVertexArray()
+ *
+ *  This method is used for forgetting the bound vertex
+ *  array after code outside the cache has bound another.
+ ***********************************************************/
+void StateCache::InvalidateVertexArray()
+{
+	m_vertexArrayID = UNKNOWN_BINDING;
+}
+
+/***********************************************************
+ *  Invalidate()
+ *
+ *  This method is used for forgetting all the bindings, so
+ *  the next bind of each object is passed to OpenGL.
+ ***********************************************************/
+void StateCache::Invalidate()
+{
+	m_programID = UNKNOWN_BINDING;
+	m_vertexArrayID = UNKNOWN_BINDING;
+	for (int i = 0; i < MAX_TEXTURE_UNITS; i++)
+	{
+		m_textureIDs[i] = UNKNOWN_BINDING;
+	}
+}
+
+/***********************************************************
+ *  ResetCounts()
+ *
+ *  This method is used for setting the issued and skipped
+ *  call counts back to zero at the start of a frame.
+ ***********************************************************/
+void StateCache::ResetCounts()
+{
+	m_issuedCount = 0;
+	m_elidedCount = 0;
+}
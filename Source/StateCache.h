@@ -0,0 +1,60 @@
+///////////////////////////////////////////////////////////////////////////////
+// statecache.h
+// ============
+// skip OpenGL binding calls that would not change the current state
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+/***********************************************************
+ *  StateCache
+ *
+ *  This class keeps a copy of the bound shader program,
+ *  vertex array and the texture bound to each texture unit.
+ *  A bind call is only passed to OpenGL when it changes the
+ *  copy, and the issued and skipped calls are counted for
+ *  the frame statistics.
+ *
+ *  Code that binds one of these objects without going
+ *  through the cache must call the matching Invalidate
+ *  method afterwards.
+ ***********************************************************/
+class StateCache
+{
+public:
+	// constructor
+	StateCache();
+
+	// texture units whose bindings are tracked
+	static const int MAX_TEXTURE_UNITS = 32;
+
+	// bind the passed in objects, unless already bound
+	void UseProgram(GLuint programID);
+	void BindVertexArray(GLuint vertexArrayID);
+	void BindTexture(int textureUnit, GLuint textureID);
+
+	// forget a binding that was changed outside the cache
+	void InvalidateVertexArray();
+	// forget all the bindings
+	void Invalidate();
+
+	// get the number of calls passed to OpenGL and skipped
+	long long GetIssuedCount() const { return(m_issuedCount); }
+	long long GetElidedCount() const { return(m_elidedCount); }
+	// set the call counts back to zero
+	void ResetCounts();
+
+private:
+	// the bound objects, or UNKNOWN_BINDING when not known
+	GLuint m_programID;
+	GLuint m_vertexArrayID;
+	GLuint m_textureIDs[MAX_TEXTURE_UNITS];
+	// calls passed to OpenGL and skipped since the last reset
+	long long m_issuedCount;
+	long long m_elidedCount;
+};
@@ -0,0 +1,83 @@
+///////////////////////////////////////////////////////////////////////////////
+// tagregistry.cpp
+// ============
+// map texture, material and object tags to small integer handles
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TagRegistry.h"
+
+#include <iostream>
+
+/***********************************************************
+ *  Add()
+ *
+ *  This method is used for registering the passed in tag
+ *  for a handle.  A tag that is already registered keeps
+ *  its first handle.  Two different tags with the same hash
+ *  are refused too, since a hashed lookup could not tell
+ *  them apart; both cases are reported here, at load time.
+ ***********************************************************/
+bool TagRegistry::Add(const std::string& tag, int handle)
+{
+	uint32_t hash = Hash(tag.c_str());
+
+	std::unordered_map<uint32_t, TAG_ENTRY>::const_iterator found = m_entries.find(hash);
+	if (found != m_entries.end())
+	{
+		if (found->second.tag == tag)
+		{
+			std::cout << "Duplicate tag:" << tag << std::endl;
+		}
+		else
+		{
+			std::cout << "Tag:" << tag << " has the same hash as tag:" << found->second.tag << std::endl;
+		}
+		return false;
+	}
+
+	TAG_ENTRY entry;
+	entry.tag = tag;
+	entry.handle = handle;
+	m_entries[hash] = entry;
+
+	return true;
+}
+
+/***********************************************************
+ *  Find()
+ *
+ *  This method is used for getting the handle registered
+ *  for the passed in tag.
+ ***********************************************************/
+int TagRegistry::Find(const std::string& tag) const
+{
+	std::unordered_map<uint32_t, TAG_ENTRY>::const_iterator found = m_entries.find(Hash(tag.c_str()));
+	if ((found == m_entries.end()) || (found->second.tag != tag))
+	{
+		return(-1);
+	}
+
+	return(found->second.handle);
+}
+
+/***********************************************************
+ *  Find()
+ *
+ *  This method is used for getting the handle registered
+ *  for a tag whose hash was computed ahead of time, usually
+ *  by TAG_ID.  The tag is still compared, so a literal that
+ *  was never registered cannot match another tag.
+ ***********************************************************/
+int TagRegistry::Find(uint32_t hash, const char* tag) const
+{
+	std::unordered_map<uint32_t, TAG_ENTRY>::const_iterator found = m_entries.find(hash);
+	if ((found == m_entries.end()) || (found->second.tag != tag))
+	{
+		return(-1);
+	}
+
+	return(found->second.handle);
+}
@@ -0,0 +1,69 @@
+///////////////////////////////////////////////////////////////////////////////
+// tagregistry.h
+// ============
+// map texture, material and object tags to small integer handles
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+
+/***********************************************************
+ *  TagRegistry
+ *
+ *  This class maps the tags of one kind of resource to the
+ *  integer handle of each resource, such as a texture or
+ *  material index.  Tags are registered while loading and
+ *  looked up by their FNV-1a hash in a hash table, so a
+ *  lookup does not depend on the number of tags.
+ *
+ *  A tag written in the code can be hashed at compile time
+ *  with TAG_ID, so finding it never hashes a string:
+ *    int index = registry.Find(TAG_ID("wood"));
+ ***********************************************************/
+class TagRegistry
+{
+public:
+	// get the 32 bit FNV-1a hash of a tag
+	static constexpr uint32_t Hash(const char* tag)
+	{
+		uint32_t hash = 2166136261u;
+		while (*tag != '\0')
+		{
+			hash = (hash ^ (uint8_t)*tag) * 16777619u;
+			tag++;
+		}
+		return(hash);
+	}
+
+	// register a tag for a handle, false if the tag is taken
+	bool Add(const std::string& tag, int handle);
+	// find the handle of a tag, -1 if not registered
+	int Find(const std::string& tag) const;
+	int Find(uint32_t hash, const char* tag) const;
+	// remove all the tags
+	void Clear() { m_entries.clear(); }
+
+	// get the number of registered tags
+	int GetCount() const { return((int)m_entries.size()); }
+
+private:
+	struct TAG_ENTRY
+	{
+		std::string tag;
+		int handle;
+	};
+
+	// registered tags by their hash
+	std::unordered_map<uint32_t, TAG_ENTRY> m_entries;
+};
+
+// the compile time hash of a tag literal followed by the literal,
+// for the lookups that take both
+#define TAG_ID(tag) std::integral_constant<uint32_t, TagRegistry::Hash(tag)>::value, tag
@@ -0,0 +1,239 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureloader.cpp
+// ============
+// decode texture images and build their mipmaps on worker threads
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureLoader.h"
+
+#include "stb_image.h"
+
+#include <algorithm>
+#include <cstring>
+
+// declaration of global variables
+namespace
+{
+	// most decoding threads to start, even on large machines
+	const unsigned int MAX_WORKER_THREADS = 4;
+
+	// every decoded image is expanded to RGBA
+	const int CHANNELS = 4;
+}
+
+/***********************************************************
+ *  TextureLoader()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureLoader::TextureLoader()
+{
+	m_bStopping = false;
+
+	// indicate to always flip images vertically when loaded -
+	// this is set once here, before any thread reads it
+	stbi_set_flip_vertically_on_load(true);
+
+	unsigned int threadCount = std::max(1u, std::min(std::thread::hardware_concurrency(), MAX_WORKER_THREADS));
+	for (unsigned int i = 0; i < threadCount; i++)
+	{
+		m_workers.push_back(std::thread(&TextureLoader::WorkerMain, this));
+	}
+}
+
+/***********************************************************
+ *  ~TextureLoader()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+TextureLoader::~TextureLoader()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bStopping = true;
+		m_jobs.clear();
+	}
+	m_jobQueued.notify_all();
+
+	for (size_t i = 0; i < m_workers.size(); i++)
+	{
+		m_workers[i].join();
+	}
+}
+
+/***********************************************************
+ *  Request()
+ *
+ *  This method is used for queueing the passed in image file
+ *  to be decoded on a worker thread.  The request ID is
+ *  returned with the decoded image.
+ ***********************************************************/
+void TextureLoader::Request(const std::string& filename, int requestID)
+{
+	DECODE_JOB job;
+	job.filename = filename;
+	job.requestID = requestID;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_jobs.push_back(job);
+	}
+	m_jobQueued.notify_one();
+}
+
+/***********************************************************
+ *  TakeDecoded()
+ *
+ *  This method is used for taking the next decoded image off
+ *  the queue without waiting.
+ ***********************************************************/
+bool TextureLoader::TakeDecoded(DECODED_IMAGE& image)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_images.empty())
+	{
+		return false;
+	}
+
+	image = std::move(m_images.front());
+	m_images.pop_front();
+
+	return true;
+}
+
+/***********************************************************
+ *  WaitForDecoded()
+ *
+ *  This method is used for blocking until at least one
+ *  decoded image is ready to be taken.
+ ***********************************************************/
+void TextureLoader::WaitForDecoded()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_imageDecoded.wait(lock, [this] { return(!m_images.empty()); });
+}
+
+/***********************************************************
+ *  GetLevelSize()
+ *
+ *  This method is used for getting the width or height of
+ *  the passed in mipmap level, which halves at each level
+ *  and never drops below one pixel.
+ ***********************************************************/
+int TextureLoader::GetLevelSize(int size, int level)
+{
+	return(std::max(1, size >> level));
+}
+
+/***********************************************************
+ *  WorkerMain()
+ *
+ *  This method runs on each worker thread.  It takes the
+ *  next queued file, decodes it and builds its mipmaps
+ *  without holding the lock, and queues the result.
+ ***********************************************************/
+void TextureLoader::WorkerMain()
+{
+	while (true)
+	{
+		DECODE_JOB job;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_jobQueued.wait(lock, [this] { return(m_bStopping || !m_jobs.empty()); });
+			if (m_bStopping)
+			{
+				return;
+			}
+			job = m_jobs.front();
+			m_jobs.pop_front();
+		}
+
+		DECODED_IMAGE image;
+		image.requestID = job.requestID;
+		image.filename = job.filename;
+		image.width = 0;
+		image.height = 0;
+		image.bValid = false;
+
+		// try to parse the image data from the specified image file
+		int colorChannels = 0;
+		unsigned char* pixels = stbi_load(
+			job.filename.c_str(),
+			&image.width,
+			&image.height,
+			&colorChannels,
+			CHANNELS);
+
+		if (pixels != NULL)
+		{
+			size_t levelSize = (size_t)image.width * image.height * CHANNELS;
+			image.pixels.assign(pixels, pixels + levelSize);
+			image.levelOffsets.push_back(0);
+			stbi_image_free(pixels);
+
+			BuildMipmaps(image);
+			image.bValid = true;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_images.push_back(std::move(image));
+		}
+		m_imageDecoded.notify_all();
+	}
+}
+
+/***********************************************************
+ *  BuildMipmaps()
+ *
+ *  This method is used for appending every smaller mipmap
+ *  level to the image, each one averaging 2 x 2 pixels of
+ *  the level above.  Odd sizes repeat the last row or
+ *  column instead of reading past the edge.
+ ***********************************************************/
+void TextureLoader::BuildMipmaps(DECODED_IMAGE& image)
+{
+	int level = 0;
+	while ((GetLevelSize(image.width, level) > 1) || (GetLevelSize(image.height, level) > 1))
+	{
+		int sourceWidth = GetLevelSize(image.width, level);
+		int sourceHeight = GetLevelSize(image.height, level);
+		int width = GetLevelSize(image.width, level + 1);
+		int height = GetLevelSize(image.height, level + 1);
+
+		size_t sourceOffset = image.levelOffsets[level];
+		size_t offset = image.pixels.size();
+		image.levelOffsets.push_back(offset);
+		image.pixels.resize(offset + (size_t)width * height * CHANNELS);
+
+		const unsigned char* source = image.pixels.data() + sourceOffset;
+		unsigned char* destination = image.pixels.data() + offset;
+
+		for (int y = 0; y < height; y++)
+		{
+			int y0 = std::min(y * 2, sourceHeight - 1);
+			int y1 = std::min(y * 2 + 1, sourceHeight - 1);
+
+			for (int x = 0; x < width; x++)
+			{
+				int x0 = std::min(x * 2, sourceWidth - 1);
+				int x1 = std::min(x * 2 + 1, sourceWidth - 1);
+
+				for (int c = 0; c < CHANNELS; c++)
+				{
+					int sum =
+						source[(y0 * sourceWidth + x0) * CHANNELS + c] +
+						source[(y0 * sourceWidth + x1) * CHANNELS + c] +
+						source[(y1 * sourceWidth + x0) * CHANNELS + c] +
+						source[(y1 * sourceWidth + x1) * CHANNELS + c];
+					destination[(y * width + x) * CHANNELS + c] = (unsigned char)((sum + 2) / 4);
+				}
+			}
+		}
+
+		level++;
+	}
+}
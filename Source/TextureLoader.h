@@ -0,0 +1,90 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureloader.h
+// ============
+// decode texture images and build their mipmaps on worker threads
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/***********************************************************
+ *  TextureLoader
+ *
+ *  This class decodes image files with stb_image on a small
+ *  pool of worker threads.  Every image is converted to
+ *  RGBA and its full mipmap chain is built on the worker,
+ *  so the GL thread only has to copy the finished levels
+ *  into a texture.  No OpenGL function is called here.
+ ***********************************************************/
+class TextureLoader
+{
+public:
+	// constructor
+	TextureLoader();
+	// destructor
+	~TextureLoader();
+
+	// a decoded RGBA image with all of its mipmap levels
+	struct DECODED_IMAGE
+	{
+		// ID passed in with the request
+		int requestID;
+		std::string filename;
+		// size of the full resolution level
+		int width;
+		int height;
+		// true when the file could be read and decoded
+		bool bValid;
+		// all the levels, from full resolution down to 1 x 1
+		std::vector<unsigned char> pixels;
+		// offset of each level in the pixel data
+		std::vector<size_t> levelOffsets;
+	};
+
+	// queue an image file to be decoded
+	void Request(const std::string& filename, int requestID);
+	// take the next decoded image, false if none is ready
+	bool TakeDecoded(DECODED_IMAGE& image);
+	// block until a decoded image is ready
+	void WaitForDecoded();
+
+	// get the size of a mipmap level of the passed in image
+	static int GetLevelSize(int size, int level);
+
+private:
+	struct DECODE_JOB
+	{
+		std::string filename;
+		int requestID;
+	};
+
+	// decode the queued jobs until the loader is destroyed
+	void WorkerMain();
+	// build the smaller mipmap levels behind the first level
+	static void BuildMipmaps(DECODED_IMAGE& image);
+
+	// decoding threads
+	std::vector<std::thread> m_workers;
+	// guards the job and image queues and the stop flag
+	std::mutex m_mutex;
+	// signalled when a job is queued or the loader stops
+	std::condition_variable m_jobQueued;
+	// signalled when an image has been decoded
+	std::condition_variable m_imageDecoded;
+	// files waiting to be decoded
+	std::deque<DECODE_JOB> m_jobs;
+	// decoded images waiting to be taken
+	std::deque<DECODED_IMAGE> m_images;
+	// set when the workers must exit
+	bool m_bStopping;
+};
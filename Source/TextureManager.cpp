@@ -0,0 +1,507 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturemanager.cpp
+// ============
+// pack the scene textures into texture arrays selected by index
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureManager.h"
+#include "BakedTexture.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// layers an array makes room for when it is created
+	const int INITIAL_LAYER_CAPACITY = 4;
+
+	// mid gray, so unloaded objects are visible but neutral
+	const unsigned char g_PlaceholderPixel[4] = { 128, 128, 128, 255 };
+
+	/***********************************************************
+	 *  CountLevels()
+	 *
+	 *  This function is used for getting the number of mipmap
+	 *  levels from the passed in size down to 1 x 1.
+	 ***********************************************************/
+	int CountLevels(int width, int height)
+	{
+		int levels = 1;
+		while ((TextureLoader::GetLevelSize(width, levels - 1) > 1) ||
+			(TextureLoader::GetLevelSize(height, levels - 1) > 1))
+		{
+			levels++;
+		}
+		return(levels);
+	}
+}
+
+/***********************************************************
+ *  TextureManager()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureManager::TextureManager(StateCache* pStateCache)
+{
+	m_pStateCache = pStateCache;
+	m_loader = new TextureLoader();
+	m_pendingCount = 0;
+	m_maxLayers = 256;
+	m_pixelBuffer = 0;
+}
+
+/***********************************************************
+ *  ~TextureManager()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+TextureManager::~TextureManager()
+{
+	// stop the workers before the arrays they fill are freed
+	delete m_loader;
+	m_loader = NULL;
+	Destroy();
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for creating array 0 with the gray
+ *  placeholder in its first layer, which every texture
+ *  shows until its own image is uploaded.
+ ***********************************************************/
+void TextureManager::Initialize()
+{
+	if (!m_arrays.empty())
+	{
+		return;
+	}
+
+	glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &m_maxLayers);
+
+	TEXTURE_ARRAY placeholder;
+	placeholder.width = 1;
+	placeholder.height = 1;
+	placeholder.levelCount = 1;
+	placeholder.layerCount = 1;
+	placeholder.layerCapacity = INITIAL_LAYER_CAPACITY;
+	placeholder.internalFormat = GL_RGBA8;
+	placeholder.textureID = CreateArrayTexture(1, 1, 1, INITIAL_LAYER_CAPACITY, GL_RGBA8);
+
+	glTextureSubImage3D(placeholder.textureID, 0, 0, 0, 0, 1, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, g_PlaceholderPixel);
+
+	m_arrays.push_back(placeholder);
+
+	BindArrays();
+}
+
+/***********************************************************
+ *  CreateTexture()
+ *
+ *  This method is used for adding a texture for the passed
+ *  in image file.  A baked file is uploaded immediately.
+ *  Otherwise the texture can still be used right away; it
+ *  shows the placeholder until its image has been decoded
+ *  and uploaded by UploadCompleted().  No texture is added
+ *  for a tag that is already taken.
+ ***********************************************************/
+int TextureManager::CreateTexture(const std::string& filename, const std::string& tag)
+{
+	Initialize();
+
+	// a repeated tag would never be found, so its image is
+	// not loaded at all
+	int textureIndex = (int)m_textures.size();
+	if (!m_tags.Add(tag, textureIndex))
+	{
+		return(-1);
+	}
+
+	TEXTURE_ENTRY entry;
+	entry.arrayIndex = 0;
+	entry.layer = 0;
+	m_textures.push_back(entry);
+
+	if (UploadBakedTexture(filename, textureIndex))
+	{
+		return(textureIndex);
+	}
+
+	m_loader->Request(filename, textureIndex);
+	m_pendingCount++;
+
+	return(textureIndex);
+}
+
+/***********************************************************
+ *  UploadCompleted()
+ *
+ *  This method is used for uploading the images that the
+ *  workers have finished decoding.  It is called from the
+ *  GL thread once per frame, and limiting the uploads per
+ *  call keeps a burst of textures from stalling one frame.
+ ***********************************************************/
+int TextureManager::UploadCompleted(int maxUploads)
+{
+	int uploaded = 0;
+	TextureLoader::DECODED_IMAGE image;
+
+	while (((maxUploads < 0) || (uploaded < maxUploads)) && m_loader->TakeDecoded(image))
+	{
+		UploadImage(image);
+		m_pendingCount--;
+		uploaded++;
+	}
+
+	return(uploaded);
+}
+
+/***********************************************************
+ *  WaitForAll()
+ *
+ *  This method is used for blocking the GL thread until all
+ *  the requested textures are decoded and uploaded, for runs
+ *  that need the final textures from the first frame.
+ ***********************************************************/
+void TextureManager::WaitForAll()
+{
+	while (m_pendingCount > 0)
+	{
+		m_loader->WaitForDecoded();
+		UploadCompleted(-1);
+	}
+}
+
+/***********************************************************
+ *  BindArrays()
+ *
+ *  This method is used for binding each texture array to
+ *  the texture unit with the same index as the array.  The
+ *  state cache skips the units that are already bound.
+ ***********************************************************/
+void TextureManager::BindArrays()
+{
+	for (size_t i = 0; i < m_arrays.size(); i++)
+	{
+		m_pStateCache->BindTexture((int)i, m_arrays[i].textureID);
+	}
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for freeing all the texture arrays
+ *  and the upload buffer.
+ ***********************************************************/
+void TextureManager::Destroy()
+{
+	for (size_t i = 0; i < m_arrays.size(); i++)
+	{
+		glDeleteTextures(1, &m_arrays[i].textureID);
+	}
+	// deleting a texture unbinds it from its unit
+	if (!m_arrays.empty())
+	{
+		m_pStateCache->Invalidate();
+	}
+	m_arrays.clear();
+	m_textures.clear();
+	m_tags.Clear();
+
+	if (m_pixelBuffer != 0)
+	{
+		glDeleteBuffers(1, &m_pixelBuffer);
+		m_pixelBuffer = 0;
+	}
+}
+
+/***********************************************************
+ *  CreateArrayTexture()
+ *
+ *  This method is used for allocating an array texture with
+ *  the passed in size, mipmap levels, layers and format, and
+ *  the same sampling parameters as the 2D textures used
+ *  before.  The texture is set up through its name, so no
+ *  texture unit binding is changed.
+ ***********************************************************/
+GLuint TextureManager::CreateArrayTexture(int width, int height, int levelCount, int layerCapacity, GLenum internalFormat)
+{
+	GLuint textureID = 0;
+
+	glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &textureID);
+	glTextureStorage3D(textureID, levelCount, internalFormat, width, height, layerCapacity);
+
+	// set the texture wrapping parameters
+	glTextureParameteri(textureID, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTextureParameteri(textureID, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	// set texture filtering parameters
+	glTextureParameteri(textureID, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTextureParameteri(textureID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	return(textureID);
+}
+
+/***********************************************************
+ *  FindOrCreateArray()
+ *
+ *  This method is used for getting the index of the array
+ *  holding textures of the passed in size and format.  A new
+ *  array is created for a combination not seen yet.
+ ***********************************************************/
+int TextureManager::FindOrCreateArray(int width, int height, GLenum internalFormat)
+{
+	for (int index = 0; index < (int)m_arrays.size(); index++)
+	{
+		if ((m_arrays[index].width == width) &&
+			(m_arrays[index].height == height) &&
+			(m_arrays[index].internalFormat == internalFormat))
+		{
+			return(index);
+		}
+	}
+
+	if ((int)m_arrays.size() >= MAX_TEXTURE_ARRAYS)
+	{
+		std::cout << "Too many texture sizes, maximum:" << MAX_TEXTURE_ARRAYS << std::endl;
+		return(-1);
+	}
+
+	TEXTURE_ARRAY textureArray;
+	textureArray.width = width;
+	textureArray.height = height;
+	textureArray.levelCount = CountLevels(width, height);
+	textureArray.layerCount = 0;
+	textureArray.layerCapacity = INITIAL_LAYER_CAPACITY;
+	textureArray.internalFormat = internalFormat;
+	textureArray.textureID = CreateArrayTexture(
+		width,
+		height,
+		textureArray.levelCount,
+		INITIAL_LAYER_CAPACITY,
+		internalFormat);
+	m_arrays.push_back(textureArray);
+
+	// bind the new array to the unit of its index
+	BindArrays();
+
+	return((int)m_arrays.size() - 1);
+}
+
+/***********************************************************
+ *  GrowArray()
+ *
+ *  This method is used for doubling the layers of a full
+ *  array.  The storage of an array texture cannot be resized,
+ *  so a larger texture is allocated, every level of the old
+ *  layers is copied into it on the GPU, and it replaces the
+ *  old texture on the same texture unit.
+ ***********************************************************/
+bool TextureManager::GrowArray(int arrayIndex)
+{
+	TEXTURE_ARRAY& textureArray = m_arrays[arrayIndex];
+	if (textureArray.layerCapacity >= m_maxLayers)
+	{
+		std::cout << "Texture array is full, maximum layers:" << m_maxLayers << std::endl;
+		return false;
+	}
+
+	int layerCapacity = std::min(textureArray.layerCapacity * 2, m_maxLayers);
+	GLuint textureID = CreateArrayTexture(
+		textureArray.width,
+		textureArray.height,
+		textureArray.levelCount,
+		layerCapacity,
+		textureArray.internalFormat);
+
+	for (int level = 0; level < textureArray.levelCount; level++)
+	{
+		glCopyImageSubData(
+			textureArray.textureID, GL_TEXTURE_2D_ARRAY, level, 0, 0, 0,
+			textureID, GL_TEXTURE_2D_ARRAY, level, 0, 0, 0,
+			TextureLoader::GetLevelSize(textureArray.width, level),
+			TextureLoader::GetLevelSize(textureArray.height, level),
+			textureArray.layerCount);
+	}
+
+	glDeleteTextures(1, &textureArray.textureID);
+	textureArray.textureID = textureID;
+	textureArray.layerCapacity = layerCapacity;
+
+	BindArrays();
+
+	return true;
+}
+
+/***********************************************************
+ *  UploadImage()
+ *
+ *  This method is used for copying all the mipmap levels of
+ *  a decoded image into a new layer of the array for its
+ *  size.  The levels are written into a pixel buffer object,
+ *  whose old storage is orphaned first, and the layer is
+ *  filled from that buffer, so the driver can finish the
+ *  transfer without blocking this thread.
+ ***********************************************************/
+void TextureManager::UploadImage(const TextureLoader::DECODED_IMAGE& image)
+{
+	if (!image.bValid)
+	{
+		std::cout << "Could not load image:" << image.filename << std::endl;
+		return;
+	}
+
+	int arrayIndex = 0;
+	int layer = 0;
+	if (!AddLayer(image.width, image.height, GL_RGBA8, arrayIndex, layer))
+	{
+		return;
+	}
+	const TEXTURE_ARRAY& textureArray = m_arrays[arrayIndex];
+
+	GLsizeiptr imageSize = (GLsizeiptr)image.pixels.size();
+	if (m_pixelBuffer == 0)
+	{
+		glGenBuffers(1, &m_pixelBuffer);
+	}
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pixelBuffer);
+	glBufferData(GL_PIXEL_UNPACK_BUFFER, imageSize, NULL, GL_STREAM_DRAW);
+	void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, imageSize,
+		GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+
+	bool bUsePixelBuffer = (mapped != NULL);
+	if (bUsePixelBuffer)
+	{
+		memcpy(mapped, image.pixels.data(), image.pixels.size());
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+	}
+	else
+	{
+		// upload straight from the decoded image instead
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	}
+
+	for (int level = 0; level < textureArray.levelCount; level++)
+	{
+		size_t offset = image.levelOffsets[level];
+		const void* source = bUsePixelBuffer ? (const void*)offset : (const void*)(image.pixels.data() + offset);
+
+		glTextureSubImage3D(textureArray.textureID, level, 0, 0, layer,
+			TextureLoader::GetLevelSize(image.width, level),
+			TextureLoader::GetLevelSize(image.height, level),
+			1, GL_RGBA, GL_UNSIGNED_BYTE, source);
+	}
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	m_textures[image.requestID].arrayIndex = arrayIndex;
+	m_textures[image.requestID].layer = layer;
+
+	std::cout << "Successfully loaded image:" << image.filename << ", width:" << image.width << ", height:" << image.height << ", layer:" << layer << " of array:" << arrayIndex << std::endl;
+}
+
+/***********************************************************
+ *  AddLayer()
+ *
+ *  This method is used for reserving the next layer of the
+ *  array for the passed in size and format, growing the
+ *  array first when it is full.
+ ***********************************************************/
+bool TextureManager::AddLayer(int width, int height, GLenum internalFormat, int& arrayIndex, int& layer)
+{
+	arrayIndex = FindOrCreateArray(width, height, internalFormat);
+	if (arrayIndex < 0)
+	{
+		return false;
+	}
+	if ((m_arrays[arrayIndex].layerCount >= m_arrays[arrayIndex].layerCapacity) &&
+		(GrowArray(arrayIndex) == false))
+	{
+		return false;
+	}
+
+	layer = m_arrays[arrayIndex].layerCount;
+	m_arrays[arrayIndex].layerCount++;
+
+	return true;
+}
+
+/***********************************************************
+ *  UploadBakedTexture()
+ *
+ *  This method is used for uploading the baked file of an
+ *  image into a new layer.  The levels are passed to OpenGL
+ *  straight from the memory mapped file, so nothing is
+ *  decoded or filtered at startup.  Compressed levels stay
+ *  compressed on the GPU.  False is returned when there is
+ *  no baked file, or its format is not supported here, so
+ *  the image is decoded instead.
+ ***********************************************************/
+bool TextureManager::UploadBakedTexture(const std::string& filename, int textureIndex)
+{
+	BakedTexture baked;
+	if (!baked.Open(BakedTexture::GetBakedFilename(filename)))
+	{
+		return false;
+	}
+
+	GLenum internalFormat = GL_RGBA8;
+	switch (baked.GetFormat())
+	{
+	case BakedTexture::FORMAT_BC1:
+		internalFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+		break;
+	case BakedTexture::FORMAT_BC3:
+		internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+		break;
+	default:
+		break;
+	}
+
+	if ((internalFormat != GL_RGBA8) && !GLEW_EXT_texture_compression_s3tc)
+	{
+		std::cout << "Compressed textures not supported, decoding image:" << filename << std::endl;
+		return false;
+	}
+	// the arrays always hold the full mipmap chain
+	if (baked.GetLevelCount() != CountLevels(baked.GetWidth(), baked.GetHeight()))
+	{
+		return false;
+	}
+
+	int arrayIndex = 0;
+	int layer = 0;
+	if (!AddLayer(baked.GetWidth(), baked.GetHeight(), internalFormat, arrayIndex, layer))
+	{
+		return false;
+	}
+
+	GLuint textureID = m_arrays[arrayIndex].textureID;
+	for (int level = 0; level < baked.GetLevelCount(); level++)
+	{
+		int width = TextureLoader::GetLevelSize(baked.GetWidth(), level);
+		int height = TextureLoader::GetLevelSize(baked.GetHeight(), level);
+
+		if (internalFormat == GL_RGBA8)
+		{
+			glTextureSubImage3D(textureID, level, 0, 0, layer, width, height, 1,
+				GL_RGBA, GL_UNSIGNED_BYTE, baked.GetLevelData(level));
+		}
+		else
+		{
+			glCompressedTextureSubImage3D(textureID, level, 0, 0, layer, width, height, 1,
+				internalFormat, (GLsizei)baked.GetLevelSize(level), baked.GetLevelData(level));
+		}
+	}
+
+	m_textures[textureIndex].arrayIndex = arrayIndex;
+	m_textures[textureIndex].layer = layer;
+
+	std::cout << "Successfully loaded baked image:" << filename << ", width:" << baked.GetWidth() << ", height:" << baked.GetHeight() << ", layer:" << layer << " of array:" << arrayIndex << std::endl;
+
+	return true;
+}
@@ -0,0 +1,131 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturemanager.h
+// ============
+// pack the scene textures into texture arrays selected by index
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "TextureLoader.h"
+#include "TagRegistry.h"
+#include "StateCache.h"
+
+#include <GL/glew.h>
+
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  TextureManager
+ *
+ *  This class stores every scene texture as one layer of a
+ *  GL_TEXTURE_2D_ARRAY.  Textures of the same size share an
+ *  array, which grows as layers are added, and each array
+ *  stays bound to the texture unit of its own index.  A draw
+ *  selects its texture with the array unit and the layer,
+ *  so textures never need to be rebound while rendering and
+ *  the number of textures is only limited by memory.
+ *
+ *  When the texture baker has written a baked file next to
+ *  the image, that file is memory mapped and its stored
+ *  levels are uploaded right away, compressed if they were
+ *  baked that way.  Other images are decoded in the
+ *  background by the texture loader.  Until its image
+ *  arrives, a texture points at the gray placeholder layer
+ *  in array 0.
+ ***********************************************************/
+class TextureManager
+{
+public:
+	// constructor
+	TextureManager(StateCache* pStateCache);
+	// destructor
+	~TextureManager();
+
+	// most texture arrays, one for each distinct texture size
+	static const int MAX_TEXTURE_ARRAYS = 16;
+
+	// create the placeholder array and bind it
+	void Initialize();
+	// load the baked file of an image, or queue the image to
+	// be decoded, and return its texture index, -1 if the tag
+	// is already taken
+	int CreateTexture(const std::string& filename, const std::string& tag);
+	// find a texture by tag, -1 if not found
+	int FindTexture(const std::string& tag) const { return(m_tags.Find(tag)); }
+	int FindTexture(uint32_t hash, const char* tag) const { return(m_tags.Find(hash, tag)); }
+
+	// move up to maxUploads decoded images into their arrays,
+	// or all when negative, and return the number moved
+	int UploadCompleted(int maxUploads);
+	// block until every requested texture has been uploaded
+	void WaitForAll();
+
+	// bind each texture array to the texture unit of its index
+	void BindArrays();
+	// free all the texture arrays
+	void Destroy();
+
+	// get the array unit and the layer holding a texture
+	int GetArrayIndex(int textureIndex) const { return(m_textures[textureIndex].arrayIndex); }
+	int GetLayer(int textureIndex) const { return(m_textures[textureIndex].layer); }
+	// get the number of textures and texture arrays
+	int GetTextureCount() const { return((int)m_textures.size()); }
+	int GetArrayCount() const { return((int)m_arrays.size()); }
+	// get the number of requested textures not uploaded yet
+	int GetPendingCount() const { return(m_pendingCount); }
+
+private:
+	struct TEXTURE_ENTRY
+	{
+		int arrayIndex;
+		int layer;
+	};
+
+	struct TEXTURE_ARRAY
+	{
+		GLuint textureID;
+		int width;
+		int height;
+		int levelCount;
+		int layerCount;
+		int layerCapacity;
+		// RGBA8 or one of the compressed formats
+		GLenum internalFormat;
+	};
+
+	// find the array for the passed in size and format,
+	// creating it if needed
+	int FindOrCreateArray(int width, int height, GLenum internalFormat);
+	// make room for one more layer in an array
+	bool GrowArray(int arrayIndex);
+	// reserve a new layer for an image, false if there is no room
+	bool AddLayer(int width, int height, GLenum internalFormat, int& arrayIndex, int& layer);
+	// allocate the storage of an array texture
+	static GLuint CreateArrayTexture(int width, int height, int levelCount, int layerCapacity, GLenum internalFormat);
+	// copy a decoded image into a new layer of its array
+	void UploadImage(const TextureLoader::DECODED_IMAGE& image);
+	// upload the levels of the baked file of an image, false
+	// if there is no usable baked file
+	bool UploadBakedTexture(const std::string& filename, int textureIndex);
+
+	// pointer to the cache of the texture unit bindings
+	StateCache* m_pStateCache;
+	// decoder running on the worker threads
+	TextureLoader* m_loader;
+	// all the created textures, by texture index
+	std::vector<TEXTURE_ENTRY> m_textures;
+	// texture index of each tag
+	TagRegistry m_tags;
+	// the texture arrays, by array index and texture unit
+	std::vector<TEXTURE_ARRAY> m_arrays;
+	// number of requests not uploaded yet
+	int m_pendingCount;
+	// most layers the driver allows in one array
+	int m_maxLayers;
+	// pixel buffer object used as the source of the uploads
+	GLuint m_pixelBuffer;
+};
@@ -0,0 +1,255 @@
+///////////////////////////////////////////////////////////////////////////////
+// uniformcache.cpp
+// ============
+// resolve the shader uniform locations once and set them by ID
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "UniformCache.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <cstring>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// uniform names, in the same order as UNIFORM_ID
+	const char* g_UniformNames[UniformCache::UNIFORM_COUNT] =
+	{
+		"model",
+		"view",
+		"projection",
+		"viewPosition",
+		"objectColor",
+		"objectTextures",
+		"bUseTexture",
+		"bUseLighting",
+		"UVscale",
+		"material.ambientColor",
+		"material.ambientStrength",
+		"material.diffuseColor",
+		"material.specularColor",
+		"material.shininess",
+		"materialIndex",
+		"bUseInstancing",
+		"textureLayer",
+		"bCompactVertices",
+		"positionScale",
+		"positionOffset",
+		"bClusteredLights",
+		"bShadows",
+		"shadowMap",
+		"shadowCubeMap",
+		"shadowMatrix",
+		"shadowCubeFar",
+		"bOverdraw"
+	};
+}
+
+/***********************************************************
+ *  UniformCache()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+UniformCache::UniformCache()
+{
+	m_programID = 0;
+
+	for (int i = 0; i < UNIFORM_COUNT; i++)
+	{
+		m_locations[i] = -1;
+	}
+
+	Invalidate();
+	ResetCounts();
+}
+
+/***********************************************************
+ *  ResolveLocations()
+ *
+ *  This method is used for looking up the locations of all
+ *  the uniforms in the passed in shader program.  It must be
+ *  called again whenever the program is relinked.  Uniforms
+ *  that the shader does not declare, or that the compiler
+ *  removed, keep the location -1, which OpenGL ignores.
+ ***********************************************************/
+void UniformCache::ResolveLocations(GLuint programID)
+{
+	m_programID = programID;
+
+	for (int i = 0; i < UNIFORM_COUNT; i++)
+	{
+		m_locations[i] = glGetUniformLocation(programID, g_UniformNames[i]);
+		if (m_locations[i] < 0)
+		{
+			std::cout << "INFO: Uniform not active in shader:" << g_UniformNames[i] << std::endl;
+		}
+	}
+
+	// a relinked program starts with its default values
+	Invalidate();
+}
+
+/***********************************************************
+ *  SetBool()
+ *
+ *  This method is used for setting a bool uniform value.
+ ***********************************************************/
+void UniformCache::SetBool(UNIFORM_ID uniformID, bool value)
+{
+	int intValue = (int)value;
+	if (UpdateShadow(m_locations[uniformID], m_values[uniformID], m_bValueKnown[uniformID], &intValue, sizeof(intValue)))
+	{
+		glProgramUniform1i(m_programID, m_locations[uniformID], intValue);
+	}
+}
+
+/***********************************************************
+ *  SetInt()
+ *
+ *  This method is used for setting an int uniform value.
+ ***********************************************************/
+void UniformCache::SetInt(UNIFORM_ID uniformID, int value)
+{
+	if (UpdateShadow(m_locations[uniformID], m_values[uniformID], m_bValueKnown[uniformID], &value, sizeof(value)))
+	{
+		glProgramUniform1i(m_programID, m_locations[uniformID], value);
+	}
+}
+
+/***********************************************************
+ *  SetFloat()
+ *
+ *  This method is used for setting a float uniform value.
+ ***********************************************************/
+void UniformCache::SetFloat(UNIFORM_ID uniformID, float value)
+{
+	if (UpdateShadow(m_locations[uniformID], m_values[uniformID], m_bValueKnown[uniformID], &value, sizeof(value)))
+	{
+		glProgramUniform1f(m_programID, m_locations[uniformID], value);
+	}
+}
+
+/***********************************************************
+ *  SetVec2()
+ *
+ *  This method is used for setting a vec2 uniform value.
+ ***********************************************************/
+void UniformCache::SetVec2(UNIFORM_ID uniformID, const glm::vec2& value)
+{
+	if (UpdateShadow(m_locations[uniformID], m_values[uniformID], m_bValueKnown[uniformID], glm::value_ptr(value), sizeof(value)))
+	{
+		glProgramUniform2fv(m_programID, m_locations[uniformID], 1, glm::value_ptr(value));
+	}
+}
+
+/***********************************************************
+ *  SetVec3()
+ *
+ *  This method is used for setting a vec3 uniform value.
+ ***********************************************************/
+void UniformCache::SetVec3(UNIFORM_ID uniformID, const glm::vec3& value)
+{
+	if (UpdateShadow(m_locations[uniformID], m_values[uniformID], m_bValueKnown[uniformID], glm::value_ptr(value), sizeof(value)))
+	{
+		glProgramUniform3fv(m_programID, m_locations[uniformID], 1, glm::value_ptr(value));
+	}
+}
+
+/***********************************************************
+ *  SetVec4()
+ *
+ *  This method is used for setting a vec4 uniform value.
+ ***********************************************************/
+void UniformCache::SetVec4(UNIFORM_ID uniformID, const glm::vec4& value)
+{
+	if (UpdateShadow(m_locations[uniformID], m_values[uniformID], m_bValueKnown[uniformID], glm::value_ptr(value), sizeof(value)))
+	{
+		glProgramUniform4fv(m_programID, m_locations[uniformID], 1, glm::value_ptr(value));
+	}
+}
+
+/***********************************************************
+ *  SetMat4()
+ *
+ *  This method is used for setting a mat4 uniform value.
+ ***********************************************************/
+void UniformCache::SetMat4(UNIFORM_ID uniformID, const glm::mat4& value)
+{
+	if (UpdateShadow(m_locations[uniformID], m_values[uniformID], m_bValueKnown[uniformID], glm::value_ptr(value), sizeof(value)))
+	{
+		glProgramUniformMatrix4fv(m_programID, m_locations[uniformID], 1, GL_FALSE, glm::value_ptr(value));
+	}
+}
+
+/***********************************************************
+ *  SetSampler()
+ *
+ *  This method is used for setting the texture unit read by
+ *  a sampler uniform.
+ ***********************************************************/
+void UniformCache::SetSampler(UNIFORM_ID uniformID, int textureUnit)
+{
+	if (UpdateShadow(m_locations[uniformID], m_values[uniformID], m_bValueKnown[uniformID], &textureUnit, sizeof(textureUnit)))
+	{
+		glProgramUniform1i(m_programID, m_locations[uniformID], textureUnit);
+	}
+}
+
+/***********************************************************
+ *  Invalidate()
+ *
+ *  This method is used for forgetting all the values sent,
+ *  so the next value of every uniform is sent to OpenGL.
+ ***********************************************************/
+void UniformCache::Invalidate()
+{
+	for (int i = 0; i < UNIFORM_COUNT; i++)
+	{
+		m_bValueKnown[i] = false;
+	}
+}
+
+/***********************************************************
+ *  ResetCounts()
+ *
+ *  This method is used for setting the sent and skipped
+ *  update counts back to zero at the start of a frame.
+ ***********************************************************/
+void UniformCache::ResetCounts()
+{
+	m_issuedCount = 0;
+	m_elidedCount = 0;
+}
+
+/***********************************************************
+ *  UpdateShadow()
+ *
+ *  This method is used for comparing a new uniform value
+ *  with the last one sent.  The value only needs to be sent
+ *  when it differs, and never to a uniform the shader does
+ *  not have, since OpenGL ignores location -1.
+ ***********************************************************/
+bool UniformCache::UpdateShadow(
+	GLint location,
+	unsigned char* shadow,
+	bool& bKnown,
+	const void* value,
+	size_t size)
+{
+	if ((location < 0) || (bKnown && (memcmp(shadow, value, size) == 0)))
+	{
+		m_elidedCount++;
+		return false;
+	}
+
+	memcpy(shadow, value, size);
+	bKnown = true;
+	m_issuedCount++;
+
+	return true;
+}
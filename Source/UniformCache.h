@@ -0,0 +1,117 @@
+///////////////////////////////////////////////////////////////////////////////
+// uniformcache.h
+// ============
+// resolve the shader uniform locations once and set them by ID
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+/***********************************************************
+ *  UniformCache
+ *
+ *  This class looks up the location of every uniform used
+ *  by the scene one time, right after the shader program
+ *  is linked, and stores them in tables indexed by fixed
+ *  IDs.  The typed setters then upload values straight to
+ *  the stored locations, so no uniform name is hashed or
+ *  compared while rendering.
+ *
+ *  The last value sent to each uniform is kept as well, and
+ *  a value equal to it is not sent again.  The sent and
+ *  skipped updates are counted for the frame statistics.
+ ***********************************************************/
+class UniformCache
+{
+public:
+	// IDs of the uniforms that are set by the scene
+	enum UNIFORM_ID
+	{
+		UNIFORM_MODEL = 0,
+		UNIFORM_VIEW,
+		UNIFORM_PROJECTION,
+		UNIFORM_VIEW_POSITION,
+		UNIFORM_OBJECT_COLOR,
+		UNIFORM_OBJECT_TEXTURE,
+		UNIFORM_USE_TEXTURE,
+		UNIFORM_USE_LIGHTING,
+		UNIFORM_UV_SCALE,
+		UNIFORM_MATERIAL_AMBIENT_COLOR,
+		UNIFORM_MATERIAL_AMBIENT_STRENGTH,
+		UNIFORM_MATERIAL_DIFFUSE_COLOR,
+		UNIFORM_MATERIAL_SPECULAR_COLOR,
+		UNIFORM_MATERIAL_SHININESS,
+		UNIFORM_MATERIAL_INDEX,
+		UNIFORM_USE_INSTANCING,
+		UNIFORM_TEXTURE_LAYER,
+		UNIFORM_COMPACT_VERTICES,
+		UNIFORM_POSITION_SCALE,
+		UNIFORM_POSITION_OFFSET,
+		UNIFORM_CLUSTERED_LIGHTS,
+		UNIFORM_SHADOWS,
+		UNIFORM_SHADOW_MAP,
+		UNIFORM_SHADOW_CUBE_MAP,
+		UNIFORM_SHADOW_MATRIX,
+		UNIFORM_SHADOW_CUBE_FAR,
+		UNIFORM_OVERDRAW,
+		UNIFORM_COUNT
+	};
+
+	// constructor
+	UniformCache();
+
+	// look up and store the locations of all the uniforms
+	void ResolveLocations(GLuint programID);
+
+	// get the shader program the locations belong to
+	GLuint GetProgramID() const { return(m_programID); }
+	// get the stored location of a uniform, -1 if not found
+	GLint GetLocation(UNIFORM_ID uniformID) const { return(m_locations[uniformID]); }
+
+	// set the values of the uniforms
+	void SetBool(UNIFORM_ID uniformID, bool value);
+	void SetInt(UNIFORM_ID uniformID, int value);
+	void SetFloat(UNIFORM_ID uniformID, float value);
+	void SetVec2(UNIFORM_ID uniformID, const glm::vec2& value);
+	void SetVec3(UNIFORM_ID uniformID, const glm::vec3& value);
+	void SetVec4(UNIFORM_ID uniformID, const glm::vec4& value);
+	void SetMat4(UNIFORM_ID uniformID, const glm::mat4& value);
+	void SetSampler(UNIFORM_ID uniformID, int textureUnit);
+
+	// forget the values sent, so each one is sent again
+	void Invalidate();
+	// get the number of updates sent to OpenGL and skipped
+	long long GetIssuedCount() const { return(m_issuedCount); }
+	long long GetElidedCount() const { return(m_elidedCount); }
+	// set the update counts back to zero
+	void ResetCounts();
+
+private:
+	// size of the largest uniform value, a mat4
+	static const int MAX_VALUE_SIZE = sizeof(glm::mat4);
+
+	// store a value unless it equals the stored one, and
+	// return true when it must be sent to OpenGL
+	bool UpdateShadow(
+		GLint location,
+		unsigned char* shadow,
+		bool& bKnown,
+		const void* value,
+		size_t size);
+
+	// shader program the locations were resolved from
+	GLuint m_programID;
+	// resolved uniform locations
+	GLint m_locations[UNIFORM_COUNT];
+	// last values sent, valid when the matching flag is set
+	unsigned char m_values[UNIFORM_COUNT][MAX_VALUE_SIZE];
+	bool m_bValueKnown[UNIFORM_COUNT];
+	// updates sent to OpenGL and skipped since the last reset
+	long long m_issuedCount;
+	long long m_elidedCount;
+};
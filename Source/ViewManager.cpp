@@ -20,8 +20,6 @@ namespace
 	// Variables for window width and height
 	const int WINDOW_WIDTH = 1000;
 	const int WINDOW_HEIGHT = 800;
-	const char* g_ViewName = "view";
-	const char* g_ProjectionName = "projection";
 
 	// camera object used for viewing and interacting with
 	// the 3D scene
@@ -39,6 +37,10 @@ namespace
 	// the following variable is false when orthographic projection
 	// is off and true when it is on
 	bool bOrthographicProjection = false;
+
+	// the following variable is true when the camera is driven
+	// by a script and must ignore the keyboard and mouse
+	bool bScriptedCamera = false;
 }
 
 /***********************************************************
@@ -47,11 +49,17 @@ namespace
  *  The constructor for the class
  ***********************************************************/
 ViewManager::ViewManager(
-	ShaderManager *pShaderManager)
+	ShaderManager *pShaderManager,
+	UniformCache* pUniformCache)
 {
 	// initialize the member variables
 	m_pShaderManager = pShaderManager;
+	m_pUniformCache = pUniformCache;
 	m_pWindow = NULL;
+	m_viewMatrix = glm::mat4(1.0f);
+	m_projectionMatrix = glm::mat4(1.0f);
+	m_cameraBuffer = new CameraBuffer();
+	m_bCameraBlock = false;
 	g_pCamera = new Camera();
 	// default camera view parameters
 	g_pCamera->Position = glm::vec3(0.0f, 5.0f, 12.0f);
@@ -69,7 +77,13 @@ ViewManager::~ViewManager()
 {
 	// free up allocated memory
 	m_pShaderManager = NULL;
+	m_pUniformCache = NULL;
 	m_pWindow = NULL;
+	if (NULL != m_cameraBuffer)
+	{
+		delete m_cameraBuffer;
+		m_cameraBuffer = NULL;
+	}
 	if (NULL != g_pCamera)
 	{
 		delete g_pCamera;
@@ -115,6 +129,62 @@ GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle)
 	return(window);
 }
 
+/***********************************************************
+ *  CreateOffscreenWindow()
+ *
+ *  This method is used to create a hidden window for
+ *  headless rendering.  The window is never shown and only
+ *  owns the OpenGL context; the frames are rendered into an
+ *  offscreen framebuffer instead of the window surface.
+ ***********************************************************/
+GLFWwindow* ViewManager::CreateOffscreenWindow(const char* windowTitle)
+{
+	GLFWwindow* window = nullptr;
+
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+	window = glfwCreateWindow(
+		WINDOW_WIDTH,
+		WINDOW_HEIGHT,
+		windowTitle,
+		NULL, NULL);
+	if (window == NULL)
+	{
+		std::cout << "Failed to create offscreen GLFW context" << std::endl;
+		glfwTerminate();
+		return NULL;
+	}
+	glfwMakeContextCurrent(window);
+
+	// enable blending for supporting tranparent rendering
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	m_pWindow = window;
+
+	return(window);
+}
+
+/***********************************************************
+ *  GetViewportWidth()
+ *
+ *  This method returns the width of the rendered viewport.
+ ***********************************************************/
+int ViewManager::GetViewportWidth() const
+{
+	return(WINDOW_WIDTH);
+}
+
+/***********************************************************
+ *  GetViewportHeight()
+ *
+ *  This method returns the height of the rendered viewport.
+ ***********************************************************/
+int ViewManager::GetViewportHeight() const
+{
+	return(WINDOW_HEIGHT);
+}
+
 /***********************************************************
  *  Mouse_Position_Callback()
  *
@@ -123,6 +193,12 @@ GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle)
  ***********************************************************/
 void ViewManager::Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos)
 {
+	// the mouse does not move a scripted camera
+	if (bScriptedCamera)
+	{
+		return;
+	}
+
 	// when the first mouse move event is received, this needs to be recorded so that
 	// all subsequent mouse moves can correctly calculate the X position offset and Y
 	// position offset for proper operation
@@ -158,6 +234,13 @@ void ViewManager::ProcessKeyboardEvents()
 	{
 		glfwSetWindowShouldClose(m_pWindow, true);
 	}
+
+	// the keyboard does not move a scripted camera
+	if (bScriptedCamera)
+	{
+		return;
+	}
+
 	// Camera speed based on frame time for smooth movement
 	float cameraSpeed = 5.0f * gDeltaTime;
 
@@ -240,14 +323,91 @@ void ViewManager::PrepareSceneView()
 		projection = glm::perspective(glm::radians(g_pCamera->Zoom), (float)WINDOW_WIDTH / (float)WINDOW_HEIGHT, 0.1f, 100.0f);
 	}
 
-	// If the shader manager object is valid
-	if (NULL != m_pShaderManager)
+	// keep the matrices for the scene culling and sorting
+	m_viewMatrix = view;
+	m_projectionMatrix = projection;
+
+	// the shaders that declare the camera block all read the
+	// values written here, with no uniform set per program
+	if (m_bCameraBlock)
+	{
+		CameraBuffer::GPU_CAMERA camera;
+		camera.view = view;
+		camera.projection = projection;
+		camera.viewProjection = projection * view;
+		camera.inverseView = glm::inverse(view);
+		camera.inverseProjection = glm::inverse(projection);
+		camera.inverseViewProjection = glm::inverse(camera.viewProjection);
+		camera.cameraPosition = g_pCamera->Position;
+		camera.time = currentFrame;
+		camera.viewportSize = glm::vec2((float)WINDOW_WIDTH, (float)WINDOW_HEIGHT);
+		camera.padding = glm::vec2(0.0f, 0.0f);
+		m_cameraBuffer->Update(camera);
+	}
+	// If the uniform cache object is valid
+	else if (NULL != m_pUniformCache)
 	{
 		// Set the view matrix into the shader for proper rendering
-		m_pShaderManager->setMat4Value(g_ViewName, view);
+		m_pUniformCache->SetMat4(UniformCache::UNIFORM_VIEW, view);
 		// Set the projection matrix into the shader for proper rendering
-		m_pShaderManager->setMat4Value(g_ProjectionName, projection);
+		m_pUniformCache->SetMat4(UniformCache::UNIFORM_PROJECTION, projection);
 		// Set the view position of the camera into the shader for proper rendering
-		m_pShaderManager->setVec3Value("viewPosition", g_pCamera->Position);
+		m_pUniformCache->SetVec3(UniformCache::UNIFORM_VIEW_POSITION, g_pCamera->Position);
 	}
-}
\ No newline at end of file
+}
+
+/***********************************************************
+ *  AttachCameraBlock()
+ *
+ *  This method is used for connecting the camera uniform
+ *  buffer to the passed in shader program.  Once a program
+ *  declares the camera block, the view values are only
+ *  written to the buffer, so it must be called for every
+ *  program that draws the scene.
+ ***********************************************************/
+bool ViewManager::AttachCameraBlock(GLuint programID)
+{
+	if (m_cameraBuffer->AttachProgram(programID) == false)
+	{
+		return false;
+	}
+
+	m_bCameraBlock = true;
+
+	return true;
+}
+
+/***********************************************************
+ *  SetScriptedCamera()
+ *
+ *  This method is used for handing the camera over to a
+ *  script, such as a benchmark camera path.  While scripted,
+ *  the keyboard and mouse no longer move the camera.
+ ***********************************************************/
+void ViewManager::SetScriptedCamera(bool bScripted)
+{
+	bScriptedCamera = bScripted;
+	bOrthographicProjection = false;
+}
+
+/***********************************************************
+ *  SetCameraPose()
+ *
+ *  This method is used for placing the camera at the passed
+ *  in position, looking along the passed in direction.  The
+ *  yaw and pitch are derived from the direction, so mouse
+ *  input afterwards turns the camera from this pose.
+ ***********************************************************/
+void ViewManager::SetCameraPose(glm::vec3 position, glm::vec3 front)
+{
+	front = glm::normalize(front);
+
+	g_pCamera->Position = position;
+	g_pCamera->Front = front;
+	g_pCamera->Yaw = glm::degrees(glm::atan(front.z, front.x));
+	g_pCamera->Pitch = glm::degrees(glm::asin(glm::clamp(front.y, -1.0f, 1.0f)));
+
+	// keep the camera axes at right angles to the new direction
+	g_pCamera->Right = glm::normalize(glm::cross(front, g_pCamera->WorldUp));
+	g_pCamera->Up = glm::normalize(glm::cross(g_pCamera->Right, front));
+}
@@ -9,7 +9,9 @@
 
 #pragma once
 
+#include "CameraBuffer.h"
 #include "ShaderManager.h"
+#include "UniformCache.h"
 #include "camera.h"
 
 // GLFW library
@@ -20,7 +22,8 @@ class ViewManager
 public:
 	// constructor
 	ViewManager(
-		ShaderManager* pShaderManager);
+		ShaderManager* pShaderManager,
+		UniformCache* pUniformCache);
 	// destructor
 	~ViewManager();
 
@@ -30,8 +33,18 @@ public:
 private:
 	// pointer to shader manager object
 	ShaderManager* m_pShaderManager;
+	// pointer to the resolved shader uniform locations
+	UniformCache* m_pUniformCache;
 	// active OpenGL display window
 	GLFWwindow* m_pWindow;
+	// view and projection matrices of the current frame
+	glm::mat4 m_viewMatrix;
+	glm::mat4 m_projectionMatrix;
+	// pointer to the uniform buffer holding the camera values
+	CameraBuffer* m_cameraBuffer;
+	// true when the shader reads the camera values from the
+	// camera uniform buffer
+	bool m_bCameraBlock;
 
 	// process keyboard events for interaction with the 3D scene
 	void ProcessKeyboardEvents();
@@ -39,7 +52,25 @@ private:
 public:
 	// create the initial OpenGL display window
 	GLFWwindow* CreateDisplayWindow(const char* windowTitle);
+	// create a hidden window that only provides the OpenGL context
+	GLFWwindow* CreateOffscreenWindow(const char* windowTitle);
+
+	// get the size of the rendered viewport
+	int GetViewportWidth() const;
+	int GetViewportHeight() const;
+
+	// get the view and projection matrices of the current frame
+	const glm::mat4& GetViewMatrix() const { return(m_viewMatrix); }
+	const glm::mat4& GetProjectionMatrix() const { return(m_projectionMatrix); }
 	
+	// connect the camera uniform buffer to a shader program,
+	// false if the program does not declare the CameraBlock
+	bool AttachCameraBlock(GLuint programID);
 	// prepare the conversion from 3D object display to 2D scene display
 	void PrepareSceneView();
+
+	// let a script drive the camera instead of the keyboard and mouse
+	void SetScriptedCamera(bool bScripted);
+	// place the camera at the passed in position and direction
+	void SetCameraPose(glm::vec3 position, glm::vec3 front);
 };
\ No newline at end of file
@@ -0,0 +1,230 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshoptimizertest.cpp
+// ============
+// check the vertex cache optimizer on the generated shapes
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ShapeGeometry.h"
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// declaration of global variables
+namespace
+{
+	// one triangle as the values of its three vertices, so
+	// triangles can be compared across a renumbering
+	struct TRIANGLE_KEY
+	{
+		ShapeGeometry::SHAPE_VERTEX corners[3];
+	};
+
+	// number of failed checks
+	int g_FailureCount = 0;
+
+	/***********************************************************
+	 *  CompareVertices()
+	 *
+	 *  This function is used for ordering two vertices by the
+	 *  bytes of their values, returning <0, 0 or >0.
+	 ***********************************************************/
+	int CompareVertices(
+		const ShapeGeometry::SHAPE_VERTEX& a,
+		const ShapeGeometry::SHAPE_VERTEX& b)
+	{
+		return(memcmp(&a, &b, sizeof(ShapeGeometry::SHAPE_VERTEX)));
+	}
+
+	/***********************************************************
+	 *  IsTriangleLess()
+	 *
+	 *  This function is used for sorting the triangle keys.
+	 ***********************************************************/
+	bool IsTriangleLess(const TRIANGLE_KEY& a, const TRIANGLE_KEY& b)
+	{
+		for (int corner = 0; corner < 3; corner++)
+		{
+			int order = CompareVertices(a.corners[corner], b.corners[corner]);
+			if (order != 0)
+			{
+				return(order < 0);
+			}
+		}
+		return(false);
+	}
+
+	/***********************************************************
+	 *  IsTriangleEqual()
+	 *
+	 *  This function is used for comparing two triangle keys.
+	 ***********************************************************/
+	bool IsTriangleEqual(const TRIANGLE_KEY& a, const TRIANGLE_KEY& b)
+	{
+		return(!IsTriangleLess(a, b) && !IsTriangleLess(b, a));
+	}
+}
+
+// function declarations
+std::vector<TRIANGLE_KEY> GetTriangleSet(const ShapeGeometry::SHAPE_GEOMETRY& geometry);
+bool IsSameGeometry(
+	const ShapeGeometry::SHAPE_GEOMETRY& a,
+	const ShapeGeometry::SHAPE_GEOMETRY& b);
+void Check(bool bPassed, const std::string& name, const char* check);
+void TestShape(const std::string& name, const ShapeGeometry::SHAPE_GEOMETRY& input);
+
+/***********************************************************
+ *  main()
+ *
+ *  This function gets called after the application has been
+ *  launched.  The optimizer is run on the generated sphere
+ *  and torus at every detail level, and the process exits
+ *  with a failure when any check does not pass.  No window
+ *  or OpenGL context is used.
+ ***********************************************************/
+int main()
+{
+	for (int detailLevel = 0; detailLevel < ShapeGeometry::DETAIL_LEVEL_COUNT; detailLevel++)
+	{
+		std::string level = std::to_string(detailLevel);
+		TestShape("sphere " + level, ShapeGeometry::CreateSphere(detailLevel));
+		TestShape("torus " + level, ShapeGeometry::CreateTorus(detailLevel));
+	}
+
+	if (g_FailureCount > 0)
+	{
+		std::cout << g_FailureCount << " check(s) failed" << std::endl;
+		return(EXIT_FAILURE);
+	}
+
+	std::cout << "All checks passed" << std::endl;
+
+	return(EXIT_SUCCESS);
+}
+
+/***********************************************************
+ *  GetTriangleSet()
+ *
+ *  This function is used for listing the triangles of a mesh
+ *  by the values of their vertices, each rotated to start at
+ *  its smallest vertex so the winding is kept, and sorted so
+ *  the order of the triangles does not matter.
+ ***********************************************************/
+std::vector<TRIANGLE_KEY> GetTriangleSet(const ShapeGeometry::SHAPE_GEOMETRY& geometry)
+{
+	std::vector<TRIANGLE_KEY> triangles;
+	triangles.reserve(geometry.indices.size() / 3);
+
+	for (size_t i = 0; i + 2 < geometry.indices.size(); i += 3)
+	{
+		int first = 0;
+		for (int corner = 1; corner < 3; corner++)
+		{
+			if (CompareVertices(
+				geometry.vertices[geometry.indices[i + corner]],
+				geometry.vertices[geometry.indices[i + first]]) < 0)
+			{
+				first = corner;
+			}
+		}
+
+		TRIANGLE_KEY triangle;
+		for (int corner = 0; corner < 3; corner++)
+		{
+			triangle.corners[corner] = geometry.vertices[geometry.indices[i + (first + corner) % 3]];
+		}
+		triangles.push_back(triangle);
+	}
+
+	std::sort(triangles.begin(), triangles.end(), IsTriangleLess);
+
+	return(triangles);
+}
+
+/***********************************************************
+ *  IsSameGeometry()
+ *
+ *  This function is used for checking that two meshes have
+ *  the same vertices and indices in the same order.
+ ***********************************************************/
+bool IsSameGeometry(
+	const ShapeGeometry::SHAPE_GEOMETRY& a,
+	const ShapeGeometry::SHAPE_GEOMETRY& b)
+{
+	if ((a.vertices.size() != b.vertices.size()) || (a.indices != b.indices))
+	{
+		return(false);
+	}
+
+	for (size_t i = 0; i < a.vertices.size(); i++)
+	{
+		if (CompareVertices(a.vertices[i], b.vertices[i]) != 0)
+		{
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  Check()
+ *
+ *  This function is used for reporting the result of one
+ *  check and counting the failures.
+ ***********************************************************/
+void Check(bool bPassed, const std::string& name, const char* check)
+{
+	if (!bPassed)
+	{
+		std::cout << "FAILED: " << name << ": " << check << std::endl;
+		g_FailureCount++;
+	}
+}
+
+/***********************************************************
+ *  TestShape()
+ *
+ *  This function is used for optimizing two copies of a
+ *  generated mesh and checking that the results are the
+ *  same, cache no worse, in range and made of the same
+ *  triangles as the input.
+ ***********************************************************/
+void TestShape(const std::string& name, const ShapeGeometry::SHAPE_GEOMETRY& input)
+{
+	ShapeGeometry::SHAPE_GEOMETRY first = input;
+	ShapeGeometry::SHAPE_GEOMETRY second = input;
+	MeshOptimizer::OPTIMIZE_REPORT report = MeshOptimizer::Optimize(first);
+	MeshOptimizer::Optimize(second);
+
+	std::cout << name
+		<< ": ACMR " << report.acmrBefore << " -> " << report.acmrAfter
+		<< ", ATVR " << report.atvrBefore << " -> " << report.atvrAfter << std::endl;
+
+	Check(IsSameGeometry(first, second), name, "two runs give different meshes");
+	Check(report.acmrAfter <= report.acmrBefore, name, "ACMR got worse");
+
+	bool bInRange = true;
+	for (size_t i = 0; i < first.indices.size(); i++)
+	{
+		if (first.indices[i] >= first.vertices.size())
+		{
+			bInRange = false;
+			break;
+		}
+	}
+	Check(bInRange, name, "an index is past the last vertex");
+
+	std::vector<TRIANGLE_KEY> inputTriangles = GetTriangleSet(input);
+	std::vector<TRIANGLE_KEY> outputTriangles = GetTriangleSet(first);
+	Check((inputTriangles.size() == outputTriangles.size()) &&
+		std::equal(inputTriangles.begin(), inputTriangles.end(), outputTriangles.begin(), IsTriangleEqual),
+		name, "the triangles changed");
+}
@@ -0,0 +1,217 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturebaker.cpp
+// ============
+// bake texture images into pre-mipmapped, optionally compressed files
+//
+//  AUTHOR: Nii Amatey Tagoe - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureLoader.h"
+#include "BakedTexture.h"
+#include "BlockCompressor.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// the application defines the stb_image functions in
+// SceneManager.cpp, the baker links without it
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+// declaration of global variables
+namespace
+{
+	// requested format of the baked files
+	enum BAKE_FORMAT
+	{
+		BAKE_AUTO = 0,
+		BAKE_RGBA8,
+		BAKE_BC1,
+		BAKE_BC3
+	};
+
+	BAKE_FORMAT g_BakeFormat = BAKE_AUTO;
+	std::vector<std::string> g_ImageFiles;
+}
+
+// function declarations
+bool ParseCommandLine(int argc, char* argv[]);
+bool BakeImage(const TextureLoader::DECODED_IMAGE& image);
+
+/***********************************************************
+ *  main(int, char*)
+ *
+ *  This function gets called after the application has been
+ *  launched.  Every image named on the command line is
+ *  decoded, mipmapped, compressed and written as a baked
+ *  file next to it.  No window or OpenGL context is used,
+ *  so the baker runs on machines without a GPU.
+ ***********************************************************/
+int main(int argc, char* argv[])
+{
+	if (ParseCommandLine(argc, argv) == false)
+	{
+		std::cout << "Usage: TextureBaker [--format auto|rgba8|bc1|bc3] <image> [<image> ...]" << std::endl;
+		std::cout << "  auto picks BC1 for opaque images and BC3 for images with alpha" << std::endl;
+		return(EXIT_FAILURE);
+	}
+
+	// the images are decoded and mipmapped on the same worker
+	// threads that the application uses
+	TextureLoader loader;
+	for (size_t i = 0; i < g_ImageFiles.size(); i++)
+	{
+		loader.Request(g_ImageFiles[i], (int)i);
+	}
+
+	int failedCount = 0;
+	for (size_t baked = 0; baked < g_ImageFiles.size(); baked++)
+	{
+		TextureLoader::DECODED_IMAGE image;
+		while (!loader.TakeDecoded(image))
+		{
+			loader.WaitForDecoded();
+		}
+
+		if (BakeImage(image) == false)
+		{
+			failedCount++;
+		}
+	}
+
+	return((failedCount == 0) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+/***********************************************************
+ *  ParseCommandLine()
+ *
+ *  This function is used for reading the format option and
+ *  the list of image files.
+ ***********************************************************/
+bool ParseCommandLine(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "--format") == 0) && (i + 1 < argc))
+		{
+			const char* format = argv[++i];
+			if (strcmp(format, "auto") == 0)
+			{
+				g_BakeFormat = BAKE_AUTO;
+			}
+			else if (strcmp(format, "rgba8") == 0)
+			{
+				g_BakeFormat = BAKE_RGBA8;
+			}
+			else if (strcmp(format, "bc1") == 0)
+			{
+				g_BakeFormat = BAKE_BC1;
+			}
+			else if (strcmp(format, "bc3") == 0)
+			{
+				g_BakeFormat = BAKE_BC3;
+			}
+			else
+			{
+				std::cout << "Unknown format:" << format << std::endl;
+				return false;
+			}
+		}
+		else if (argv[i][0] == '-')
+		{
+			std::cout << "Unknown option:" << argv[i] << std::endl;
+			return false;
+		}
+		else
+		{
+			g_ImageFiles.push_back(argv[i]);
+		}
+	}
+
+	return(!g_ImageFiles.empty());
+}
+
+/***********************************************************
+ *  BakeImage()
+ *
+ *  This function is used for converting every mipmap level
+ *  of a decoded image to the baked format and writing the
+ *  baked file.  Images whose size is not a multiple of the
+ *  4 x 4 block size are kept as RGBA8.
+ ***********************************************************/
+bool BakeImage(const TextureLoader::DECODED_IMAGE& image)
+{
+	if (!image.bValid)
+	{
+		std::cout << "Could not load image:" << image.filename << std::endl;
+		return false;
+	}
+
+	BakedTexture::BAKED_FORMAT format = BakedTexture::FORMAT_RGBA8;
+	switch (g_BakeFormat)
+	{
+	case BAKE_AUTO:
+		format = BlockCompressor::IsOpaque(image.pixels.data(), image.width, image.height) ?
+			BakedTexture::FORMAT_BC1 : BakedTexture::FORMAT_BC3;
+		break;
+	case BAKE_BC1:
+		format = BakedTexture::FORMAT_BC1;
+		break;
+	case BAKE_BC3:
+		format = BakedTexture::FORMAT_BC3;
+		break;
+	default:
+		break;
+	}
+
+	if ((format != BakedTexture::FORMAT_RGBA8) && (((image.width % 4) != 0) || ((image.height % 4) != 0)))
+	{
+		std::cout << "Size is not a multiple of 4, keeping RGBA8:" << image.filename << std::endl;
+		format = BakedTexture::FORMAT_RGBA8;
+	}
+
+	std::vector<std::vector<unsigned char> > levels(image.levelOffsets.size());
+	for (size_t level = 0; level < image.levelOffsets.size(); level++)
+	{
+		int width = TextureLoader::GetLevelSize(image.width, (int)level);
+		int height = TextureLoader::GetLevelSize(image.height, (int)level);
+		const unsigned char* pixels = image.pixels.data() + image.levelOffsets[level];
+
+		switch (format)
+		{
+		case BakedTexture::FORMAT_BC1:
+			BlockCompressor::CompressBC1(pixels, width, height, levels[level]);
+			break;
+		case BakedTexture::FORMAT_BC3:
+			BlockCompressor::CompressBC3(pixels, width, height, levels[level]);
+			break;
+		default:
+			levels[level].assign(pixels, pixels + (size_t)width * height * 4);
+			break;
+		}
+	}
+
+	std::string bakedFilename = BakedTexture::GetBakedFilename(image.filename);
+	if (!BakedTexture::Write(bakedFilename, format, image.width, image.height, levels))
+	{
+		std::cout << "Could not write baked file:" << bakedFilename << std::endl;
+		return false;
+	}
+
+	size_t bakedSize = 0;
+	for (size_t level = 0; level < levels.size(); level++)
+	{
+		bakedSize += levels[level].size();
+	}
+
+	const char* formatNames[] = { "RGBA8", "BC1", "BC3" };
+	std::cout << "Baked image:" << image.filename << ", width:" << image.width << ", height:" << image.height
+		<< ", levels:" << levels.size() << ", format:" << formatNames[format]
+		<< ", bytes:" << bakedSize << " (RGBA8 " << image.pixels.size() << ")" << std::endl;
+
+	return true;
+}